@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2017-2018 the BasicX authors
+ * All rights reserved.
+ *
+ * The project sponsor and lead author is Xu Rendong.
+ * E-mail: xrd@ustc.edu, QQ: 277195007, WeChat: ustc_xrd
+ * See the contributors file for names of other contributors.
+ *
+ * Commercial use of this code in source and binary forms is
+ * governed by a LGPL v3 license. You may get a copy from the
+ * root directory. Or else you should get a specific written 
+ * permission from the project author.
+ *
+ * Individual and educational use of this code in source and
+ * binary forms is governed by a 3-clause BSD license. You may
+ * get a copy from the root directory. Certainly welcome you
+ * to contribute code of all sorts.
+ *
+ * Be sure to retain the above copyright notices and conditions.
+ */
+
+#ifndef NET_BENCH_HISTOGRAM_H
+#define NET_BENCH_HISTOGRAM_H
+
+#include <atomic>
+#include <vector>
+#include <stdint.h>
+
+namespace netbench {
+
+	// HDR 直方图：按 2 的幂分段，每段再线性等分，记录值的相对误差不超过 1 / 2^(SUB_BITS - 1)
+	// 计数为原子变量，多个网络线程可同时记录，不加锁
+	class Histogram
+	{
+	public:
+		static const int32_t SUB_BITS = 8; // 每段 256 格，误差小于 0.8%
+		static const int32_t MAX_BITS = 40; // 纳秒时约 18 分钟，更大的值记入末格
+		static const int32_t SUB_COUNT = 1 << SUB_BITS;
+		static const int32_t HALF_COUNT = SUB_COUNT >> 1;
+		static const int32_t BUCKET_COUNT = ( MAX_BITS - SUB_BITS + 2 ) * HALF_COUNT;
+
+	public:
+		Histogram()
+			: m_counts( BUCKET_COUNT ) {
+			Reset();
+		}
+
+		void Reset() {
+			for( int32_t i = 0; i < BUCKET_COUNT; i++ ) {
+				m_counts[i] = 0;
+			}
+			m_total = 0;
+			m_sum = 0;
+			m_min = INT64_MAX;
+			m_max = 0;
+		}
+
+		void Record( int64_t value ) {
+			if( value < 0 ) { // 时钟误差
+				value = 0;
+			}
+			m_counts[GetIndex( value )].fetch_add( 1, std::memory_order_relaxed );
+			m_total.fetch_add( 1, std::memory_order_relaxed );
+			m_sum.fetch_add( value, std::memory_order_relaxed );
+			int64_t min_value = m_min.load( std::memory_order_relaxed );
+			while( value < min_value && !m_min.compare_exchange_weak( min_value, value, std::memory_order_relaxed ) ) {
+			}
+			int64_t max_value = m_max.load( std::memory_order_relaxed );
+			while( value > max_value && !m_max.compare_exchange_weak( max_value, value, std::memory_order_relaxed ) ) {
+			}
+		}
+
+		uint64_t GetTotal() const {
+			return m_total.load( std::memory_order_relaxed );
+		}
+
+		int64_t GetMin() const {
+			return 0 == GetTotal() ? 0 : m_min.load( std::memory_order_relaxed );
+		}
+
+		int64_t GetMax() const {
+			return m_max.load( std::memory_order_relaxed );
+		}
+
+		double GetMean() const {
+			uint64_t total = GetTotal();
+			return 0 == total ? 0.0 : (double)m_sum.load( std::memory_order_relaxed ) / (double)total;
+		}
+
+		int64_t GetQuantile( double quantile ) const { // 返回所在格内的最大值，不超过实际最大值，无样本时返回 0
+			uint64_t total = GetTotal();
+			if( 0 == total ) {
+				return 0;
+			}
+			uint64_t rank = (uint64_t)( quantile * (double)total + 0.5 );
+			if( rank < 1 ) {
+				rank = 1;
+			}
+			if( rank > total ) {
+				rank = total;
+			}
+			uint64_t count = 0;
+			for( int32_t i = 0; i < BUCKET_COUNT; i++ ) {
+				count += m_counts[i].load( std::memory_order_relaxed );
+				if( count >= rank ) {
+					int64_t value = GetHighest( i );
+					return value < GetMax() ? value : GetMax();
+				}
+			}
+			return GetMax();
+		}
+
+	private:
+		static int32_t GetIndex( int64_t value ) { // 小于 SUB_COUNT 时一格一值，之后每翻一倍格宽加倍
+			if( value < SUB_COUNT ) {
+				return (int32_t)value;
+			}
+			int32_t msb = 0;
+			for( uint64_t v = (uint64_t)value; v > 1; v >>= 1 ) {
+				msb++;
+			}
+			int32_t shift = msb - SUB_BITS + 1;
+			int32_t index = shift * HALF_COUNT + (int32_t)( value >> shift );
+			return index < BUCKET_COUNT ? index : BUCKET_COUNT - 1;
+		}
+
+		static int64_t GetHighest( int32_t index ) {
+			if( index < SUB_COUNT ) {
+				return index;
+			}
+			int32_t shift = index / HALF_COUNT - 1;
+			int64_t sub = index - shift * HALF_COUNT;
+			return ( ( sub + 1 ) << shift ) - 1;
+		}
+
+	private:
+		std::vector<std::atomic<uint64_t>> m_counts;
+		std::atomic<uint64_t> m_total;
+		std::atomic<int64_t> m_sum;
+		std::atomic<int64_t> m_min;
+		std::atomic<int64_t> m_max;
+	};
+
+} // namespace netbench
+
+#endif // NET_BENCH_HISTOGRAM_H
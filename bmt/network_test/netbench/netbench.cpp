@@ -0,0 +1,348 @@
+/*
+ * Copyright (c) 2017-2018 the BasicX authors
+ * All rights reserved.
+ *
+ * The project sponsor and lead author is Xu Rendong.
+ * E-mail: xrd@ustc.edu, QQ: 277195007, WeChat: ustc_xrd
+ * See the contributors file for names of other contributors.
+ *
+ * Commercial use of this code in source and binary forms is
+ * governed by a LGPL v3 license. You may get a copy from the
+ * root directory. Or else you should get a specific written 
+ * permission from the project author.
+ *
+ * Individual and educational use of this code in source and
+ * binary forms is governed by a 3-clause BSD license. You may
+ * get a copy from the root directory. Certainly welcome you
+ * to contribute code of all sorts.
+ *
+ * Be sure to retain the above copyright notices and conditions.
+ */
+
+// 环回压测 NetServer 与 NetClient：服务端原样回发，客户端按往返时间记入 HDR 直方图
+// 用法：netbench connections=8 size=64 rate=0 window=1 duration=10 warmup=2 io_threads=1 shards=0 port=20180 binary=1
+// rate 为每个连接每秒发送数，0 时为闭环模式，每个连接保持 window 条在途，收到回发即补发
+// rate 大于 0 时为开环模式，按计划时间均匀发送并以计划时间计时，发送落后时不会漏计排队延迟(coordinated omission)
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+#include <common/define.h>
+#include <syslog/syslog.h>
+#include <network/client.h>
+#include <network/server.h>
+
+#include "histogram.h"
+
+namespace netbench {
+
+	#define PAYLOAD_HEAD_BYTES 12 // 计划发送时间(纳秒) 8 字节 + 连接序号 4 字节
+
+	struct BenchCfg
+	{
+		int32_t m_connections;
+		int32_t m_size; // 包体字节数，不小于 PAYLOAD_HEAD_BYTES
+		int32_t m_rate;
+		int32_t m_window;
+		int32_t m_duration; // 秒，含预热
+		int32_t m_warmup; // 秒，期间的结果不计入
+		int32_t m_io_threads;
+		int32_t m_shards;
+		int32_t m_port;
+		bool m_binary;
+
+		BenchCfg()
+			: m_connections( 1 )
+			, m_size( 64 )
+			, m_rate( 0 )
+			, m_window( 1 )
+			, m_duration( 10 )
+			, m_warmup( 2 )
+			, m_io_threads( 1 )
+			, m_shards( 0 )
+			, m_port( 20180 )
+			, m_binary( true ) {
+		}
+	};
+
+	inline int64_t GetNowNs() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+	}
+
+	class NetBench : public basicx::NetClient_X, public basicx::NetServer_X
+	{
+	public:
+		NetBench( BenchCfg& bench_cfg )
+			: m_bench_cfg( bench_cfg )
+			, m_running( false )
+			, m_measure_begin( INT64_MAX )
+			, m_measure_end( INT64_MAX )
+			, m_send_count( 0 )
+			, m_send_fail( 0 )
+			, m_recv_count( 0 )
+			, m_recv_bytes( 0 ) {
+			m_client.ComponentInstance( this );
+			m_server.ComponentInstance( this );
+		}
+
+	public:
+		void OnNetClientInfo( basicx::NetClientInfo& net_client_info ) {
+			if( WM_MY_NEWCONNECT_REMOTE == net_client_info.m_info_type ) {
+				std::lock_guard<std::mutex> lock( m_connect_lock );
+				m_vec_connect.push_back( m_client.Client_GetConnect( net_client_info.m_identity ) );
+			}
+		}
+
+		void OnNetClientData( basicx::NetClientData& net_client_data ) {
+		}
+
+		void OnNetClientView( basicx::NetClientView& net_client_view ) {
+			if( net_client_view.m_size < PAYLOAD_HEAD_BYTES ) {
+				return;
+			}
+			int64_t now_time = GetNowNs();
+			int64_t send_time = 0;
+			uint32_t connect_index = 0;
+			memcpy( &send_time, net_client_view.m_data, sizeof( send_time ) );
+			memcpy( &connect_index, net_client_view.m_data + sizeof( send_time ), sizeof( connect_index ) );
+			if( send_time >= m_measure_begin && send_time < m_measure_end ) { // 按发送时间归属，预热期间发出的不计入
+				m_histogram.Record( now_time - send_time );
+				m_recv_count.fetch_add( 1, std::memory_order_relaxed );
+				m_recv_bytes.fetch_add( net_client_view.m_size, std::memory_order_relaxed );
+			}
+			if( 0 == m_bench_cfg.m_rate && true == m_running && connect_index < m_vec_connect.size() ) { // 闭环，收到即补发
+				SendOne( connect_index, now_time );
+			}
+		}
+
+		void OnNetServerInfo( basicx::NetServerInfo& net_server_info ) {
+		}
+
+		void OnNetServerData( basicx::NetServerData& net_server_data ) {
+		}
+
+		void OnNetServerView( basicx::NetServerView& net_server_view ) { // 原样回发
+			thread_local std::string echo_data;
+			echo_data.assign( net_server_view.m_data, net_server_view.m_size );
+			m_server.Server_SendData( net_server_view.m_identity, NW_MSG_TYPE_USER_DATA, net_server_view.m_code, echo_data );
+		}
+
+	public:
+		bool Start() {
+			basicx::NetServerCfg net_server_cfg;
+			net_server_cfg.m_log_test = 0;
+			net_server_cfg.m_heart_check_time = 10;
+			net_server_cfg.m_max_msg_cache_number = 0; // 不限，避免压测中途丢弃
+			net_server_cfg.m_io_work_thread_number = m_bench_cfg.m_io_threads;
+			net_server_cfg.m_client_connect_timeout = 2000;
+			net_server_cfg.m_max_connect_total_s = m_bench_cfg.m_connections + 16;
+			net_server_cfg.m_max_data_length_s = m_bench_cfg.m_size + 1024;
+			m_server.Server_SetShardNumber( m_bench_cfg.m_shards );
+			m_server.Server_SetBinaryHead( m_bench_cfg.m_binary );
+			m_server.StartNetwork( net_server_cfg );
+			if( false == m_server.Server_AddListen( "127.0.0.1", m_bench_cfg.m_port, "bench" ) ) {
+				std::cout << "服务端 监听 失败：" << m_bench_cfg.m_port << "\n";
+				return false;
+			}
+
+			basicx::NetClientCfg net_client_cfg;
+			net_client_cfg.m_log_test = 0;
+			net_client_cfg.m_heart_check_time = 10;
+			net_client_cfg.m_max_msg_cache_number = 0;
+			net_client_cfg.m_io_work_thread_number = m_bench_cfg.m_io_threads;
+			net_client_cfg.m_client_connect_timeout = 2000;
+			net_client_cfg.m_max_connect_total_c = m_bench_cfg.m_connections + 16;
+			net_client_cfg.m_max_data_length_c = m_bench_cfg.m_size + 1024;
+			m_client.Client_SetBinaryHead( m_bench_cfg.m_binary );
+			m_client.StartNetwork( net_client_cfg );
+			for( int32_t i = 0; i < m_bench_cfg.m_connections; i++ ) {
+				m_client.Client_AddConnect( "127.0.0.1", m_bench_cfg.m_port, "bench" );
+			}
+
+			for( int32_t i = 0; i < 100 && GetConnectCount() < (size_t)m_bench_cfg.m_connections; i++ ) {
+				std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+			}
+			if( GetConnectCount() < (size_t)m_bench_cfg.m_connections ) {
+				std::cout << "客户端 连接 超时：" << GetConnectCount() << " / " << m_bench_cfg.m_connections << "\n";
+				return false;
+			}
+			std::this_thread::sleep_for( std::chrono::milliseconds( 500 ) ); // 等待二进制包头协商完成
+			return true;
+		}
+
+		void Run() {
+			m_payload.assign( m_bench_cfg.m_size, 'x' );
+			int64_t begin_time = GetNowNs();
+			m_measure_begin = begin_time + (int64_t)m_bench_cfg.m_warmup * 1000000000;
+			m_measure_end = begin_time + (int64_t)m_bench_cfg.m_duration * 1000000000;
+			m_running = true;
+
+			if( 0 == m_bench_cfg.m_rate ) {
+				for( int32_t i = 0; i < m_bench_cfg.m_window; i++ ) {
+					for( size_t j = 0; j < m_vec_connect.size(); j++ ) {
+						SendOne( (uint32_t)j, GetNowNs() );
+					}
+				}
+				std::this_thread::sleep_for( std::chrono::nanoseconds( m_measure_end - begin_time ) );
+			}
+			else { // 所有连接合计的发送间隔，轮流发给各连接
+				int64_t interval = 1000000000 / ( (int64_t)m_bench_cfg.m_rate * m_vec_connect.size() );
+				if( interval < 1 ) {
+					interval = 1;
+				}
+				int64_t next_time = begin_time;
+				uint32_t connect_index = 0;
+				while( next_time < m_measure_end ) {
+					int64_t now_time = GetNowNs();
+					if( now_time < next_time ) {
+						if( next_time - now_time > 200000 ) {
+							std::this_thread::sleep_for( std::chrono::microseconds( 100 ) );
+						}
+						continue;
+					}
+					SendOne( connect_index, next_time ); // 以计划时间计时，落后时连续补发
+					connect_index = ( connect_index + 1 ) % (uint32_t)m_vec_connect.size();
+					next_time += interval;
+				}
+			}
+
+			m_running = false;
+			std::this_thread::sleep_for( std::chrono::seconds( 1 ) ); // 等待在途回发
+		}
+
+		void Report() {
+			double seconds = (double)( m_bench_cfg.m_duration - m_bench_cfg.m_warmup );
+			if( seconds <= 0.0 ) {
+				seconds = 1.0;
+			}
+			uint64_t recv_count = m_recv_count.load();
+			basicx::NetMetrics server_metrics = m_server.Server_GetMetrics( false );
+			basicx::NetMetrics client_metrics = m_client.Client_GetMetrics( false );
+
+			std::cout << std::fixed << std::setprecision( 1 );
+			std::cout << "connections: " << m_bench_cfg.m_connections << "  size: " << m_bench_cfg.m_size << "  rate: " << m_bench_cfg.m_rate << "  window: " << m_bench_cfg.m_window;
+			std::cout << "  io_threads: " << m_bench_cfg.m_io_threads << "  shards: " << m_bench_cfg.m_shards << "  binary: " << m_bench_cfg.m_binary << "\n";
+			std::cout << "duration: " << m_bench_cfg.m_duration << " s  warmup: " << m_bench_cfg.m_warmup << " s\n";
+			std::cout << "sent: " << m_send_count.load() << "  send_fail: " << m_send_fail.load() << "  measured: " << recv_count;
+			std::cout << "  drop(c/s): " << client_metrics.m_drop_msgs << "/" << server_metrics.m_drop_msgs << "\n";
+			std::cout << "throughput: " << (double)recv_count / seconds << " msg/s  " << (double)m_recv_bytes.load() / seconds / 1048576.0 << " MB/s\n";
+			std::cout << "rtt(us): min " << m_histogram.GetMin() / 1000.0;
+			std::cout << "  p50 " << m_histogram.GetQuantile( 0.5 ) / 1000.0;
+			std::cout << "  p90 " << m_histogram.GetQuantile( 0.9 ) / 1000.0;
+			std::cout << "  p99 " << m_histogram.GetQuantile( 0.99 ) / 1000.0;
+			std::cout << "  p99.9 " << m_histogram.GetQuantile( 0.999 ) / 1000.0;
+			std::cout << "  max " << m_histogram.GetMax() / 1000.0;
+			std::cout << "  mean " << m_histogram.GetMean() / 1000.0 << "\n";
+		}
+
+	private:
+		size_t GetConnectCount() {
+			std::lock_guard<std::mutex> lock( m_connect_lock );
+			return m_vec_connect.size();
+		}
+
+		void SendOne( uint32_t connect_index, int64_t send_time ) { // 各线程共用，每线程一份发送缓存
+			thread_local std::string send_data;
+			send_data = m_payload;
+			memcpy( &send_data[0], &send_time, sizeof( send_time ) );
+			memcpy( &send_data[sizeof( send_time )], &connect_index, sizeof( connect_index ) );
+			if( 0 == m_client.Client_SendData( m_vec_connect[connect_index], NW_MSG_TYPE_USER_DATA, NW_MSG_CODE_STRING, send_data ) ) {
+				m_send_count.fetch_add( 1, std::memory_order_relaxed );
+			}
+			else {
+				m_send_fail.fetch_add( 1, std::memory_order_relaxed );
+			}
+		}
+
+	private:
+		BenchCfg m_bench_cfg;
+		basicx::NetClient m_client;
+		basicx::NetServer m_server;
+		std::mutex m_connect_lock;
+		std::vector<basicx::ConnectInfo*> m_vec_connect; // 开始压测前建立完毕，之后只读
+		std::string m_payload;
+		std::atomic<bool> m_running;
+		std::atomic<int64_t> m_measure_begin;
+		std::atomic<int64_t> m_measure_end;
+		std::atomic<uint64_t> m_send_count;
+		std::atomic<uint64_t> m_send_fail;
+		std::atomic<uint64_t> m_recv_count;
+		std::atomic<uint64_t> m_recv_bytes;
+		Histogram m_histogram;
+	};
+
+	void ParseArgs( int argc, char* argv[], BenchCfg& bench_cfg ) { // key=value，未知参数忽略
+		std::map<std::string, int32_t*> map_args;
+		map_args["connections"] = &bench_cfg.m_connections;
+		map_args["size"] = &bench_cfg.m_size;
+		map_args["rate"] = &bench_cfg.m_rate;
+		map_args["window"] = &bench_cfg.m_window;
+		map_args["duration"] = &bench_cfg.m_duration;
+		map_args["warmup"] = &bench_cfg.m_warmup;
+		map_args["io_threads"] = &bench_cfg.m_io_threads;
+		map_args["shards"] = &bench_cfg.m_shards;
+		map_args["port"] = &bench_cfg.m_port;
+		for( int32_t i = 1; i < argc; i++ ) {
+			std::string arg = argv[i];
+			size_t pos = arg.find( '=' );
+			if( std::string::npos == pos ) {
+				continue;
+			}
+			std::string key = arg.substr( 0, pos );
+			int32_t value = atoi( arg.substr( pos + 1 ).c_str() );
+			if( "binary" == key ) {
+				bench_cfg.m_binary = value != 0;
+			}
+			auto it_arg = map_args.find( key );
+			if( it_arg != map_args.end() ) {
+				*( it_arg->second ) = value;
+			}
+		}
+		if( bench_cfg.m_connections < 1 ) {
+			bench_cfg.m_connections = 1;
+		}
+		if( bench_cfg.m_size < PAYLOAD_HEAD_BYTES ) {
+			bench_cfg.m_size = PAYLOAD_HEAD_BYTES;
+		}
+		if( bench_cfg.m_window < 1 ) {
+			bench_cfg.m_window = 1;
+		}
+		if( bench_cfg.m_io_threads < 1 ) {
+			bench_cfg.m_io_threads = 1;
+		}
+		if( bench_cfg.m_warmup >= bench_cfg.m_duration ) {
+			bench_cfg.m_warmup = 0;
+		}
+	}
+
+} // namespace netbench
+
+int main( int argc, char* argv[] ) {
+	netbench::BenchCfg bench_cfg;
+	netbench::ParseArgs( argc, argv, bench_cfg );
+
+	basicx::SysLog_S g_syslog_s( "NetBench" );
+	basicx::SysLog_S* syslog_s = basicx::SysLog_S::GetInstance();
+	syslog_s->SetThreadSafe( true );
+	syslog_s->SetLocalCache( true );
+	syslog_s->SetWorkThreads( 1 );
+	syslog_s->InitSysLog( "NetBench", "0.1.0", DEF_APP_COMPANY, DEF_APP_COPYRIGHT );
+
+	netbench::NetBench net_bench( bench_cfg );
+	if( false == net_bench.Start() ) {
+		return -1;
+	}
+	net_bench.Run();
+	net_bench.Report();
+
+	return 0;
+}
@@ -76,6 +76,7 @@ int main( int argc, char* argv[] ) {
 	//basicx::Test_SysDBI_S();
 
 	//basicx::Test_Network();
+	//basicx::Test_Multicast();
 
 	//basicx::Plugins g_plugins;
 	//basicx::Plugins* plugins = basicx::Plugins::GetInstance();
@@ -39,10 +39,13 @@ namespace basicx {
 #define WM_MY_DISCONNECT_REMOTE           0x0400 + 43 // 网络通信模块收到服务端断开连接
 #define WM_MY_CLOSECONNECT_SERVER         0x0400 + 44 // 网络通信模块服务端主动关闭连接
 #define WM_MY_CLOSECONNECT_CLIENT         0x0400 + 45 // 网络通信模块客户端主动关闭连接
+#define WM_MY_MULTICAST_GAP               0x0400 + 46 // 网络通信模块组播接收检测到序号跳跃
 
 // 网络数据包类型定义
 #define NW_MSG_ATOM_TYPE_MIN 0 // 网络通信 元操作 类型起始
 #define NW_MSG_TYPE_HEART_CHECK           NW_MSG_ATOM_TYPE_MIN + 0 // 连接心跳检测消息
+#define NW_MSG_TYPE_REQUEST               NW_MSG_ATOM_TYPE_MIN + 1 // 带请求标记的用户数据，对端需应答，旧版对端不识别
+#define NW_MSG_TYPE_ANSWER                NW_MSG_ATOM_TYPE_MIN + 2 // 带请求标记的应答数据
 #define NW_MSG_ATOM_TYPE_MAX 7 // 网络通信 元操作 类型终止
 
 #define NW_MSG_USER_TYPE_MIN 8 // 网络通信 自定义 类型起始
@@ -60,6 +63,19 @@ namespace basicx {
 #define NW_MSG_CODE_MSGPACK               NW_MSG_CODE_TYPE_MIN + 6 // MsgPack格式
 #define NW_MSG_CODE_TYPE_MAX 15 // 网络通信 编码 类型终止
 
+// 元操作专用编码，仅与 NW_MSG_TYPE_HEART_CHECK 搭配
+#define NW_MSG_CODE_HEAD_BINARY           NW_MSG_CODE_TYPE_MAX // 请求或确认改用二进制包头
+
+// 网络数据包压缩方式，仅对协商为二进制包头的连接生效，编码为 NW_MSG_CODE_ZLIB 的数据视为已压缩
+#define NW_COMPRESS_NONE                  0 // 不压缩
+#define NW_COMPRESS_LZ                    1 // 内置快速压缩，LZ4 块格式
+#define NW_COMPRESS_ZLIB                  2 // zlib，需以 CMAKE_NETWORK_ZLIB 编译，否则按 NW_COMPRESS_LZ 处理
+
+// 单个连接发送队列满时的处理方式，慢速对端只影响自身，不拖累同一发送线程上的其他连接
+#define NW_QUEUE_DROP_NEWEST              0 // 丢弃新消息
+#define NW_QUEUE_DROP_OLDEST              1 // 丢弃最早的待发消息，适合只关心最新状态的推送
+#define NW_QUEUE_DISCONNECT               2 // 断开连接，由对端重连后重新同步
+
 } // namespace basicx
 
 #endif // BASICX_COMMON_DEFINE_H
@@ -28,8 +28,10 @@ namespace basicx {
 
 	AsioClient_P::AsioClient_P()
 		: m_network_running( false )
+		, m_thread_number( 1 )
 		, m_log_cate( "<ASIO_CLIENT>" ) {
 		m_syslog = SysLog_S::GetInstance();
+		m_service = std::make_shared<boost::asio::io_service>(); // ǰڣδʱ첽ӿڴҲͶݣص
 	}
 
 	AsioClient_P::~AsioClient_P() {
@@ -59,12 +61,18 @@ namespace basicx {
 
 		try {
 			try {
-				m_service = std::make_shared<boost::asio::io_service>();
+				m_service->reset(); // ֹͣٴ
 				boost::asio::io_service::work work( *m_service );
 
-				ThreadPtr thread_ptr( new std::thread( boost::bind( &boost::asio::io_service::run, m_service ) ) );
+				std::vector<ThreadPtr> vec_thread;
+				for( int32_t i = 0; i < m_thread_number; i++ ) {
+					ThreadPtr thread_ptr( new std::thread( boost::bind( &boost::asio::io_service::run, m_service ) ) );
+					vec_thread.push_back( thread_ptr );
+				}
 				m_network_running = true;
-				thread_ptr->join();
+				for( size_t i = 0; i < vec_thread.size(); i++ ) {
+					vec_thread[i]->join();
+				}
 			}
 			catch( std::exception& ex ) {
 				FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ ͨŷ ʼ 쳣{0}", ex.what() );
@@ -85,9 +93,10 @@ namespace basicx {
 		LogPrint( syslog_level::c_warn, m_log_cate, log_info );
 	}
 
-	void AsioClient_P::StartNetwork() {
+	void AsioClient_P::StartNetwork( int32_t thread_number ) {
 		std::string log_info;
 
+		m_thread_number = thread_number > 0 ? thread_number : 1;
 		m_thread_asio_client = std::thread( &AsioClient_P::Thread_AsioClient, this );
 		log_info = "ͻ  ͨŷ ̡߳";
 		LogPrint( syslog_level::c_info, m_log_cate, log_info );
@@ -125,6 +134,7 @@ namespace basicx {
 
 			connect_info = new ConnectAsio; // ӽϢܻҲӣΪﻹû
 			connect_info->m_socket = std::make_shared<boost::asio::ip::tcp::socket>( *m_service );
+			connect_info->m_strand = std::make_shared<boost::asio::io_service::strand>( *m_service );
 			connect_info->m_available = false;
 			connect_info->m_node_type = node_type;
 
@@ -165,26 +175,7 @@ namespace basicx {
 		std::string log_info;
 
 		if( !error ) {
-			connect_info->m_socket->set_option( boost::asio::ip::tcp::no_delay( m_tcp_socket_option.m_no_delay ) );
-			connect_info->m_socket->set_option( boost::asio::socket_base::keep_alive( m_tcp_socket_option.m_keep_alive ) );
-			connect_info->m_socket->set_option( boost::asio::socket_base::enable_connection_aborted( m_tcp_socket_option.m_enable_connection_aborted ) );
-			connect_info->m_socket->set_option( boost::asio::socket_base::receive_buffer_size( m_tcp_socket_option.m_recv_buffer_size ) );
-			connect_info->m_socket->set_option( boost::asio::socket_base::send_buffer_size( m_tcp_socket_option.m_send_buffer_size ) );
-
-			connect_info->m_available = true;
-			connect_info->m_active_close = false;
-
-			connect_info->m_protocol_r = "tcp";
-			connect_info->m_adress_r = connect_info->m_socket->remote_endpoint().address().to_string().c_str();
-			connect_info->m_port_r = connect_info->m_socket->remote_endpoint().port();
-			FormatLibrary::StandardLibrary::FormatTo( connect_info->m_str_port_r, "{0}", connect_info->m_port_r );
-			connect_info->m_endpoint_r = connect_info->m_protocol_r + "://" + connect_info->m_adress_r + ":" + connect_info->m_str_port_r; // ӱ"tcp://192.16.1.23:333"
-
-			connect_info->m_protocol_l = "tcp";
-			connect_info->m_adress_l = connect_info->m_socket->local_endpoint().address().to_string().c_str();
-			connect_info->m_port_l = connect_info->m_socket->local_endpoint().port();
-			FormatLibrary::StandardLibrary::FormatTo( connect_info->m_str_port_l, "{0}", connect_info->m_port_l );
-			connect_info->m_endpoint_l = connect_info->m_protocol_l + "://" + connect_info->m_adress_l + ":" + connect_info->m_str_port_l; // ӱ"tcp://192.16.1.38:465"
+			Client_InitConnect( connect_info );
 
 			connect_info->m_condition.notify_one(); //
 
@@ -198,6 +189,29 @@ namespace basicx {
 		}
 	}
 
+	void AsioClient_P::Client_InitConnect( ConnectAsio* connect_info ) {
+		connect_info->m_socket->set_option( boost::asio::ip::tcp::no_delay( m_tcp_socket_option.m_no_delay ) );
+		connect_info->m_socket->set_option( boost::asio::socket_base::keep_alive( m_tcp_socket_option.m_keep_alive ) );
+		connect_info->m_socket->set_option( boost::asio::socket_base::enable_connection_aborted( m_tcp_socket_option.m_enable_connection_aborted ) );
+		connect_info->m_socket->set_option( boost::asio::socket_base::receive_buffer_size( m_tcp_socket_option.m_recv_buffer_size ) );
+		connect_info->m_socket->set_option( boost::asio::socket_base::send_buffer_size( m_tcp_socket_option.m_send_buffer_size ) );
+
+		connect_info->m_available = true;
+		connect_info->m_active_close = false;
+
+		connect_info->m_protocol_r = "tcp";
+		connect_info->m_adress_r = connect_info->m_socket->remote_endpoint().address().to_string().c_str();
+		connect_info->m_port_r = connect_info->m_socket->remote_endpoint().port();
+		FormatLibrary::StandardLibrary::FormatTo( connect_info->m_str_port_r, "{0}", connect_info->m_port_r );
+		connect_info->m_endpoint_r = connect_info->m_protocol_r + "://" + connect_info->m_adress_r + ":" + connect_info->m_str_port_r; // ӱ"tcp://192.16.1.23:333"
+
+		connect_info->m_protocol_l = "tcp";
+		connect_info->m_adress_l = connect_info->m_socket->local_endpoint().address().to_string().c_str();
+		connect_info->m_port_l = connect_info->m_socket->local_endpoint().port();
+		FormatLibrary::StandardLibrary::FormatTo( connect_info->m_str_port_l, "{0}", connect_info->m_port_l );
+		connect_info->m_endpoint_l = connect_info->m_protocol_l + "://" + connect_info->m_adress_l + ":" + connect_info->m_str_port_l; // ӱ"tcp://192.16.1.38:465"
+	}
+
 	int32_t AsioClient_P::Client_ReadData_Sy( ConnectAsio* connect_info, char* data, int32_t size ) {
 		if( connect_info != nullptr && connect_info->m_available != false ) {
 			try {
@@ -232,6 +246,178 @@ namespace basicx {
 		return 0;
 	}
 
+	AsioOperationPtr AsioClient_P::Client_MakeOperation( ConnectAsio* connect_info, int32_t time_out_ms ) {
+		AsioOperationPtr operation = std::make_shared<AsioOperation>();
+		operation->m_connect_info = connect_info;
+		operation->m_timed_out = false;
+		operation->m_completed = false;
+		if( time_out_ms > 0 ) {
+			operation->m_deadline_timer = std::make_shared<boost::asio::steady_timer>( *m_service );
+			operation->m_deadline_timer->expires_from_now( std::chrono::milliseconds( time_out_ms ) );
+			operation->m_deadline_timer->async_wait( connect_info->m_strand->wrap( boost::bind( &AsioClient_P::Client_HandleDeadline, this, boost::asio::placeholders::error, operation ) ) );
+		}
+		return operation;
+	}
+
+	void AsioClient_P::Client_HandleDeadline( const boost::system::error_code& error, AsioOperationPtr operation ) {
+		if( error || true == operation->m_completed ) { // ɣʱȡڻصδִ
+			return;
+		}
+
+		// ȡδɵĽӻдص operation_aborted 
+		operation->m_timed_out = true;
+		boost::system::error_code ec;
+		if( operation->m_resolver.get() ) {
+			operation->m_resolver->cancel();
+		}
+		if( operation->m_connect_info->m_socket.get() ) {
+			operation->m_connect_info->m_socket->cancel( ec );
+		}
+	}
+
+	void AsioClient_P::Client_AddConnect_As( std::string address, int32_t port, std::string node_type, int32_t time_out_ms, AsioConnectHandler handler ) {
+		std::string log_info;
+
+		if( !IsNetworkStarted() ) {
+			log_info = "ͻ ͨŷδ";
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+			m_service->post( boost::bind( handler, nullptr, ASIO_RESULT_ERROR ) ); // дӿһ£ڵջϻص
+			return;
+		}
+
+		ConnectAsio* connect_info = new ConnectAsio;
+		connect_info->m_socket = std::make_shared<boost::asio::ip::tcp::socket>( *m_service );
+		connect_info->m_strand = std::make_shared<boost::asio::io_service::strand>( *m_service );
+		connect_info->m_available = false;
+		connect_info->m_node_type = node_type;
+
+		std::string port_temp;
+		FormatLibrary::StandardLibrary::FormatTo( port_temp, "{0}", port );
+		boost::asio::ip::tcp::resolver::query query( address, port_temp );
+
+		// ӹһʱ
+		AsioOperationPtr operation = Client_MakeOperation( connect_info, time_out_ms );
+		operation->m_resolver = std::make_shared<boost::asio::ip::tcp::resolver>( *m_service );
+		operation->m_connect_handler = handler;
+		operation->m_resolver->async_resolve( query, connect_info->m_strand->wrap( boost::bind( &AsioClient_P::Client_HandleResolve_As, this, boost::asio::placeholders::error, boost::asio::placeholders::iterator, operation ) ) );
+	}
+
+	void AsioClient_P::Client_HandleResolve_As( const boost::system::error_code& error, boost::asio::ip::tcp::resolver::iterator endpoint_iterator, AsioOperationPtr operation ) {
+		if( error ) {
+			Client_HandleConnect_As( error, operation );
+			return;
+		}
+
+		boost::asio::async_connect( *(operation->m_connect_info->m_socket), endpoint_iterator, operation->m_connect_info->m_strand->wrap( boost::bind( &AsioClient_P::Client_HandleConnect_As, this, boost::asio::placeholders::error, operation ) ) );
+	}
+
+	void AsioClient_P::Client_HandleConnect_As( const boost::system::error_code& error, AsioOperationPtr operation ) {
+		std::string log_info;
+
+		ConnectAsio* connect_info = operation->m_connect_info;
+		operation->m_completed = true;
+		if( operation->m_deadline_timer.get() ) {
+			boost::system::error_code ec;
+			operation->m_deadline_timer->cancel( ec );
+		}
+
+		if( !error ) {
+			try {
+				Client_InitConnect( connect_info );
+
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ ӣ[{0}]->[{1}]{2}", connect_info->m_endpoint_l, connect_info->m_endpoint_r, connect_info->m_node_type );
+				LogPrint( syslog_level::c_info, m_log_cate, log_info );
+
+				operation->m_connect_handler( connect_info, 0 );
+				return;
+			}
+			catch( std::exception& ex ) { // ӽԶϿ
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  ʼ 쳣{0}", ex.what() );
+				LogPrint( syslog_level::c_error, m_log_cate, log_info );
+			}
+		}
+		else if( true == operation->m_timed_out ) {
+			log_info = "ͻ   ʱ";
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+		}
+		else {
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ   {0}", error.message().c_str() );
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+		}
+
+		// Ӿѽʱصѱɲٷӣֱɾ
+		boost::system::error_code ec;
+		connect_info->m_socket->close( ec );
+		delete connect_info;
+		operation->m_connect_info = nullptr;
+
+		operation->m_connect_handler( nullptr, true == operation->m_timed_out ? ASIO_RESULT_TIMEOUT : ASIO_RESULT_ERROR );
+	}
+
+	void AsioClient_P::Client_ReadData_As( ConnectAsio* connect_info, char* data, int32_t size, int32_t time_out_ms, AsioHandler handler ) {
+		if( nullptr == connect_info || false == connect_info->m_available ) {
+			m_service->post( boost::bind( handler, ASIO_RESULT_ERROR ) );
+			return;
+		}
+
+		// 𷽿ܲڸӵ strand Уת strand ٲ socket
+		AsioOperationPtr operation = Client_MakeOperation( connect_info, time_out_ms );
+		operation->m_handler = handler;
+		connect_info->m_strand->dispatch( boost::bind( &AsioClient_P::Client_StartRead_As, this, operation, data, size ) );
+	}
+
+	void AsioClient_P::Client_SendData_As( ConnectAsio* connect_info, const char* data, int32_t size, int32_t time_out_ms, AsioHandler handler ) {
+		if( nullptr == connect_info || false == connect_info->m_available ) {
+			m_service->post( boost::bind( handler, ASIO_RESULT_ERROR ) );
+			return;
+		}
+
+		AsioOperationPtr operation = Client_MakeOperation( connect_info, time_out_ms );
+		operation->m_handler = handler;
+		connect_info->m_strand->dispatch( boost::bind( &AsioClient_P::Client_StartSend_As, this, operation, data, size ) );
+	}
+
+	void AsioClient_P::Client_StartRead_As( AsioOperationPtr operation, char* data, int32_t size ) {
+		ConnectAsio* connect_info = operation->m_connect_info;
+		boost::asio::async_read( *(connect_info->m_socket), boost::asio::buffer( data, size ), connect_info->m_strand->wrap( boost::bind( &AsioClient_P::Client_HandleData_As, this, boost::asio::placeholders::error, boost::asio::placeholders::bytes_transferred, operation ) ) );
+	}
+
+	void AsioClient_P::Client_StartSend_As( AsioOperationPtr operation, const char* data, int32_t size ) {
+		ConnectAsio* connect_info = operation->m_connect_info;
+		boost::asio::async_write( *(connect_info->m_socket), boost::asio::buffer( data, size ), connect_info->m_strand->wrap( boost::bind( &AsioClient_P::Client_HandleData_As, this, boost::asio::placeholders::error, boost::asio::placeholders::bytes_transferred, operation ) ) );
+	}
+
+	void AsioClient_P::Client_HandleData_As( const boost::system::error_code& error, size_t size, AsioOperationPtr operation ) {
+		std::string log_info;
+
+		ConnectAsio* connect_info = operation->m_connect_info;
+		operation->m_completed = true;
+		if( operation->m_deadline_timer.get() ) {
+			boost::system::error_code ec;
+			operation->m_deadline_timer->cancel( ec );
+		}
+
+		if( !error ) {
+			operation->m_handler( (int32_t)size );
+			return;
+		}
+
+		// ʱλòȷر
+		if( true == operation->m_timed_out ) {
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ 첽 д ʱ[{0}]->[{1}]", connect_info->m_endpoint_l, connect_info->m_endpoint_r );
+		}
+		else {
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ 첽 д {0}", error.message().c_str() );
+		}
+		LogPrint( syslog_level::c_error, m_log_cate, log_info );
+
+		if( true == connect_info->m_available ) { // ͬһӿждͬʱʧ
+			Client_CloseOnError( connect_info );
+		}
+
+		operation->m_handler( true == operation->m_timed_out ? ASIO_RESULT_TIMEOUT : ASIO_RESULT_ERROR );
+	}
+
 	void AsioClient_P::Client_CloseByUser( ConnectAsio* connect_info ) {
 		if( connect_info ) {
 			connect_info->m_active_close = true;
@@ -284,8 +470,8 @@ namespace basicx {
 		}
 	}
 
-	void AsioClient::StartNetwork() {
-		m_asio_client_p->StartNetwork();
+	void AsioClient::StartNetwork( int32_t thread_number/* = 1*/ ) {
+		m_asio_client_p->StartNetwork( thread_number );
 	}
 
 	bool AsioClient::IsNetworkStarted() {
@@ -304,6 +490,18 @@ namespace basicx {
 		return m_asio_client_p->Client_SendData_Sy( connect_info, data, size );
 	}
 
+	void AsioClient::Client_AddConnect_As( std::string address, int32_t port, std::string node_type, int32_t time_out_ms, AsioConnectHandler handler ) {
+		m_asio_client_p->Client_AddConnect_As( address, port, node_type, time_out_ms, handler );
+	}
+
+	void AsioClient::Client_ReadData_As( ConnectAsio* connect_info, char* data, int32_t size, int32_t time_out_ms, AsioHandler handler ) {
+		m_asio_client_p->Client_ReadData_As( connect_info, data, size, time_out_ms, handler );
+	}
+
+	void AsioClient::Client_SendData_As( ConnectAsio* connect_info, const char* data, int32_t size, int32_t time_out_ms, AsioHandler handler ) {
+		m_asio_client_p->Client_SendData_As( connect_info, data, size, time_out_ms, handler );
+	}
+
 	void AsioClient::Client_CloseByUser( ConnectAsio* connect_info ) {
 		m_asio_client_p->Client_CloseByUser( connect_info );
 	}
@@ -24,6 +24,7 @@
 
 #include <string>
 #include <stdint.h>
+#include <functional>
 
 #include <common/compile.h>
 
@@ -31,6 +32,12 @@ namespace basicx {
 
 	struct ConnectAsio;
 
+	#define ASIO_RESULT_ERROR -1 // 连接未建立、已断开或读写出错，连接已被关闭
+	#define ASIO_RESULT_TIMEOUT -2 // 超过时限，未完成的读写已取消，连接已被关闭
+
+	typedef std::function<void( int32_t result )> AsioHandler; // result 为读写字节数，失败时为 ASIO_RESULT_*
+	typedef std::function<void( ConnectAsio* connect_info, int32_t result )> AsioConnectHandler; // 成功时 result 为 0
+
 	class AsioClient_P;
 
 	class BASICX_NETWORK_EXPIMP AsioClient
@@ -40,7 +47,7 @@ namespace basicx {
 		~AsioClient();
 
 	public:
-		void StartNetwork();
+		void StartNetwork( int32_t thread_number = 1 ); // 异步接口的回调在这些线程中执行
 		bool IsNetworkStarted();
 
 		ConnectAsio* Client_AddConnect( std::string address, int32_t port, std::string node_type, int32_t time_out_sec );
@@ -48,6 +55,22 @@ namespace basicx {
 		int32_t Client_ReadData_Sy( ConnectAsio* connect_info, char* data, int32_t size );
 		int32_t Client_SendData_Sy( ConnectAsio* connect_info, const char* data, int32_t size );
 
+		// 异步接口，立即返回，完成或超时后在网络线程中回调，同一连接的回调串行执行，time_out_ms 为 0 时不限时
+		// 读写完成前 data 须保持有效，可配合 boost::asio::coroutine 把一次会话写成顺序代码，少量线程即可承载大量会话：
+		// struct Session : boost::asio::coroutine {
+		//     void operator()( int32_t result = 0 ) {
+		//         reenter( this ) {
+		//             yield m_client->Client_SendData_As( m_connect, m_request, m_request_size, 1000, *this );
+		//             if( result < 0 ) return;
+		//             yield m_client->Client_ReadData_As( m_connect, m_answer, m_answer_size, 1000, *this );
+		//             ...
+		//         }
+		//     }
+		// };
+		void Client_AddConnect_As( std::string address, int32_t port, std::string node_type, int32_t time_out_ms, AsioConnectHandler handler );
+		void Client_ReadData_As( ConnectAsio* connect_info, char* data, int32_t size, int32_t time_out_ms, AsioHandler handler );
+		void Client_SendData_As( ConnectAsio* connect_info, const char* data, int32_t size, int32_t time_out_ms, AsioHandler handler );
+
 		void Client_CloseByUser( ConnectAsio* connect_info );
 
 	private:
@@ -35,6 +35,7 @@ namespace basicx {
 	struct ConnectAsio
 	{
 		SocketPtr m_socket;
+		StrandPtr m_strand; // 첽ӿڵĻصִ
 		std::mutex m_mutex;
 		std::condition_variable m_condition;
 		std::atomic<bool> m_available; // Ƿɹ
@@ -55,6 +56,19 @@ namespace basicx {
 		std::string m_node_type; // ؼԶӽڵ
 	};
 
+	struct AsioOperation // һδʱ޵첽
+	{
+		ConnectAsio* m_connect_info;
+		ResolverPtr m_resolver; // ʱʹ
+		SteadyTimerPtr m_deadline_timer; // ʱΪ
+		bool m_timed_out;
+		bool m_completed; // ʱڲɺűִ
+		AsioHandler m_handler;
+		AsioConnectHandler m_connect_handler;
+	};
+
+	typedef std::shared_ptr<AsioOperation> AsioOperationPtr;
+
 	#pragma pack( pop )
 
 	class AsioClient_P
@@ -69,7 +83,7 @@ namespace basicx {
 	public:
 		void Thread_AsioClient();
 
-		void StartNetwork();
+		void StartNetwork( int32_t thread_number );
 		bool IsNetworkStarted();
 
 		ConnectAsio* Client_AddConnect( std::string address, int32_t port, std::string node_type, int32_t time_out_sec );
@@ -78,12 +92,25 @@ namespace basicx {
 		int32_t Client_ReadData_Sy( ConnectAsio* connect_info, char* data, int32_t size );
 		int32_t Client_SendData_Sy( ConnectAsio* connect_info, const char* data, int32_t size );
 
+		void Client_InitConnect( ConnectAsio* connect_info );
+		AsioOperationPtr Client_MakeOperation( ConnectAsio* connect_info, int32_t time_out_ms );
+		void Client_HandleDeadline( const boost::system::error_code& error, AsioOperationPtr operation );
+		void Client_AddConnect_As( std::string address, int32_t port, std::string node_type, int32_t time_out_ms, AsioConnectHandler handler );
+		void Client_HandleResolve_As( const boost::system::error_code& error, boost::asio::ip::tcp::resolver::iterator endpoint_iterator, AsioOperationPtr operation );
+		void Client_HandleConnect_As( const boost::system::error_code& error, AsioOperationPtr operation );
+		void Client_ReadData_As( ConnectAsio* connect_info, char* data, int32_t size, int32_t time_out_ms, AsioHandler handler );
+		void Client_SendData_As( ConnectAsio* connect_info, const char* data, int32_t size, int32_t time_out_ms, AsioHandler handler );
+		void Client_StartRead_As( AsioOperationPtr operation, char* data, int32_t size );
+		void Client_StartSend_As( AsioOperationPtr operation, const char* data, int32_t size );
+		void Client_HandleData_As( const boost::system::error_code& error, size_t size, AsioOperationPtr operation );
+
 		void Client_CloseByUser( ConnectAsio* connect_info );
 		void Client_CloseOnError( ConnectAsio* connect_info );
 
 	public:
 		ServicePtr m_service;
 		bool m_network_running;
+		int32_t m_thread_number;
 
 		TCPSocketOption m_tcp_socket_option;
 
@@ -48,11 +48,33 @@ namespace basicx {
 	NetClient_X::~NetClient_X() {
 	}
 
+	void NetClient_X::OnNetClientView( NetClientView& net_client_view ) {
+		std::string data( net_client_view.m_data, net_client_view.m_size );
+		NetClientData net_client_data( const_cast<std::string&>( *net_client_view.m_node_type ), net_client_view.m_identity, net_client_view.m_code, data ); // std::move( data )
+		OnNetClientData( net_client_data );
+	}
+
+	std::shared_ptr<const char> NetClientView::TakeData() const {
+		return std::shared_ptr<const char>( *m_data_owner, m_data ); // ջ棬ģ鷢ֱкỻ»
+	}
+
 	NetClient_P::NetClient_P()
 		: m_net_client_x( nullptr )
 		, m_network_running( false )
 		, m_identity_count( 0 )
 		, m_auto_reconnect_client( false )
+		, m_binary_head_client( false )
+		, m_heart_wheel( nullptr )
+		, m_idle_timeout_c( 0 ) // 0 Ϊ
+		, m_request_id( 0 )
+		, m_request_wheel( nullptr )
+		, m_reconnect_random( std::random_device()() )
+		, m_reconnect_backoff_min( RECONNECT_BACKOFF_MIN )
+		, m_reconnect_backoff_max( RECONNECT_BACKOFF_MAX )
+		, m_stat_reconnect_attempt( 0 )
+		, m_stat_reconnect_success( 0 )
+		, m_stat_reconnect_failure( 0 )
+		, m_shm_running( false )
 		, m_unique_lock( m_sender_lock )
 		, m_sender_vector_1( nullptr )
 		, m_sender_vector_2( nullptr )
@@ -69,9 +91,19 @@ namespace basicx {
 		, m_total_remote_connect( 0 )
 		, m_log_cate( "<NET_CLIENT>" ) {
 		m_syslog = SysLog_S::GetInstance();
+		for( int32_t i = 0; i < RECONNECT_HISTOGRAM_SIZE; i++ ) {
+			m_stat_reconnect_latency[i] = 0;
+		}
+		NetMetricsRegistry::Register( this );
 	}
 
 	NetClient_P::~NetClient_P() {
+		NetMetricsRegistry::Unregister( this ); // ӣղٷʱʵ
+		if( true == m_shm_running ) {
+			m_shm_running = false;
+			m_shm_thread.join();
+		}
+
 		m_sender_running = false;
 		m_sender_condition.notify_all();
 		m_sender_thread.join();
@@ -81,14 +113,34 @@ namespace basicx {
 		if( m_sender_vector_2 != nullptr ) {
 			delete m_sender_vector_2;
 		}
+		for( size_t i = 0; i < m_vec_send_pool.size(); i++ ) {
+			delete m_vec_send_pool[i];
+		}
+		m_vec_send_pool.clear();
 
 		if( true == m_network_running ) {
 			m_network_running = false;
 			m_service->stop();
 		}
 
+		if( m_heart_wheel != nullptr ) {
+			delete m_heart_wheel;
+			m_heart_wheel = nullptr;
+		}
+
+		if( m_request_wheel != nullptr ) {
+			delete m_request_wheel;
+			m_request_wheel = nullptr;
+		}
+
 		for( auto it_ci = m_list_remote_info.begin(); it_ci != m_list_remote_info.end(); it_ci++ ) {
 			if( (*it_ci) != nullptr ) {
+				for( size_t i = 0; i < (*it_ci)->m_vec_send_pending.size(); i++ ) { // ֹͣδдĲٻص黹
+					delete (*it_ci)->m_vec_send_pending[i];
+				}
+				for( size_t i = 0; i < (*it_ci)->m_vec_send_writing.size(); i++ ) {
+					delete (*it_ci)->m_vec_send_writing[i];
+				}
 				(*it_ci)->clear();
 				delete (*it_ci);
 				(*it_ci) = nullptr;
@@ -120,30 +172,6 @@ namespace basicx {
 		m_syslog->LogPrint( log_level, log_cate, "LOG>: " + log_info ); // ̨
 	}
 
-	void NetClient_P::Thread_ClientOnTime() {
-		std::string log_info;
-
-		log_info = "ͻ ͨŶʱ߳, ʼͨŶʱ ...";
-		LogPrint( syslog_level::c_info, m_log_cate, log_info );
-
-		try {
-			while( true ) {
-				std::this_thread::sleep_for( std::chrono::milliseconds( m_heart_check_time * 1000 ) );
-				if( IsNetworkStarted() ) {
-					SendHeartCheck(); // 
-					MakeReconnect(); // ֻԿͻ˷ұϿ
-				}
-			}
-		} // try
-		catch( ... ) {
-			log_info = "ͻ ͨŶʱ̷߳δ֪";
-			LogPrint( syslog_level::c_fatal, m_log_cate, log_info );
-		}
-
-		log_info = "ͻ ͨŶʱ߳˳";
-		LogPrint( syslog_level::c_warn, m_log_cate, log_info );
-	}
-
 	void NetClient_P::Thread_NetClient() {
 		std::string log_info;
 
@@ -155,6 +183,11 @@ namespace basicx {
 				m_service = std::make_shared<boost::asio::io_service>();
 				boost::asio::io_service::work work( *m_service );
 
+				m_heart_wheel = new TimerWheel<int32_t>( WHEEL_SLOT_NUMBER, WHEEL_TICK_MS, GetSteadyTimeMs() );
+				m_request_wheel = new TimerWheel<uint64_t>( WHEEL_SLOT_NUMBER, WHEEL_TICK_MS, GetSteadyTimeMs() );
+				m_wheel_timer = std::make_shared<boost::asio::steady_timer>( *m_service );
+				Client_StartWheel();
+
 				for( int32_t i = 0; i < m_io_work_thread_number; i++ ) {
 					ThreadPtr thread_ptr( new std::thread( boost::bind( &boost::asio::io_service::run, m_service ) ) );
 					m_vec_thread.push_back( thread_ptr );
@@ -206,10 +239,6 @@ namespace basicx {
 		log_info = "ͻ  ͨŷ ̡߳";
 		LogPrint( syslog_level::c_info, m_log_cate, log_info );
 
-		m_thread_client_on_time = std::thread( &NetClient_P::Thread_ClientOnTime, this );
-		log_info = "ͻ  ͨŶʱ ̡߳";
-		LogPrint( syslog_level::c_info, m_log_cate, log_info );
-
 		// нģʽ£Ҫ while() Ƿᵼ LogPrint() е SendMessage ߱ǴڴǰҪͽϢ
 		while( false == m_network_running ) {
 			std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
@@ -251,8 +280,7 @@ namespace basicx {
 	}
 
 	bool NetClient_P::Client_CanAddServer( std::string address_r, int32_t port_r ) {
-		std::string server_endpoint;
-		FormatLibrary::StandardLibrary::FormatTo( server_endpoint, "tcp://{0}:{1}", address_r, port_r );
+		std::string server_endpoint = Client_GetServerEndpoint( address_r, port_r );
 
 		bool can_add_connect = true;
 
@@ -266,6 +294,35 @@ namespace basicx {
 		return can_add_connect;
 	}
 
+	std::string NetClient_P::Client_GetServerEndpoint( const std::string& address_r, int32_t port_r ) {
+		if( true == IsShmAddress( address_r ) ) {
+			return address_r;
+		}
+		std::string server_endpoint;
+		FormatLibrary::StandardLibrary::FormatTo( server_endpoint, "tcp://{0}:{1}", address_r, port_r );
+		return server_endpoint;
+	}
+
+	void NetClient_P::Client_AddServerInfo( std::string address_r, int32_t port_r, std::string node_type_r ) {
+		std::string log_info;
+		std::string server_endpoint = Client_GetServerEndpoint( address_r, port_r );
+		m_server_info_lock.lock();
+		auto it_si = m_map_server_info.find( server_endpoint );
+		if( it_si == m_map_server_info.end() ) {
+			ServerInfo* server_info = new ServerInfo();
+			server_info->m_address = address_r;
+			server_info->m_port = port_r;
+			server_info->m_node_type = node_type_r;
+			server_info->m_connect_number = 0;
+			m_map_server_info.insert( std::pair<std::string, ServerInfo*>( server_endpoint, server_info ) );
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  Զ{0}:{1}:{2}", address_r, port_r, node_type_r );
+		}
+		m_server_info_lock.unlock();
+		if( !log_info.empty() ) {
+			LogPrint( syslog_level::c_info, m_log_cate, log_info );
+		}
+	}
+
 	bool NetClient_P::Client_AddConnect( std::string address_r, int32_t port_r, std::string node_type_r ) {
 		std::string log_info;
 
@@ -284,6 +341,10 @@ namespace basicx {
 				return false;
 			}
 
+			if( true == IsShmAddress( address_r ) ) {
+				return Client_StartConnectShm( address_r, port_r, node_type_r, 0 );
+			}
+
 			std::string port_r_temp;
 			FormatLibrary::StandardLibrary::FormatTo( port_r_temp, "{0}", port_r );
 			std::string address_r_temp = address_r;
@@ -293,32 +354,45 @@ namespace basicx {
 			boost::asio::ip::tcp::resolver::query query( address_r_temp, port_r_temp );
 			boost::asio::ip::tcp::resolver::iterator endpoint_iterator = resolver.resolve( query );
 
+			return Client_StartConnect( endpoint_iterator, address_r, port_r, node_type_r, 0 );
+		}
+		catch( std::exception& ex ) {
+			if( 1 == m_log_test ) {
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ   쳣{0}", ex.what() );
+			}
+			else {
+				log_info = "ͻ   쳣";
+			}
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+			return false;
+		}
+	}
+
+	bool NetClient_P::Client_StartConnect( boost::asio::ip::tcp::resolver::iterator endpoint_iterator, std::string address_r, int32_t port_r, std::string node_type_r, int32_t reconnect_identity, ConnectRacePtr connect_race ) {
+		std::string log_info;
+
+		ConnectInfo* connect_info = nullptr;
+
+		try {
 			connect_info = new ConnectInfo(); // ӽϢܻҲӣΪﻹû
 			connect_info->m_socket = std::make_shared<boost::asio::ip::tcp::socket>( *m_service );
 			connect_info->m_connect_timer = std::make_shared<boost::asio::deadline_timer>( *m_service );
 			connect_info->m_available = false;
 			connect_info->m_node_type = node_type_r; //
+			connect_info->m_reconnect_identity = reconnect_identity;
+			connect_info->m_connect_race = connect_race;
 
 			// ¼ԶϢ
-			std::string server_endpoint;
-			FormatLibrary::StandardLibrary::FormatTo( server_endpoint, "tcp://{0}:{1}", address_r, port_r );
-			m_server_info_lock.lock();
-			auto it_si = m_map_server_info.find( server_endpoint );
-			if( it_si == m_map_server_info.end() ) {
-				ServerInfo* server_info = new ServerInfo();
-				server_info->m_address = address_r;
-				server_info->m_port = port_r;
-				server_info->m_node_type = node_type_r;
-				server_info->m_connect_number = 0;
-				m_map_server_info.insert( std::pair<std::string, ServerInfo*>( server_endpoint, server_info ) );
-				FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  Զ{0}:{1}:{2}", address_r, port_r, node_type_r );
-				LogPrint( syslog_level::c_info, m_log_cate, log_info );
-			}
-			m_server_info_lock.unlock();
+			Client_AddServerInfo( address_r, port_r, node_type_r );
 
 			// 첽Ӳ
 			connect_info->m_connect_timer->expires_from_now( boost::posix_time::milliseconds( m_client_connect_timeout ) );
-			boost::asio::async_connect( *(connect_info->m_socket), endpoint_iterator, boost::bind( &NetClient_P::Client_HandleConnect, this, boost::asio::placeholders::error, connect_info ) );
+			if( connect_race != nullptr ) { // ʱÿγֻһַ
+				connect_info->m_socket->async_connect( endpoint_iterator->endpoint(), boost::bind( &NetClient_P::Client_HandleConnect, this, boost::asio::placeholders::error, connect_info ) );
+			}
+			else { // γԸַ
+				boost::asio::async_connect( *(connect_info->m_socket), endpoint_iterator, boost::bind( &NetClient_P::Client_HandleConnect, this, boost::asio::placeholders::error, connect_info ) );
+			}
 			connect_info->m_connect_timer->async_wait( boost::bind( &NetClient_P::Client_CheckConnectTime, this, connect_info ) );
 		}
 		catch( std::exception& ex ) { // ûдʱѽconnect_info ɳʱ Client_CheckConnectTime() ڴ
@@ -337,12 +411,14 @@ namespace basicx {
 
 				connect_info->m_connect_timer->cancel();
 
-				// TODOԼ뵽
-
 				delete connect_info;
 				connect_info = nullptr;
 			}
 
+			if( reconnect_identity != 0 && Client_ConnectRaceFailed( connect_race ) ) {
+				Client_ReconnectFailed( reconnect_identity );
+			}
+
 			return false;
 		}
 
@@ -358,13 +434,20 @@ namespace basicx {
 					connect_info->m_socket->close();
 				}
 
-				// TODOԼ뵽
+				int32_t reconnect_identity = connect_info->m_reconnect_identity;
+				ConnectRacePtr connect_race = connect_info->m_connect_race;
 
 				delete connect_info;
 				connect_info = nullptr;
 
-				log_info = "ͻ   ʱ";
-				LogPrint( syslog_level::c_error, m_log_cate, log_info );
+				if( nullptr == connect_race || false == connect_race->m_finish ) { // ַʤĲٱʱ
+					log_info = "ͻ   ʱ";
+					LogPrint( syslog_level::c_error, m_log_cate, log_info );
+				}
+
+				if( reconnect_identity != 0 && Client_ConnectRaceFailed( connect_race ) ) { // ´
+					Client_ReconnectFailed( reconnect_identity );
+				}
 			}
 			else { // ѽ
 				connect_info->m_connect_timer->cancel(); // Ҫٵȴʱ
@@ -381,11 +464,23 @@ namespace basicx {
 	void NetClient_P::Client_HandleConnect( const boost::system::error_code& error, ConnectInfo* connect_info ) {
 		std::string log_info;
 
+		if( !error && connect_info->m_connect_race != nullptr ) { // ʱֻȳɹӣرպɳʱ
+			bool finish = false;
+			if( false == connect_info->m_connect_race->m_finish.compare_exchange_strong( finish, true ) ) {
+				boost::system::error_code ec;
+				connect_info->m_socket->close( ec );
+				return;
+			}
+		}
+
 		if( !error ) {
 			connect_info->m_identity = Client_GetIdentity();
 			connect_info->m_available = true;
 			time( &connect_info->m_heart_check_time );
 			connect_info->m_active_close = false;
+			connect_info->m_send_time = GetSteadyTimeMs();
+			connect_info->m_recv_time = connect_info->m_send_time.load();
+			connect_info->m_head_mode = HEAD_MODE_TEXT; // ȷϺл
 
 			connect_info->m_protocol_r = "tcp";
 			connect_info->m_adress_r = connect_info->m_socket->remote_endpoint().address().to_string().c_str();
@@ -399,11 +494,21 @@ namespace basicx {
 			FormatLibrary::StandardLibrary::FormatTo( connect_info->m_str_port_l, "{0}", connect_info->m_port_l );
 			connect_info->m_endpoint_l = connect_info->m_protocol_l + "://" + connect_info->m_adress_l + ":" + connect_info->m_str_port_l; // ӱ"tcp://192.16.1.38:465"
 
+			connect_info->m_node_type_intern = InternNodeType( connect_info->m_node_type );
+
 			connect_info->m_recv_buf_head = new char[HEAD_BYTES];
-			connect_info->m_recv_buf_data = new char[1024];
+			connect_info->m_recv_buf_share = MakeRecvBuf( 1024 );
+			connect_info->m_recv_buf_data = connect_info->m_recv_buf_share.get();
 			connect_info->m_recv_buf_data_size = 1024;
 
-			connect_info->m_stat_lost_msg = 0;
+			Client_InitCompress( connect_info );
+			Client_InitSendQueue( connect_info );
+
+			connect_info->ResetStat();
+
+			connect_info->m_send_writing = false;
+			connect_info->m_send_backlog_time = 0;
+			connect_info->m_send_pending_base = 0;
 
 			m_remote_info_lock.lock();
 			m_list_remote_info.push_back( connect_info );
@@ -416,9 +521,10 @@ namespace basicx {
 			FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ ӣ[{0}]->[{1}]{2}", connect_info->m_endpoint_l, connect_info->m_endpoint_r, connect_info->m_identity );
 			LogPrint( syslog_level::c_info, m_log_cate, log_info );
 
+			m_heart_wheel->Schedule( connect_info->m_identity, Client_GetCheckTime( connect_info ) );
+
 			// ԶϢ
-			std::string server_endpoint;
-			FormatLibrary::StandardLibrary::FormatTo( server_endpoint, "tcp://{0}:{1}", connect_info->m_adress_r, connect_info->m_port_r );
+			std::string server_endpoint = Client_GetServerEndpoint( connect_info->m_adress_r, connect_info->m_port_r );
 			m_server_info_lock.lock();
 			auto it_si = m_map_server_info.find( server_endpoint );
 			if( it_si != m_map_server_info.end() ) {
@@ -426,17 +532,8 @@ namespace basicx {
 			}
 			m_server_info_lock.unlock();
 
-			// Ϊʱ Client_AddConnect() ǷӳɹģҪ Client_HandleConnect() Ƿ񱨴жǷɹ
-			m_reconnect_info_lock.lock();
-			for( auto it_ri = m_list_reconnect_info.begin(); it_ri != m_list_reconnect_info.end(); it_ri++ ) {
-				if( it_ri->m_address == connect_info->m_adress_r && it_ri->m_port == connect_info->m_port_r && it_ri->m_node_type == connect_info->m_node_type ) { // һֻҪַ˿һ¾
-					m_list_reconnect_info.erase( it_ri ); // ˵ѳɹ
-					FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  {0}:{1}:{2} ɹ", it_ri->m_address, it_ri->m_port, it_ri->m_node_type );
-					LogPrint( syslog_level::c_info, m_log_cate, log_info );
-					break;
-				}
-			}
-			m_reconnect_info_lock.unlock();
+			// Ϊʱ Client_StartConnect() ǷӳɹģҪ Client_HandleConnect() Ƿ񱨴жǷɹ
+			Client_ReconnectSucceed( connect_info );
 
 			try {
 				connect_info->m_socket->set_option( boost::asio::ip::tcp::no_delay( m_tcp_socket_option.m_no_delay ) );
@@ -448,6 +545,11 @@ namespace basicx {
 				// ׼ӷ˽ Type 
 				memset( connect_info->m_recv_buf_head, 0, HEAD_BYTES );
 				boost::asio::async_read( *(connect_info->m_socket), boost::asio::buffer( connect_info->m_recv_buf_head, HEAD_BYTES ), boost::bind( &NetClient_P::Client_HandleRecvHead, this, boost::asio::placeholders::error, connect_info ) );
+
+				// öưͷɰ˻ᵱͨ
+				if( true == m_binary_head_client ) {
+					Client_SendData( connect_info, NW_MSG_TYPE_HEART_CHECK, NW_MSG_CODE_HEAD_BINARY, std::string( "" ) );
+				}
 			}
 			catch( std::exception& ex ) {
 				Client_CloseOnError( connect_info );
@@ -474,25 +576,132 @@ namespace basicx {
 				log_info = "ͻ   ";
 			}
 			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+
+			if( error != boost::asio::error::operation_aborted ) { // ӱܾȲصȵʱóʱȡɳʱ
+				boost::system::error_code ec;
+				connect_info->m_connect_timer->expires_from_now( boost::posix_time::milliseconds( 0 ), ec );
+			}
 		}
 	}
 
 	void NetClient_P::Client_SetAutoReconnect( bool auto_reconnect ) {
 		m_auto_reconnect_client = auto_reconnect;
+		if( false == auto_reconnect ) { // Ӵʱһֱֶȡ
+			Client_ClearReconnect();
+		}
+	}
+
+	void NetClient_P::Client_SetReconnectBackoff( int32_t backoff_min, int32_t backoff_max ) {
+		m_reconnect_backoff_min = backoff_min > 0 ? backoff_min : 1;
+		m_reconnect_backoff_max = backoff_max > m_reconnect_backoff_min ? backoff_max : m_reconnect_backoff_min;
+	}
+
+	void NetClient_P::CollectMetrics( NetMetrics& net_metrics, bool with_connect ) {
+		net_metrics.m_source_id = m_source_id;
+		net_metrics.m_role = METRICS_ROLE_CLIENT;
+		net_metrics.m_snapshot_time = 0;
+		net_metrics.m_connect_count = 0;
+		m_stat_closed.CopyTo( net_metrics );
+		net_metrics.m_reconnect_attempt = m_stat_reconnect_attempt;
+		net_metrics.m_reconnect_success = m_stat_reconnect_success;
+		net_metrics.m_reconnect_failure = m_stat_reconnect_failure;
+		m_stat_send_latency.CopyTo( net_metrics.m_latency_histogram );
+		net_metrics.m_vec_connect.clear();
+		m_remote_info_lock.lock(); // ֻڿʱɾӾ
+		for( auto it_ci = m_list_remote_info.begin(); it_ci != m_list_remote_info.end(); it_ci++ ) {
+			CollectConnectMetrics( *it_ci, net_metrics, with_connect );
+		}
+		m_remote_info_lock.unlock();
+	}
+
+	NetClientReconnectStat NetClient_P::Client_GetReconnectStat() {
+		NetClientReconnectStat reconnect_stat;
+		reconnect_stat.m_attempt_count = m_stat_reconnect_attempt;
+		reconnect_stat.m_success_count = m_stat_reconnect_success;
+		reconnect_stat.m_failure_count = m_stat_reconnect_failure;
+		for( int32_t i = 0; i < RECONNECT_HISTOGRAM_SIZE; i++ ) {
+			reconnect_stat.m_latency_histogram[i] = m_stat_reconnect_latency[i];
+		}
+		return reconnect_stat;
+	}
+
+	void NetClient_P::Client_SetIdleTimeout( int32_t idle_timeout ) {
+		m_idle_timeout_c = idle_timeout > 0 ? idle_timeout : 0;
+	}
+
+	void NetClient_P::Client_SetBinaryHead( bool binary_head ) {
+		m_binary_head_client = binary_head;
+	}
+
+	void NetClient_P::Client_SetCompression( std::string node_type_r, int32_t codec, size_t threshold, std::string dict ) {
+		std::string log_info;
+		if( codec != NW_COMPRESS_NONE && false == IsCodecSupported( codec ) ) {
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ ѹʽ {0} δ֧֣ LZ ѹ{1}", codec, node_type_r );
+			LogPrint( syslog_level::c_warn, m_log_cate, log_info );
+			codec = NW_COMPRESS_LZ;
+		}
+		CompressConfig compress_config;
+		compress_config.m_codec = codec;
+		compress_config.m_threshold = threshold;
+		compress_config.m_dict = MakeCompressDict( dict );
+		m_compress_dict_table.Add( compress_config.m_dict ); // ѹʱҲǼֵ䣬ڽѹԶ
+		m_compress_lock.lock();
+		m_map_compress_config[node_type_r] = compress_config;
+		m_compress_lock.unlock();
+		FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  ѹ{0} ʽ{1} ֵ{2} ֵ䣺{3}", node_type_r, codec, threshold, compress_config.m_dict != nullptr ? compress_config.m_dict->m_dict.length() : 0 );
+		LogPrint( syslog_level::c_info, m_log_cate, log_info );
+	}
+
+	void NetClient_P::Client_InitCompress( ConnectInfo* connect_info ) {
+		connect_info->m_compress_codec = NW_COMPRESS_NONE;
+		connect_info->m_compress_threshold = 0;
+		connect_info->m_unpack_buf_size = 0;
+		if( nullptr == connect_info->m_shm_channel ) {
+			std::lock_guard<std::mutex> lock( m_compress_lock );
+			auto it_cc = m_map_compress_config.find( connect_info->m_node_type );
+			if( it_cc != m_map_compress_config.end() ) {
+				connect_info->m_compress_codec = it_cc->second.m_codec;
+				connect_info->m_compress_threshold = it_cc->second.m_threshold;
+				connect_info->m_compress_dict = it_cc->second.m_dict;
+			}
+		}
+	}
+
+	void NetClient_P::Client_SetSendQueue( std::string node_type_r, size_t queue_limit, int32_t queue_policy, int32_t backlog_timeout ) {
+		SendQueueConfig send_queue_config;
+		send_queue_config.m_queue_limit = queue_limit;
+		send_queue_config.m_queue_policy = queue_policy;
+		send_queue_config.m_backlog_timeout = backlog_timeout > 0 ? backlog_timeout : 0;
+		m_send_queue_lock.lock();
+		m_map_send_queue_config[node_type_r] = send_queue_config;
+		m_send_queue_lock.unlock();
+		std::string log_info;
+		FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  ͶУ{0} ޣ{1} ԣ{2} ѹʱ{3}", node_type_r, queue_limit, queue_policy, send_queue_config.m_backlog_timeout );
+		LogPrint( syslog_level::c_info, m_log_cate, log_info );
+	}
+
+	void NetClient_P::Client_InitSendQueue( ConnectInfo* connect_info ) { // ڴӲ̣߳ò
+		connect_info->m_send_queue_limit = 0;
+		connect_info->m_send_queue_policy = NW_QUEUE_DROP_NEWEST;
+		connect_info->m_send_backlog_timeout = 0;
+		std::lock_guard<std::mutex> lock( m_send_queue_lock );
+		auto it_sq = m_map_send_queue_config.find( connect_info->m_node_type );
+		if( it_sq != m_map_send_queue_config.end() ) {
+			connect_info->m_send_queue_limit = it_sq->second.m_queue_limit;
+			connect_info->m_send_queue_policy = it_sq->second.m_queue_policy;
+			connect_info->m_send_backlog_timeout = it_sq->second.m_backlog_timeout;
+		}
 	}
 
 	void NetClient_P::Client_HandleRecvHead( const boost::system::error_code& error, ConnectInfo* connect_info ) {
 		if( !error ) {
 			try {
-				int32_t type( 0 );
-				int32_t code( 0 );
-				int32_t size( 0 );
-				std::istringstream type_temp( std::string( connect_info->m_recv_buf_head, TYPE_BYTES ) );
-				std::istringstream code_temp( std::string( connect_info->m_recv_buf_head, TYPE_BYTES, CODE_BYTES ) );
-				std::istringstream size_temp( std::string( connect_info->m_recv_buf_head, FLAG_BYTES, SIZE_BYTES ) );
-				type_temp >> std::hex >> type;
-				code_temp >> std::hex >> code;
-				size_temp >> std::hex >> size;
+				connect_info->m_recv_time.store( GetSteadyTimeMs(), std::memory_order_relaxed );
+				FrameHead frame_head; // ıưͷֽԶʶ
+				bool head_valid = DecodeHead( connect_info->m_recv_buf_head, frame_head );
+				int32_t type = frame_head.m_type;
+				int32_t code = frame_head.m_code;
+				size_t size = frame_head.m_size;
 
 				if( 1 == m_log_test ) {
 					std::string log_info;
@@ -500,6 +709,14 @@ namespace basicx {
 					LogPrint( syslog_level::c_info, m_log_cate, log_info );
 				}
 
+				if( false == head_valid ) {
+					std::string log_info;
+					Client_CloseOnError( connect_info );
+					FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ յ Ƿݰͷ{0}", std::string( connect_info->m_recv_buf_head, HEAD_BYTES ) );
+					LogPrint( syslog_level::c_error, m_log_cate, log_info );
+					return;
+				}
+
 				if( type < NW_MSG_ATOM_TYPE_MIN || type > NW_MSG_USER_TYPE_MAX ) {
 					std::string log_info;
 					Client_CloseOnError( connect_info );
@@ -517,19 +734,27 @@ namespace basicx {
 				}
 
 				if( 0 == size ) {
+					connect_info->m_stat_recv_bytes.fetch_add( HEAD_BYTES, std::memory_order_relaxed );
+					connect_info->m_stat_recv_msgs.fetch_add( 1, std::memory_order_relaxed );
+					if( NW_MSG_TYPE_HEART_CHECK == type && NW_MSG_CODE_HEAD_BINARY == code && true == m_binary_head_client ) { // ȷϣ֮Ϣöưͷ
+						connect_info->m_head_mode = HEAD_MODE_BINARY;
+						std::string log_info;
+						FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ   ưͷ[{0}]->[{1}]{2}", connect_info->m_endpoint_l, connect_info->m_endpoint_r, connect_info->m_identity );
+						LogPrint( syslog_level::c_info, m_log_cate, log_info );
+					}
 					// ׼ӷ˽ Head 
 					memset( connect_info->m_recv_buf_head, 0, HEAD_BYTES );
 					boost::asio::async_read( *(connect_info->m_socket), boost::asio::buffer( connect_info->m_recv_buf_head, HEAD_BYTES ), boost::bind( &NetClient_P::Client_HandleRecvHead, this, boost::asio::placeholders::error, connect_info ) );
 				}
-				else if( size > 0 && size <= m_max_data_length_c ) {
+				else if( size <= m_max_data_length_c ) {
 					// ׼ӷ˽ Data 
-					if( connect_info->m_recv_buf_data_size < size ) {
-						delete[] connect_info->m_recv_buf_data;
-						connect_info->m_recv_buf_data = new char[size];
-						connect_info->m_recv_buf_data_size = size;
+					if( connect_info->m_recv_buf_data_size < size || connect_info->m_recv_buf_share.use_count() > 1 ) { // 治ѱصȡȨ»
+						size_t recv_buf_size = size > connect_info->m_recv_buf_data_size ? size : connect_info->m_recv_buf_data_size;
+						connect_info->m_recv_buf_share = MakeRecvBuf( recv_buf_size );
+						connect_info->m_recv_buf_data = connect_info->m_recv_buf_share.get();
+						connect_info->m_recv_buf_data_size = recv_buf_size;
 					}
-					memset( connect_info->m_recv_buf_data, 0, size );
-					boost::asio::async_read( *(connect_info->m_socket), boost::asio::buffer( connect_info->m_recv_buf_data, size ), boost::bind( &NetClient_P::Client_HandleRecvData, this, boost::asio::placeholders::error, connect_info, type, code, size ) );
+					boost::asio::async_read( *(connect_info->m_socket), boost::asio::buffer( connect_info->m_recv_buf_data, size ), boost::bind( &NetClient_P::Client_HandleRecvData, this, boost::asio::placeholders::error, connect_info, type, code, frame_head.m_flag, (int32_t)size ) );
 				}
 				else {
 					std::string log_info;
@@ -563,45 +788,22 @@ namespace basicx {
 		}
 	}
 
-	void NetClient_P::Client_HandleRecvData( const boost::system::error_code& error, ConnectInfo* connect_info, int32_t type, int32_t code, int32_t size ) {
+	void NetClient_P::Client_HandleRecvData( const boost::system::error_code& error, ConnectInfo* connect_info, int32_t type, int32_t code, int32_t flag, int32_t size ) {
 		if( !error ) {
 			try {
-				std::string data( connect_info->m_recv_buf_data, size );
-
 				if( 1 == m_log_test ) {
 					std::string log_info;
-					FormatLibrary::StandardLibrary::FormatTo( log_info, "<--[{0}]Data:{1}", connect_info->m_endpoint_r, data.length() );
+					FormatLibrary::StandardLibrary::FormatTo( log_info, "<--[{0}]Data:{1}", connect_info->m_endpoint_r, size );
 					LogPrint( syslog_level::c_info, m_log_cate, log_info );
 				}
+				connect_info->m_stat_recv_bytes.fetch_add( HEAD_BYTES + size, std::memory_order_relaxed );
+				connect_info->m_stat_recv_msgs.fetch_add( 1, std::memory_order_relaxed );
 
-				if( !data.empty() ) {
-					try {
-						if( m_net_client_x != nullptr ) {
-							NetClientData net_client_data( connect_info->m_node_type, connect_info->m_identity, code, data ); // std::move( data )
-							m_net_client_x->OnNetClientData( net_client_data );
-						}
-						else {
-							std::string log_info;
-							log_info = "ͨŵģָ m_net_client_x Ϊգ";
-							LogPrint( syslog_level::c_warn, m_log_cate, log_info );
-						}
-					}
-					catch( ... ) {
-						std::string log_info;
-						log_info = "ͻ  Data  ת δ֪";
-						LogPrint( syslog_level::c_error, m_log_cate, log_info );
-					}
-
+				if( true == Client_HandleRecvFrame( connect_info, type, code, flag, size ) ) {
 					// ׼ӷ˽ Type 
 					memset( connect_info->m_recv_buf_head, 0, HEAD_BYTES );
 					boost::asio::async_read( *(connect_info->m_socket), boost::asio::buffer( connect_info->m_recv_buf_head, HEAD_BYTES ), boost::bind( &NetClient_P::Client_HandleRecvHead, this, boost::asio::placeholders::error, connect_info ) );
 				}
-				else {
-					std::string log_info;
-					Client_CloseOnError( connect_info );
-					log_info = "ͻ յ ݰΪգ";
-					LogPrint( syslog_level::c_error, m_log_cate, log_info );
-				}
 			}
 			catch( std::exception& ex ) {
 				std::string log_info;
@@ -628,6 +830,67 @@ namespace basicx {
 		}
 	}
 
+	bool NetClient_P::Client_HandleRecvFrame( ConnectInfo* connect_info, int32_t type, int32_t code, int32_t flag, int32_t size ) {
+		if( flag & FRAME_FLAG_COMPRESS ) { // ѹջ滥֮δѹ
+			size_t unpack_size = 0;
+			int32_t result = UnpackFrame( flag, connect_info->m_recv_buf_data, size, m_max_data_length_c, connect_info->m_compress_dict, m_compress_dict_table, connect_info->m_unpack_buf_share, connect_info->m_unpack_buf_size, unpack_size );
+			if( result != 0 ) { // ͷãֻϢ
+				std::string log_info;
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ ѹ ݰ ʧܣ{0}{1} {2}", connect_info->m_endpoint_r, result, size );
+				LogPrint( syslog_level::c_error, m_log_cate, log_info );
+				return true;
+			}
+			connect_info->m_recv_buf_share.swap( connect_info->m_unpack_buf_share );
+			std::swap( connect_info->m_recv_buf_data_size, connect_info->m_unpack_buf_size );
+			connect_info->m_recv_buf_data = connect_info->m_recv_buf_share.get();
+			size = (int32_t)unpack_size;
+		}
+
+		if( NW_MSG_TYPE_ANSWER == type ) {
+			if( size < REQUEST_ID_BYTES ) {
+				std::string log_info;
+				Client_CloseOnError( connect_info );
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ յ 쳣ӦС{0}", size );
+				LogPrint( syslog_level::c_error, m_log_cate, log_info );
+				return false;
+			}
+			Client_HandleAnswer( connect_info, code, size );
+			return true;
+		}
+
+		if( size <= 0 ) {
+			std::string log_info;
+			Client_CloseOnError( connect_info );
+			log_info = "ͻ յ ݰΪգ";
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+			return false;
+		}
+
+		try {
+			if( m_net_client_x != nullptr ) {
+				NetClientView net_client_view; // ֱָջ
+				net_client_view.m_node_type = connect_info->m_node_type_intern;
+				net_client_view.m_identity = connect_info->m_identity;
+				net_client_view.m_code = code;
+				net_client_view.m_data = connect_info->m_recv_buf_data;
+				net_client_view.m_size = size;
+				net_client_view.m_data_owner = &connect_info->m_recv_buf_share;
+				m_net_client_x->OnNetClientView( net_client_view );
+			}
+			else {
+				std::string log_info;
+				log_info = "ͨŵģָ m_net_client_x Ϊգ";
+				LogPrint( syslog_level::c_warn, m_log_cate, log_info );
+			}
+		}
+		catch( ... ) {
+			std::string log_info;
+			log_info = "ͻ  Data  ת δ֪";
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+		}
+		return true;
+	}
+
 	int32_t NetClient_P::Client_SendDataAll( int32_t type, int32_t code, std::string& data ) {
 		m_remote_info_lock.lock();
 		std::list<ConnectInfo*> list_remote_info = m_list_remote_info;
@@ -644,22 +907,26 @@ namespace basicx {
 	int32_t NetClient_P::Client_SendData( ConnectInfo* connect_info, int32_t type, int32_t code, std::string& data ) {
 		int32_t result = 0;
 		if( connect_info != nullptr && connect_info->m_available != false ) {
+			if( connect_info->m_shm_channel != nullptr ) { // ڴֱд뻷λ棬߳
+				return Client_SendShm( connect_info, type, code, data );
+			}
 			size_t size = data.length();
-			if( size <= m_max_data_length_c ) {
-				std::ostringstream type_temp;
-				std::ostringstream code_temp;
-				std::ostringstream size_temp;
-				type_temp << std::setw( TYPE_BYTES ) << std::hex << type;
-				code_temp << std::setw( CODE_BYTES ) << std::hex << code;
-				size_temp << std::setw( SIZE_BYTES ) << std::hex << size;
-
-				//std::string str_type = type_temp.str();
-				//std::string str_code = code_temp.str();
-				//std::string str_size = size_temp.str();
+			int32_t head_mode = connect_info->m_head_mode;
+			if( size <= m_max_data_length_c && size <= GetHeadSizeMax( head_mode ) ) {
 				//std::string log_info;
-				//FormatLibrary::StandardLibrary::FormatTo( log_info, "AddSend{0} {1} {2} {3}", str_type.c_str(), str_code.c_str(), str_size.c_str(), data.c_str() );
+				//FormatLibrary::StandardLibrary::FormatTo( log_info, "AddSend{0} {1} {2} {3}", type, code, size, data.c_str() );
 				//LogPrint( syslog_level::c_info, m_log_cate, log_info );
 
+				std::string* send_data = &data;
+				int32_t send_flag = 0;
+				thread_local std::string send_packed; // ̸߳ѹ棬ڼǰѹ
+				if( connect_info->m_compress_codec != NW_COMPRESS_NONE && HEAD_MODE_BINARY == head_mode && size >= connect_info->m_compress_threshold && code != NW_MSG_CODE_ZLIB ) { // NW_MSG_CODE_ZLIB Ϊѹ
+					send_flag = CompressFrame( connect_info->m_compress_codec, connect_info->m_compress_dict, data, send_packed );
+					if( send_flag != 0 ) {
+						send_data = &send_packed;
+					}
+				}
+
 				m_writing_vector_lock.lock();
 				try {
 					bool sender_is_full = false;
@@ -676,6 +943,7 @@ namespace basicx {
 							else { // ƻ
 								sender_is_full = true;
 								connect_info->m_stat_lost_msg++;
+								connect_info->m_stat_drop_msgs.fetch_add( 1, std::memory_order_relaxed );
 								result = -1;
 							}
 						}
@@ -683,13 +951,14 @@ namespace basicx {
 					}
 					if( false == sender_is_full ) {
 						if( m_sender_vector_write->m_count < m_sender_vector_write->m_vec_send_buf_info.size() ) { // ʹþԪ
-							m_sender_vector_write->m_vec_send_buf_info[m_sender_vector_write->m_count]->Update( connect_info, size, type_temp, code_temp, size_temp, data );
+							m_sender_vector_write->m_vec_send_buf_info[m_sender_vector_write->m_count]->Update( connect_info, head_mode, type, code, *send_data, send_flag );
 							m_sender_vector_write->m_count++; // Ժ
 						}
 						else { // ʹ½Ԫ
-							m_sender_vector_write->m_vec_send_buf_info.push_back( new SendBufInfo( connect_info, size, type_temp, code_temp, size_temp, data ) );
+							m_sender_vector_write->m_vec_send_buf_info.push_back( new SendBufInfo( connect_info, head_mode, type, code, *send_data, send_flag ) );
 							m_sender_vector_write->m_count++; // Ժ
 						}
+						connect_info->m_stat_send_queue.fetch_add( 1, std::memory_order_relaxed );
 						m_sender_condition.notify_all(); //
 					}
 				}
@@ -708,7 +977,7 @@ namespace basicx {
 			}
 			else {
 				std::string log_info;
-				FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  Data Ϣ {0} > {1}", size, m_max_data_length_c );
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  Data Ϣ {0} > {1}", size, std::min( m_max_data_length_c, GetHeadSizeMax( head_mode ) ) );
 				LogPrint( syslog_level::c_warn, m_log_cate, log_info );
 				result = -3;
 			}
@@ -721,28 +990,147 @@ namespace basicx {
 		return result;
 	}
 
+	int32_t NetClient_P::Client_SendRequest( ConnectInfo* connect_info, int32_t code, std::string& data, int32_t time_out_ms, NetClientAnswer answer ) {
+		if( nullptr == connect_info || false == connect_info->m_available ) {
+			return -4;
+		}
+
+		uint64_t request_id = ++m_request_id;
+		std::string request( REQUEST_ID_BYTES + data.length(), '\0' );
+		EncodeRequestId( &request[0], request_id );
+		memcpy( &request[REQUEST_ID_BYTES], data.c_str(), data.length() );
+
+		// ȵǼٷͣӦڵǼǵ
+		m_pending_request_lock.lock();
+		PendingRequest& pending_request = m_map_pending_request[request_id];
+		pending_request.m_identity = connect_info->m_identity;
+		pending_request.m_answer = answer;
+		m_pending_request_lock.unlock();
+
+		int32_t result = Client_SendData( connect_info, NW_MSG_TYPE_REQUEST, code, request );
+		if( result != 0 ) {
+			m_pending_request_lock.lock();
+			m_map_pending_request.erase( request_id );
+			m_pending_request_lock.unlock();
+			return result;
+		}
+
+		if( time_out_ms > 0 ) {
+			m_request_wheel->Schedule( request_id, GetSteadyTimeMs() + time_out_ms );
+		}
+		return result;
+	}
+
+	std::future<NetClientReply> NetClient_P::Client_SendRequest( ConnectInfo* connect_info, int32_t code, std::string& data, int32_t time_out_ms ) {
+		std::shared_ptr<std::promise<NetClientReply>> promise = std::make_shared<std::promise<NetClientReply>>();
+		std::future<NetClientReply> future = promise->get_future();
+
+		int32_t result = Client_SendRequest( connect_info, code, data, time_out_ms, [promise]( int32_t result, NetClientView* net_client_view ) {
+			NetClientReply reply;
+			reply.m_result = result;
+			reply.m_code = 0;
+			if( net_client_view != nullptr ) {
+				reply.m_code = net_client_view->m_code;
+				reply.m_data.assign( net_client_view->m_data, net_client_view->m_size );
+			}
+			promise->set_value( reply );
+		} );
+
+		if( result != 0 ) {
+			NetClientReply reply;
+			reply.m_result = REQUEST_RESULT_SEND_FAILED;
+			reply.m_code = 0;
+			promise->set_value( reply );
+		}
+		return future;
+	}
+
+	void NetClient_P::Client_HandleAnswer( ConnectInfo* connect_info, int32_t code, int32_t size ) {
+		uint64_t request_id = DecodeRequestId( connect_info->m_recv_buf_data );
+
+		NetClientAnswer answer;
+		m_pending_request_lock.lock();
+		auto it_pr = m_map_pending_request.find( request_id );
+		if( it_pr != m_map_pending_request.end() ) {
+			answer.swap( it_pr->second.m_answer );
+			m_map_pending_request.erase( it_pr );
+		}
+		m_pending_request_lock.unlock();
+
+		if( !answer ) { // ѳʱ
+			if( 1 == m_log_test ) {
+				std::string log_info;
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  ڵӦ{0}", request_id );
+				LogPrint( syslog_level::c_warn, m_log_cate, log_info );
+			}
+			return;
+		}
+
+		try {
+			NetClientView net_client_view; // ֱָջ
+			net_client_view.m_node_type = connect_info->m_node_type_intern;
+			net_client_view.m_identity = connect_info->m_identity;
+			net_client_view.m_code = code;
+			net_client_view.m_data = connect_info->m_recv_buf_data + REQUEST_ID_BYTES;
+			net_client_view.m_size = size - REQUEST_ID_BYTES;
+			net_client_view.m_data_owner = &connect_info->m_recv_buf_share;
+			answer( REQUEST_RESULT_SUCCESS, &net_client_view );
+		}
+		catch( ... ) {
+			std::string log_info;
+			log_info = "ͻ  Ӧ ص δ֪";
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+		}
+	}
+
+	void NetClient_P::Client_FinishRequest( uint64_t request_id, int32_t result ) {
+		NetClientAnswer answer;
+		m_pending_request_lock.lock();
+		auto it_pr = m_map_pending_request.find( request_id );
+		if( it_pr != m_map_pending_request.end() ) {
+			answer.swap( it_pr->second.m_answer );
+			m_map_pending_request.erase( it_pr );
+		}
+		m_pending_request_lock.unlock();
+
+		if( answer ) { // ӦĲڱ
+			try {
+				answer( result, nullptr );
+			}
+			catch( ... ) {
+				std::string log_info;
+				log_info = "ͻ  Ӧ ص δ֪";
+				LogPrint( syslog_level::c_error, m_log_cate, log_info );
+			}
+		}
+	}
+
+	void NetClient_P::Client_FailRequest( int32_t identity ) {
+		std::vector<uint64_t> vec_request_id;
+		m_pending_request_lock.lock();
+		for( auto it_pr = m_map_pending_request.begin(); it_pr != m_map_pending_request.end(); it_pr++ ) {
+			if( it_pr->second.m_identity == identity ) {
+				vec_request_id.push_back( it_pr->first );
+			}
+		}
+		m_pending_request_lock.unlock();
+
+		for( size_t i = 0; i < vec_request_id.size(); i++ ) {
+			Client_FinishRequest( vec_request_id[i], REQUEST_RESULT_CLOSED );
+		}
+	}
+
+	size_t NetClient_P::Client_GetRequestCount() {
+		std::lock_guard<std::mutex> lock( m_pending_request_lock );
+		return m_map_pending_request.size();
+	}
+
 	void NetClient_P::Client_HandleSendMsgs() {
 		while( true == m_sender_running ) {
 			m_sender_condition.wait( m_unique_lock );
 			for( ; m_sender_vector_read->m_handled < m_sender_vector_read->m_count; ) {
 				m_sender_vector_read->m_handled++;
-				SendBufInfo* send_buf_info = m_sender_vector_read->m_vec_send_buf_info[m_sender_vector_read->m_handled - 1];
-				try {
-					if( send_buf_info->m_connect_info != nullptr && send_buf_info->m_connect_info->m_available != false ) { // 룡ȻѶϿȥݣȡ˻ᷢѶϿ
-						boost::asio::async_write( *(send_buf_info->m_connect_info->m_socket), boost::asio::buffer( send_buf_info->m_send_buf ), boost::bind( &NetClient_P::Client_HandleSendData, this, boost::asio::placeholders::error, send_buf_info ) );
-					}
-				}
-				catch( std::exception& ex ) {
-					std::string log_info;
-					Client_CloseOnError( send_buf_info->m_connect_info );
-					if( 1 == m_log_test ) {
-						FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  Msgs  쳣{0}", ex.what() );
-					}
-					else {
-						log_info = "ͻ  Msgs  쳣";
-					}
-					LogPrint( syslog_level::c_error, m_log_cate, log_info );
-				}
+				Client_HandleSendBuf( m_sender_vector_read->m_vec_send_buf_info[m_sender_vector_read->m_handled - 1] );
 			}
 			while( m_sender_vector_read->m_handled == m_sender_vector_read->m_capacity ) { // 軻У capacity ſǸ
 				bool changed = false;
@@ -757,23 +1145,7 @@ namespace basicx {
 				if( true == changed ) { // ѻ¶
 					for( ; m_sender_vector_read->m_handled < m_sender_vector_read->m_count; ) {
 						m_sender_vector_read->m_handled++;
-						SendBufInfo* send_buf_info = m_sender_vector_read->m_vec_send_buf_info[m_sender_vector_read->m_handled - 1];
-						try {
-							if( send_buf_info->m_connect_info != nullptr && send_buf_info->m_connect_info->m_available != false ) { // 룡ȻѶϿȥݣȡ˻ᷢѶϿ
-								boost::asio::async_write( *(send_buf_info->m_connect_info->m_socket), boost::asio::buffer( send_buf_info->m_send_buf ), boost::bind( &NetClient_P::Client_HandleSendData, this, boost::asio::placeholders::error, send_buf_info ) );
-							}
-						}
-						catch( std::exception& ex ) {
-							std::string log_info;
-							Client_CloseOnError( send_buf_info->m_connect_info );
-							if( 1 == m_log_test ) {
-								FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  Msgs  쳣{0}", ex.what() );
-							}
-							else {
-								log_info = "ͻ  Msgs  쳣";
-							}
-							LogPrint( syslog_level::c_error, m_log_cate, log_info );
-						}
+						Client_HandleSendBuf( m_sender_vector_read->m_vec_send_buf_info[m_sender_vector_read->m_handled - 1] );
 					}
 				}
 				// ڴϢУдְ߳̿ѶдˣԲǷл
@@ -781,28 +1153,108 @@ namespace basicx {
 		}
 	}
 
-	void NetClient_P::Client_HandleSendData( const boost::system::error_code& error, SendBufInfo* send_buf_info ) {
-		if( !error ) {
-			try {
-				if( 1 == m_log_test ) {
-					int32_t type( 0 );
-					std::istringstream type_temp( std::string( send_buf_info->m_send_buf, 0, TYPE_BYTES ) );
-					type_temp >> std::hex >> type;
-					int32_t code( 0 );
-					std::istringstream code_temp( std::string( send_buf_info->m_send_buf, TYPE_BYTES, CODE_BYTES ) );
-					code_temp >> std::hex >> code;
-					int32_t size( 0 );
-					std::istringstream size_temp( std::string( send_buf_info->m_send_buf, FLAG_BYTES, SIZE_BYTES ) );
-					size_temp >> std::hex >> size;
-					std::string data( send_buf_info->m_send_buf, HEAD_BYTES, size );
-					std::string log_info;
-					FormatLibrary::StandardLibrary::FormatTo( log_info, "-->[{0}]Type:{1} Code:{2} Size:{3} Data:{4}", send_buf_info->m_connect_info->m_endpoint_r, type, code, size, data.length() );
-					LogPrint( syslog_level::c_info, m_log_cate, log_info );
-				}
+	void NetClient_P::Client_HandleSendBuf( SendBufInfo* slot_buf_info ) { // ݻӵĴУλ漴ɱд̸߳
+		ConnectInfo* connect_info = slot_buf_info->m_connect_info;
+		if( nullptr == connect_info ) {
+			return;
+		}
+		if( false == connect_info->m_available ) { // 룡ȻѶϿȥݣȡ˻ᷢѶϿ
+			connect_info->m_stat_send_queue.fetch_sub( 1, std::memory_order_relaxed );
+			return;
+		}
+
+		SendBufInfo* send_buf_info = nullptr;
+		m_send_pool_lock.lock();
+		if( !m_vec_send_pool.empty() ) {
+			send_buf_info = m_vec_send_pool.back();
+			m_vec_send_pool.pop_back();
+		}
+		m_send_pool_lock.unlock();
+		if( nullptr == send_buf_info ) {
+			send_buf_info = new SendBufInfo();
+		}
+		send_buf_info->SwapData( *slot_buf_info );
+
+		bool need_write = false;
+		SendBufInfo* drop_buf_info = nullptr;
+		connect_info->m_send_buf_lock.lock();
+		int32_t push_result = PushSendPending( connect_info, send_buf_info, drop_buf_info );
+		if( push_result >= 0 && false == connect_info->m_send_writing ) { // ûз;𣬷;ɺϲ
+			connect_info->m_send_writing = true;
+			need_write = true;
+		}
+		connect_info->m_send_buf_lock.unlock();
+		if( 2 == push_result ) { // ͬϢ滻㶪ʧ
+			connect_info->m_stat_conflate_msgs.fetch_add( 1, std::memory_order_relaxed );
+			Client_ReleaseSendBuf( drop_buf_info );
+		}
+		else if( drop_buf_info != nullptr ) { // ֻӵϢ߳
+			connect_info->m_stat_lost_msg++;
+			connect_info->m_stat_drop_msgs.fetch_add( 1, std::memory_order_relaxed );
+			Client_ReleaseSendBuf( drop_buf_info );
+		}
+		if( -2 == push_result ) {
+			Client_CloseBacklog( connect_info );
+		}
+		if( true == need_write ) {
+			Client_WriteSendBufs( connect_info );
+		}
+	}
+
+	void NetClient_P::Client_WriteSendBufs( ConnectInfo* connect_info ) { // ǰ m_send_writing 
+		try {
+			connect_info->m_send_buf_lock.lock();
+			connect_info->m_vec_send_writing.swap( connect_info->m_vec_send_pending ); // m_vec_send_writing ʱΪ
+			connect_info->m_map_send_conflate.clear(); // ;Ĳٺϲ
+			connect_info->m_send_buf_lock.unlock();
+			connect_info->m_send_backlog_time.store( connect_info->m_vec_send_writing[0]->m_enqueue_time, std::memory_order_relaxed ); // зǿղŻᷢ
+			connect_info->m_vec_send_buffers.clear();
+			for( size_t i = 0; i < connect_info->m_vec_send_writing.size(); i++ ) {
+				connect_info->m_vec_send_buffers.push_back( boost::asio::buffer( connect_info->m_vec_send_writing[i]->GetSendBuf() ) );
+			}
+			boost::asio::async_write( *(connect_info->m_socket), connect_info->m_vec_send_buffers, boost::bind( &NetClient_P::Client_HandleSendData, this, boost::asio::placeholders::error, connect_info ) );
+		}
+		catch( std::exception& ex ) {
+			std::string log_info;
+			Client_CloseOnError( connect_info );
+			if( 1 == m_log_test ) {
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  Msgs  쳣{0}", ex.what() );
+			}
+			else {
+				log_info = "ͻ  Msgs  쳣";
+			}
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+			Client_HandleSendData( boost::asio::error::operation_aborted, connect_info ); // 黹沢λͱ
+		}
+	}
+
+	void NetClient_P::Client_HandleSendData( const boost::system::error_code& error, ConnectInfo* connect_info ) {
+		if( !error ) {
+			try {
+				connect_info->m_send_time.store( GetSteadyTimeMs(), std::memory_order_relaxed );
+				int64_t now_time = GetSteadyTimeUs();
+				uint64_t send_bytes = 0;
+				for( size_t i = 0; i < connect_info->m_vec_send_writing.size(); i++ ) {
+					SendBufInfo* send_buf_info = connect_info->m_vec_send_writing[i];
+					send_bytes += send_buf_info->GetSendBuf().length();
+					m_stat_send_latency.Record( now_time - send_buf_info->m_enqueue_time );
+				}
+				connect_info->m_stat_send_bytes.fetch_add( send_bytes, std::memory_order_relaxed );
+				connect_info->m_stat_send_msgs.fetch_add( connect_info->m_vec_send_writing.size(), std::memory_order_relaxed );
+				if( 1 == m_log_test ) {
+					for( size_t i = 0; i < connect_info->m_vec_send_writing.size(); i++ ) {
+						SendBufInfo* send_buf_info = connect_info->m_vec_send_writing[i];
+						FrameHead frame_head;
+						DecodeHead( send_buf_info->GetSendBuf().c_str(), frame_head );
+						std::string log_info;
+						FormatLibrary::StandardLibrary::FormatTo( log_info, "-->[{0}]Type:{1} Code:{2} Size:{3} Data:{4}", connect_info->m_endpoint_r, frame_head.m_type, frame_head.m_code, frame_head.m_size, send_buf_info->m_send_size );
+						LogPrint( syslog_level::c_info, m_log_cate, log_info );
+					}
+				}
 			}
 			catch( std::exception& ex ) {
 				std::string log_info;
-				Client_CloseOnError( send_buf_info->m_connect_info );
+				Client_CloseOnError( connect_info );
 				if( 1 == m_log_test ) {
 					FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  Data  쳣{0}", ex.what() );
 				}
@@ -812,9 +1264,9 @@ namespace basicx {
 				LogPrint( syslog_level::c_error, m_log_cate, log_info );
 			}
 		}
-		else {
+		else if( error != boost::asio::error::operation_aborted ) {
 			std::string log_info;
-			Client_CloseOnError( send_buf_info->m_connect_info );
+			Client_CloseOnError( connect_info );
 			if( 1 == m_log_test ) {
 				FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  Data  {0}", error.message().c_str() );
 			}
@@ -823,6 +1275,52 @@ namespace basicx {
 			}
 			LogPrint( syslog_level::c_error, m_log_cate, log_info );
 		}
+
+		for( size_t i = 0; i < connect_info->m_vec_send_writing.size(); i++ ) {
+			Client_ReleaseSendBuf( connect_info->m_vec_send_writing[i] );
+		}
+		connect_info->m_vec_send_writing.clear();
+
+		bool need_write = false;
+		connect_info->m_send_buf_lock.lock();
+		if( connect_info->m_vec_send_pending.empty() ) {
+			connect_info->m_send_writing = false;
+			connect_info->m_send_backlog_time.store( 0, std::memory_order_relaxed );
+		}
+		else if( !error && connect_info->m_available != false ) { // ;ڼܵϢϲΪһη
+			need_write = true;
+		}
+		else { // ѶϿܵϢֱӹ黹
+			for( size_t i = 0; i < connect_info->m_vec_send_pending.size(); i++ ) {
+				Client_ReleaseSendBuf( connect_info->m_vec_send_pending[i] );
+			}
+			connect_info->m_vec_send_pending.clear();
+			connect_info->m_map_send_conflate.clear();
+			connect_info->m_send_writing = false;
+			connect_info->m_send_backlog_time.store( 0, std::memory_order_relaxed );
+		}
+		connect_info->m_send_buf_lock.unlock();
+		if( true == need_write ) {
+			Client_WriteSendBufs( connect_info );
+		}
+	}
+
+	void NetClient_P::Client_ReleaseSendBuf( SendBufInfo* send_buf_info ) { // дӶϿڴ˳
+		send_buf_info->m_connect_info->m_stat_send_queue.fetch_sub( 1, std::memory_order_relaxed );
+		send_buf_info->m_send_frame.reset();
+		m_send_pool_lock.lock();
+		m_vec_send_pool.push_back( send_buf_info );
+		m_send_pool_lock.unlock();
+	}
+
+	void NetClient_P::Client_CloseBacklog( ConnectInfo* connect_info ) { // ߳ⶼܵãֻرһ
+		bool active_close = false;
+		if( true == connect_info->m_active_close.compare_exchange_strong( active_close, true ) ) {
+			std::string log_info;
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  ͻѹϿ[{0}]->[{1}]{2} {3}", connect_info->m_endpoint_l, connect_info->m_endpoint_r, connect_info->m_identity, connect_info->m_stat_send_queue.load() );
+			LogPrint( syslog_level::c_warn, m_log_cate, log_info );
+			Client_Close( connect_info );
+		}
 	}
 
 	//int32_t NetClient_P::Client_SendData( ConnectInfo* connect_info, int32_t type, int32_t code, std::string& data ) {
@@ -990,6 +1488,7 @@ namespace basicx {
 				if( (*it_ci)->m_identity == connect_info->m_identity ) {
 					m_list_remote_info.erase( it_ci );
 					m_total_remote_connect = m_list_remote_info.size(); //
+					m_stat_closed.Merge( connect_info );
 					break;
 				}
 			}
@@ -999,8 +1498,7 @@ namespace basicx {
 			m_remote_info_index_lock.unlock();
 
 			// ԶϢ
-			std::string server_endpoint;
-			FormatLibrary::StandardLibrary::FormatTo( server_endpoint, "tcp://{0}:{1}", connect_info->m_adress_r, connect_info->m_port_r );
+			std::string server_endpoint = Client_GetServerEndpoint( connect_info->m_adress_r, connect_info->m_port_r );
 			m_server_info_lock.lock();
 			auto it_si = m_map_server_info.find( server_endpoint );
 			if( it_si != m_map_server_info.end() ) {
@@ -1015,6 +1513,8 @@ namespace basicx {
 			FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  رӡ[{0}]->[{1}]", connect_info->m_endpoint_l, connect_info->m_endpoint_r );
 			LogPrint( syslog_level::c_warn, m_log_cate, log_info );
 
+			Client_FailRequest( connect_info->m_identity );
+
 			if( nullptr != m_net_client_x ) {
 				NetClientInfo net_client_info( WM_MY_DISCONNECT_REMOTE, connect_info->m_node_type, connect_info->m_identity, connect_info->m_endpoint_l, connect_info->m_endpoint_r ); // ͨģյ˶Ͽ
 				m_net_client_x->OnNetClientInfo( net_client_info );
@@ -1022,28 +1522,7 @@ namespace basicx {
 
 			// ͻӱرʱԶ
 			if( true == m_auto_reconnect_client ) {
-				ReconnectInfo reconnect_info;
-				reconnect_info.m_identity = connect_info->m_identity;
-				reconnect_info.m_address = connect_info->m_adress_r;
-				reconnect_info.m_port = connect_info->m_port_r;
-				reconnect_info.m_node_type = connect_info->m_node_type;
-				reconnect_info.m_reconnect_count = 0;
-				bool in_reconnect_list = false;
-				m_reconnect_info_lock.lock();
-				for( auto it_ri = m_list_reconnect_info.begin(); it_ri != m_list_reconnect_info.end(); it_ri++ ) {
-					if( it_ri->m_identity == connect_info->m_identity ) {
-						in_reconnect_list = true; // ӶϿʱα
-						break;
-					}
-				}
-				if( false == in_reconnect_list ) {
-					m_list_reconnect_info.push_back( reconnect_info );
-				}
-				m_reconnect_info_lock.unlock();
-				if( false == in_reconnect_list ) {
-					FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  {0}:{1}:{2} رգתУ", connect_info->m_adress_r, connect_info->m_port_r, connect_info->m_node_type );
-					LogPrint( syslog_level::c_warn, m_log_cate, log_info );
-				}
+				Client_AddReconnect( connect_info );
 			}
 
 			// Ŀǰɾ
@@ -1065,6 +1544,7 @@ namespace basicx {
 				if( (*it_ci)->m_identity == connect_info->m_identity ) {
 					m_list_remote_info.erase( it_ci );
 					m_total_remote_connect = m_list_remote_info.size(); //
+					m_stat_closed.Merge( connect_info );
 					break;
 				}
 			}
@@ -1074,8 +1554,7 @@ namespace basicx {
 			m_remote_info_index_lock.unlock();
 
 			// ԶϢ
-			std::string server_endpoint;
-			FormatLibrary::StandardLibrary::FormatTo( server_endpoint, "tcp://{0}:{1}", connect_info->m_adress_r, connect_info->m_port_r );
+			std::string server_endpoint = Client_GetServerEndpoint( connect_info->m_adress_r, connect_info->m_port_r );
 			m_server_info_lock.lock();
 			auto it_si = m_map_server_info.find( server_endpoint );
 			if( it_si != m_map_server_info.end() ) {
@@ -1090,6 +1569,8 @@ namespace basicx {
 			FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  رӡ[{0}]->[{1}]", connect_info->m_endpoint_l, connect_info->m_endpoint_r );
 			LogPrint( syslog_level::c_warn, m_log_cate, log_info );
 
+			Client_FailRequest( connect_info->m_identity );
+
 			if( nullptr != m_net_client_x ) {
 				NetClientInfo net_client_info( WM_MY_CLOSECONNECT_CLIENT, connect_info->m_node_type, connect_info->m_identity, connect_info->m_endpoint_l, connect_info->m_endpoint_r ); // ͨģͻر
 				m_net_client_x->OnNetClientInfo( net_client_info );
@@ -1140,7 +1621,11 @@ namespace basicx {
 	}
 
 	void NetClient_P::Client_Close( ConnectInfo* connect_info ) {
-		if( connect_info && connect_info->m_socket.get() ) {
+		if( connect_info && connect_info->m_shm_channel.get() ) {
+			connect_info->m_active_close = true; // 
+			connect_info->m_shm_channel->m_close_request = true; // ɹڴѯ̹߳ر
+		}
+		else if( connect_info && connect_info->m_socket.get() ) {
 			connect_info->m_active_close = true; // 
 			connect_info->m_socket->shutdown( boost::asio::ip::tcp::socket::shutdown_both, boost::system::error_code() );
 		}
@@ -1161,54 +1646,657 @@ namespace basicx {
 		}
 	}
 
-	void NetClient_P::SendHeartCheck() {
-		time_t now_time_t;
-		time( &now_time_t );
+	bool NetClient_P::Client_StartConnectShm( std::string address_r, int32_t port_r, std::string node_type_r, int32_t reconnect_identity ) {
+		std::string log_info;
+
+		try {
+			// ¼ԶϢ
+			Client_AddServerInfo( address_r, port_r, node_type_r );
+
+			ShmSegmentPtr shm_segment = std::make_shared<ShmSegment>();
+			int32_t slot_index = -1;
+			if( true == shm_segment->Open( address_r.substr( strlen( SHM_PROTOCOL ) ) ) && true == shm_segment->IsServerAlive( GetSteadyTimeMs() ) ) {
+				slot_index = Client_ClaimShmSlot( shm_segment );
+			}
+
+			if( slot_index >= 0 && reconnect_identity != 0 ) { // ߳Уȴ˽ܣɶʱ飬ʧʱٰ´
+				std::shared_ptr<ShmClaimInfo> shm_claim_info = std::make_shared<ShmClaimInfo>();
+				shm_claim_info->m_segment = shm_segment;
+				shm_claim_info->m_slot_index = slot_index;
+				shm_claim_info->m_timeout_time = GetSteadyTimeMs() + m_client_connect_timeout;
+				shm_claim_info->m_address = address_r;
+				shm_claim_info->m_port = port_r;
+				shm_claim_info->m_node_type = node_type_r;
+				shm_claim_info->m_reconnect_identity = reconnect_identity;
+				shm_claim_info->m_claim_timer = std::make_shared<boost::asio::steady_timer>( *m_service );
+				shm_claim_info->m_claim_timer->expires_from_now( std::chrono::milliseconds( 1 ) );
+				shm_claim_info->m_claim_timer->async_wait( boost::bind( &NetClient_P::Client_HandleShmClaim, this, boost::asio::placeholders::error, shm_claim_info ) );
+				return true;
+			}
+
+			if( slot_index >= 0 ) {
+				slot_index = Client_WaitShmSlot( shm_segment, slot_index );
+			}
+
+			if( slot_index >= 0 ) {
+				Client_CreateConnectShm( shm_segment, slot_index, address_r, port_r, node_type_r, reconnect_identity );
+				return true;
+			}
+
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  ڴ  {0}:{1} ʧܣδСλܳʱ", address_r, node_type_r );
+		}
+		catch( std::exception& ex ) { // ڴβʱҲڴ˴
+			if( 1 == m_log_test ) {
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  ڴ  쳣{0}", ex.what() );
+			}
+			else {
+				log_info = "ͻ  ڴ  쳣";
+			}
+		}
+		LogPrint( syslog_level::c_error, m_log_cate, log_info );
+
+		if( reconnect_identity != 0 ) {
+			Client_ReconnectFailed( reconnect_identity );
+		}
+
+		return false;
+	}
+
+	void NetClient_P::Client_CreateConnectShm( ShmSegmentPtr shm_segment, int32_t slot_index, std::string address_r, int32_t port_r, std::string node_type_r, int32_t reconnect_identity ) {
+		std::string log_info;
+
+		ConnectInfo* connect_info = new ConnectInfo();
+		connect_info->m_shm_channel = std::make_shared<ShmChannel>( shm_segment, slot_index, false );
+		connect_info->m_node_type = node_type_r; //
+		connect_info->m_reconnect_identity = reconnect_identity;
+		connect_info->m_identity = Client_GetIdentity();
+		connect_info->m_available = true;
+		time( &connect_info->m_heart_check_time );
+		connect_info->m_active_close = false;
+		connect_info->m_send_time = GetSteadyTimeMs();
+		connect_info->m_recv_time = connect_info->m_send_time.load();
+		connect_info->m_head_mode = HEAD_MODE_BINARY; // й̶ʹöưͷЭ
+
+		connect_info->m_protocol_r = "shm";
+		connect_info->m_adress_r = address_r;
+		connect_info->m_port_r = port_r;
+		FormatLibrary::StandardLibrary::FormatTo( connect_info->m_str_port_r, "{0}", connect_info->m_port_r );
+		connect_info->m_endpoint_r = address_r; // ӱ"shm://name"
+
+		connect_info->m_protocol_l = "shm";
+		connect_info->m_adress_l = address_r;
+		connect_info->m_port_l = slot_index;
+		FormatLibrary::StandardLibrary::FormatTo( connect_info->m_str_port_l, "{0}", connect_info->m_port_l );
+		connect_info->m_endpoint_l = address_r + "#" + connect_info->m_str_port_l; // ӱ"shm://name#3"һ
+
+		connect_info->m_node_type_intern = InternNodeType( connect_info->m_node_type );
+
+		connect_info->m_recv_buf_head = nullptr;
+		connect_info->m_recv_buf_share = MakeRecvBuf( 1024 );
+		connect_info->m_recv_buf_data = connect_info->m_recv_buf_share.get();
+		connect_info->m_recv_buf_data_size = 1024;
+
+		Client_InitCompress( connect_info ); // ڴӲѹ
+		Client_InitSendQueue( connect_info );
+
+		connect_info->ResetStat();
+
+		connect_info->m_send_writing = false;
+		connect_info->m_send_backlog_time = 0;
+		connect_info->m_send_pending_base = 0;
+
 		m_remote_info_lock.lock();
-		std::list<ConnectInfo*> list_remote_info = m_list_remote_info;
+		m_list_remote_info.push_back( connect_info );
+		m_total_remote_connect = m_list_remote_info.size(); //
 		m_remote_info_lock.unlock();
+		m_remote_info_index_lock.lock();
+		m_map_remote_info_index.insert( std::pair<int32_t, ConnectInfo*>( connect_info->m_identity, connect_info ) );
+		m_remote_info_index_lock.unlock();
 
-		for( auto it_ci = list_remote_info.begin(); it_ci != list_remote_info.end(); it_ci++ ) {
-			if( difftime( now_time_t, (*it_ci)->m_heart_check_time ) >= m_heart_check_time ) { // m_heart_check_time û͹
-				Client_SendData( *it_ci, NW_MSG_TYPE_HEART_CHECK, NW_MSG_CODE_NONE, std::string( "" ) );
+		FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ ӣ[{0}]->[{1}]{2}", connect_info->m_endpoint_l, connect_info->m_endpoint_r, connect_info->m_identity );
+		LogPrint( syslog_level::c_info, m_log_cate, log_info );
+
+		m_heart_wheel->Schedule( connect_info->m_identity, Client_GetCheckTime( connect_info ) );
+
+		// ԶϢ
+		m_server_info_lock.lock();
+		auto it_si = m_map_server_info.find( address_r );
+		if( it_si != m_map_server_info.end() ) {
+			it_si->second->m_connect_number++;
+		}
+		m_server_info_lock.unlock();
+
+		Client_ReconnectSucceed( connect_info );
+
+		// ֮ѯ߳̽ݲر
+		m_shm_connect_lock.lock();
+		m_vec_shm_connect.push_back( connect_info );
+		if( false == m_shm_running ) {
+			m_shm_running = true;
+			m_shm_thread = std::thread( &NetClient_P::Thread_ClientShm, this );
+		}
+		m_shm_connect_lock.unlock();
+
+		if( nullptr != m_net_client_x ) {
+			NetClientInfo net_client_info( WM_MY_NEWCONNECT_REMOTE, connect_info->m_node_type, connect_info->m_identity, connect_info->m_endpoint_l, connect_info->m_endpoint_r ); // ͨģ鷢µ
+			m_net_client_x->OnNetClientInfo( net_client_info );
+		}
+	}
+
+	int32_t NetClient_P::Client_ClaimShmSlot( ShmSegmentPtr shm_segment ) {
+		ShmSlot* shm_slot = nullptr;
+		uint32_t slot_number = shm_segment->GetHead()->m_slot_number;
+		for( uint32_t i = 0; i < slot_number && nullptr == shm_slot; i++ ) {
+			uint32_t state = SHM_SLOT_FREE;
+			if( true == shm_segment->GetSlot( i )->m_state.compare_exchange_strong( state, SHM_SLOT_INIT ) ) {
+				shm_slot = shm_segment->GetSlot( i );
+				shm_slot->m_client_alive_time.store( GetSteadyTimeMs(), std::memory_order_relaxed );
+				shm_slot->m_ring_c2s.m_write_pos.store( 0, std::memory_order_relaxed );
+				shm_slot->m_ring_c2s.m_read_pos.store( 0, std::memory_order_relaxed );
+				shm_slot->m_ring_s2c.m_write_pos.store( 0, std::memory_order_relaxed );
+				shm_slot->m_ring_s2c.m_read_pos.store( 0, std::memory_order_relaxed );
+				shm_slot->m_state.store( SHM_SLOT_CLAIMED, std::memory_order_release ); // ʼɺ˲Ż
 			}
 		}
+		if( nullptr == shm_slot ) { // λ
+			return -1;
+		}
+		return (int32_t)( shm_slot - shm_segment->GetSlot( 0 ) );
+	}
+
+	int32_t NetClient_P::Client_WaitShmSlot( ShmSegmentPtr shm_segment, int32_t slot_index ) { // ֻڵ߳ʹã߳м Client_HandleShmClaim()
+		ShmSlot* shm_slot = shm_segment->GetSlot( slot_index );
+
+		// ѯ߳ͨ΢뼶ڽܣֹͣӦʱӳʱ
+		int64_t timeout_time = GetSteadyTimeMs() + m_client_connect_timeout;
+		uint32_t state = shm_slot->m_state.load( std::memory_order_acquire );
+		while( SHM_SLOT_CLAIMED == state && GetSteadyTimeMs() < timeout_time ) {
+			std::this_thread::sleep_for( std::chrono::microseconds( 50 ) );
+			state = shm_slot->m_state.load( std::memory_order_acquire );
+		}
+		if( SHM_SLOT_CONNECTED == state ) {
+			return slot_index;
+		}
+
+		Client_WithdrawShmSlot( shm_segment, slot_index );
+		return -1;
+	}
+
+	void NetClient_P::Client_HandleShmClaim( const boost::system::error_code& error, std::shared_ptr<ShmClaimInfo> shm_claim_info ) {
 		std::string log_info;
-		for( auto it_ci = list_remote_info.begin(); it_ci != list_remote_info.end(); it_ci++ ) {
-			if( (*it_ci)->m_stat_lost_msg > 0 ) {
-				FormatLibrary::StandardLibrary::FormatTo( log_info, " {0} ʧ {1} Ϣ", (*it_ci)->m_endpoint_r, (*it_ci)->m_stat_lost_msg );
-				LogPrint( syslog_level::c_warn, m_log_cate, log_info );
-				(*it_ci)->m_stat_lost_msg = 0;
+
+		ShmSlot* shm_slot = shm_claim_info->m_segment->GetSlot( shm_claim_info->m_slot_index );
+		uint32_t state = shm_slot->m_state.load( std::memory_order_acquire );
+		if( !error && SHM_SLOT_CONNECTED == state ) {
+			try {
+				Client_CreateConnectShm( shm_claim_info->m_segment, shm_claim_info->m_slot_index, shm_claim_info->m_address, shm_claim_info->m_port, shm_claim_info->m_node_type, shm_claim_info->m_reconnect_identity );
+				return;
+			}
+			catch( std::exception& ex ) {
+				if( 1 == m_log_test ) {
+					FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  ڴ  쳣{0}", ex.what() );
+				}
+				else {
+					log_info = "ͻ  ڴ  쳣";
+				}
+				LogPrint( syslog_level::c_error, m_log_cate, log_info );
+			}
+		}
+		else if( !error && SHM_SLOT_CLAIMED == state && GetSteadyTimeMs() < shm_claim_info->m_timeout_time ) { // δҲδʱԺٲ
+			shm_claim_info->m_claim_timer->expires_from_now( std::chrono::milliseconds( 1 ) );
+			shm_claim_info->m_claim_timer->async_wait( boost::bind( &NetClient_P::Client_HandleShmClaim, this, boost::asio::placeholders::error, shm_claim_info ) );
+			return;
+		}
+		else {
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  ڴ  {0}:{1} ʧܣδСλܳʱ", shm_claim_info->m_address, shm_claim_info->m_node_type );
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+		}
+
+		Client_WithdrawShmSlot( shm_claim_info->m_segment, shm_claim_info->m_slot_index );
+		if( error != boost::asio::error::operation_aborted ) { // ֹͣʱ
+			Client_ReconnectFailed( shm_claim_info->m_reconnect_identity );
+		}
+	}
+
+	void NetClient_P::Client_WithdrawShmSlot( ShmSegmentPtr shm_segment, int32_t slot_index ) {
+		ShmSlot* shm_slot = shm_segment->GetSlot( slot_index );
+
+		// ʱ򳷻أǡͬʱ֪ͨ˹رգܾͷŲλ
+		uint32_t state = SHM_SLOT_CLAIMED;
+		if( false == shm_slot->m_state.compare_exchange_strong( state, SHM_SLOT_FREE ) ) {
+			state = SHM_SLOT_CONNECTED;
+			if( false == shm_slot->m_state.compare_exchange_strong( state, SHM_SLOT_CLIENT_CLOSED ) ) {
+				state = SHM_SLOT_SERVER_CLOSED;
+				shm_slot->m_state.compare_exchange_strong( state, SHM_SLOT_FREE );
+			}
+		}
+	}
+
+	void NetClient_P::Thread_ClientShm() {
+		std::string log_info = "ͻ ڴѯ߳ ";
+		LogPrint( syslog_level::c_info, m_log_cate, log_info );
+
+		ShmIdleWait idle_wait;
+		int64_t alive_time = 0;
+		std::vector<ConnectInfo*> vec_shm_connect;
+		while( true == m_shm_running ) {
+			m_shm_connect_lock.lock();
+			vec_shm_connect = m_vec_shm_connect; // ʱٷ
+			m_shm_connect_lock.unlock();
+
+			int64_t now_time = GetSteadyTimeMs();
+			bool update_alive = now_time - alive_time >= SHM_ALIVE_INTERVAL;
+			bool is_busy = false;
+			for( size_t i = 0; i < vec_shm_connect.size(); i++ ) {
+				if( true == Client_PollShm( vec_shm_connect[i], now_time, update_alive ) ) {
+					is_busy = true;
+				}
+			}
+			if( true == update_alive ) {
+				alive_time = now_time;
+			}
+
+			if( true == is_busy ) {
+				idle_wait.Reset();
+			}
+			else {
+				idle_wait.Wait();
+			}
+		}
+
+		log_info = "ͻ ڴѯ߳ ˳";
+		LogPrint( syslog_level::c_warn, m_log_cate, log_info );
+	}
+
+	bool NetClient_P::Client_PollShm( ConnectInfo* connect_info, int64_t now_time, bool update_alive ) {
+		ShmChannel* shm_channel = connect_info->m_shm_channel.get();
+		ShmSlot* shm_slot = shm_channel->m_slot;
+		if( true == update_alive ) {
+			shm_slot->m_client_alive_time.store( now_time, std::memory_order_relaxed );
+		}
+
+		uint32_t state = shm_slot->m_state.load( std::memory_order_acquire );
+		bool server_dead = false == shm_channel->m_segment->IsServerAlive( now_time );
+		if( true == connect_info->m_available && false == shm_channel->m_close_request && SHM_SLOT_CONNECTED == state && false == server_dead ) {
+			return Client_RecvShm( connect_info );
+		}
+
+		// ֹͣд벢λ TCP ͬĹرմرʱת
+		shm_channel->Close( false, server_dead );
+		m_shm_connect_lock.lock();
+		for( auto it_ci = m_vec_shm_connect.begin(); it_ci != m_vec_shm_connect.end(); it_ci++ ) {
+			if( (*it_ci) == connect_info ) {
+				m_vec_shm_connect.erase( it_ci );
+				break;
+			}
+		}
+		m_shm_connect_lock.unlock();
+		if( true == connect_info->m_available ) {
+			Client_CloseOnError( connect_info );
+		}
+		return true;
+	}
+
+	bool NetClient_P::Client_RecvShm( ConnectInfo* connect_info ) {
+		ShmChannel* shm_channel = connect_info->m_shm_channel.get();
+		int32_t recv_number = 0;
+		try {
+			uint64_t record_size = 0;
+			const char* record = nullptr;
+			while( recv_number < SHM_RECV_BATCH && ( record = shm_channel->Peek( record_size ) ) != nullptr ) {
+				FrameHead frame_head = FrameHead();
+				bool head_valid = record_size >= HEAD_BYTES && record_size <= shm_channel->GetFrameSizeMax() && true == DecodeHead( record, frame_head );
+				int32_t type = frame_head.m_type;
+				int32_t code = frame_head.m_code;
+				size_t size = frame_head.m_size;
+
+				if( false == head_valid || HEAD_BYTES + size != record_size || type < NW_MSG_ATOM_TYPE_MIN || type > NW_MSG_USER_TYPE_MAX || code < NW_MSG_CODE_TYPE_MIN || code > NW_MSG_CODE_TYPE_MAX || size > m_max_data_length_c ) {
+					std::string log_info;
+					Client_CloseOnError( connect_info );
+					FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ յ 쳣Ĺڴݰ{0} Type:{1} Code:{2} Size:{3}", record_size, type, code, size );
+					LogPrint( syslog_level::c_error, m_log_cate, log_info );
+					break;
+				}
+
+				if( 1 == m_log_test ) {
+					std::string log_info;
+					FormatLibrary::StandardLibrary::FormatTo( log_info, "<--[{0}]Type:{1} Code:{2} Size:{3}", connect_info->m_endpoint_r, type, code, size );
+					LogPrint( syslog_level::c_info, m_log_cate, log_info );
+				}
+
+				// Ƶջλռ䣬صԿ TCP һȡȨ
+				if( size > connect_info->m_recv_buf_data_size || connect_info->m_recv_buf_share.use_count() > 1 ) {
+					size_t recv_buf_size = size > connect_info->m_recv_buf_data_size ? size : connect_info->m_recv_buf_data_size;
+					connect_info->m_recv_buf_share = MakeRecvBuf( recv_buf_size );
+					connect_info->m_recv_buf_data = connect_info->m_recv_buf_share.get();
+					connect_info->m_recv_buf_data_size = recv_buf_size;
+				}
+				memcpy( connect_info->m_recv_buf_data, record + HEAD_BYTES, size );
+				shm_channel->Pop( record_size );
+				recv_number++;
+				connect_info->m_stat_recv_bytes.fetch_add( record_size, std::memory_order_relaxed );
+				connect_info->m_stat_recv_msgs.fetch_add( 1, std::memory_order_relaxed );
+
+				if( size > 0 ) { // Ϊ
+					if( false == Client_HandleRecvFrame( connect_info, type, code, frame_head.m_flag, (int32_t)size ) || false == connect_info->m_available ) {
+						break; // ѹر
+					}
+				}
+			}
+			if( recv_number > 0 ) {
+				connect_info->m_recv_time.store( GetSteadyTimeMs(), std::memory_order_relaxed );
+			}
+		}
+		catch( std::exception& ex ) {
+			std::string log_info;
+			Client_CloseOnError( connect_info );
+			if( 1 == m_log_test ) {
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  ڴ  쳣{0}", ex.what() );
+			}
+			else {
+				log_info = "ͻ  ڴ  쳣";
+			}
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+		}
+		return recv_number > 0;
+	}
+
+	int32_t NetClient_P::Client_SendShm( ConnectInfo* connect_info, int32_t type, int32_t code, std::string& data ) {
+		int32_t result = -3;
+		if( data.length() <= m_max_data_length_c ) {
+			result = connect_info->m_shm_channel->Write( type, code, data );
+		}
+		if( 0 == result ) {
+			connect_info->m_send_time.store( GetSteadyTimeMs(), std::memory_order_relaxed );
+			connect_info->m_stat_send_bytes.fetch_add( HEAD_BYTES + data.length(), std::memory_order_relaxed );
+			connect_info->m_stat_send_msgs.fetch_add( 1, std::memory_order_relaxed );
+		}
+		else if( -1 == result ) { // ԶѸ
+			connect_info->m_stat_lost_msg++;
+			connect_info->m_stat_drop_msgs.fetch_add( 1, std::memory_order_relaxed );
+		}
+		else if( -3 == result ) {
+			std::string log_info;
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  Data Ϣ {0} > {1}", data.length(), std::min( m_max_data_length_c, (size_t)( connect_info->m_shm_channel->GetFrameSizeMax() - HEAD_BYTES ) ) );
+			LogPrint( syslog_level::c_warn, m_log_cate, log_info );
+		}
+		return result;
+	}
+
+	void NetClient_P::Client_StartWheel() {
+		m_wheel_timer->expires_from_now( std::chrono::milliseconds( m_heart_wheel->GetTickMs() ) );
+		m_wheel_timer->async_wait( boost::bind( &NetClient_P::Client_HandleWheel, this, boost::asio::placeholders::error ) );
+	}
+
+	void NetClient_P::Client_HandleWheel( const boost::system::error_code& error ) {
+		if( boost::asio::error::operation_aborted == error ) {
+			return;
+		}
+
+		try {
+			int64_t now_time = GetSteadyTimeMs();
+			std::vector<int32_t> vec_identity; // ֻеڵ
+			m_heart_wheel->Advance( now_time, vec_identity );
+			for( size_t i = 0; i < vec_identity.size(); i++ ) {
+				Client_CheckConnect( vec_identity[i], now_time );
+			}
+
+			std::vector<uint64_t> vec_request_id; // ڵӦĻᱻ
+			m_request_wheel->Advance( now_time, vec_request_id );
+			for( size_t i = 0; i < vec_request_id.size(); i++ ) {
+				Client_FinishRequest( vec_request_id[i], REQUEST_RESULT_TIMEOUT );
+			}
+		}
+		catch( std::exception& ex ) {
+			std::string log_info;
+			if( 1 == m_log_test ) {
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  쳣{0}", ex.what() );
+			}
+			else {
+				log_info = "ͻ  쳣";
 			}
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+		}
+
+		Client_StartWheel();
+	}
+
+	void NetClient_P::Client_CheckConnect( int32_t identity, int64_t now_time ) {
+		ConnectInfo* connect_info = Client_GetConnect( identity );
+		if( nullptr == connect_info || false == connect_info->m_available ) { // ѹرգٵ
+			return;
+		}
+
+		std::string log_info;
+		if( connect_info->m_stat_lost_msg > 0 ) {
+			FormatLibrary::StandardLibrary::FormatTo( log_info, " {0} ʧ {1} Ϣ", connect_info->m_endpoint_r, connect_info->m_stat_lost_msg );
+			LogPrint( syslog_level::c_warn, m_log_cate, log_info );
+			connect_info->m_stat_lost_msg = 0;
+		}
+
+		if( m_idle_timeout_c > 0 && now_time - connect_info->m_recv_time >= m_idle_timeout_c ) {
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  гʱ[{0}]->[{1}]{2}", connect_info->m_endpoint_l, connect_info->m_endpoint_r, connect_info->m_identity );
+			LogPrint( syslog_level::c_warn, m_log_cate, log_info );
+			Client_Close( connect_info );
+			return;
+		}
+
+		int64_t backlog_time = connect_info->m_send_backlog_time.load( std::memory_order_relaxed );
+		if( connect_info->m_send_backlog_timeout > 0 && backlog_time > 0 && now_time - backlog_time / 1000 >= connect_info->m_send_backlog_timeout ) { // ûϢʱɴ˷ֻѹ
+			Client_CloseBacklog( connect_info );
+			return;
+		}
+
+		if( m_heart_check_time > 0 && now_time - connect_info->m_send_time >= m_heart_check_time * 1000 ) { // m_heart_check_time û͹
+			Client_SendData( connect_info, NW_MSG_TYPE_HEART_CHECK, NW_MSG_CODE_NONE, std::string( "" ) );
+			connect_info->m_send_time = now_time; // ʱٸ£ⷢδǰظ
+		}
+
+		m_heart_wheel->Schedule( identity, Client_GetCheckTime( connect_info ) );
+	}
+
+	int64_t NetClient_P::Client_GetCheckTime( ConnectInfo* connect_info ) { // ´ѹнһ
+		int64_t check_time = INT64_MAX;
+		if( m_heart_check_time > 0 ) {
+			check_time = connect_info->m_send_time + m_heart_check_time * 1000;
+		}
+		if( m_idle_timeout_c > 0 ) {
+			check_time = std::min( check_time, connect_info->m_recv_time + m_idle_timeout_c );
+		}
+		if( connect_info->m_send_backlog_timeout > 0 ) { // ѹʱܿʼʱڲ鿴
+			check_time = std::min( check_time, GetSteadyTimeMs() + connect_info->m_send_backlog_timeout );
+		}
+		if( INT64_MAX == check_time ) { // ʱԶڼ鶪ʧϢͳ
+			check_time = GetSteadyTimeMs() + 10000;
+		}
+		return check_time;
+	}
+
+	void NetClient_P::Client_AddReconnect( ConnectInfo* connect_info ) {
+		ReconnectInfo reconnect_info;
+		reconnect_info.m_identity = connect_info->m_identity;
+		reconnect_info.m_address = connect_info->m_adress_r;
+		reconnect_info.m_port = connect_info->m_port_r;
+		reconnect_info.m_node_type = connect_info->m_node_type;
+		reconnect_info.m_reconnect_count = 0;
+		reconnect_info.m_disconnect_time = GetSteadyTimeMs();
+		bool in_reconnect_list = false;
+		m_reconnect_info_lock.lock();
+		for( auto it_ri = m_list_reconnect_info.begin(); it_ri != m_list_reconnect_info.end(); it_ri++ ) {
+			if( it_ri->m_identity == connect_info->m_identity ) {
+				in_reconnect_list = true; // ӶϿʱα
+				break;
+			}
+		}
+		if( false == in_reconnect_list ) {
+			reconnect_info.m_reconnect_timer = std::make_shared<boost::asio::steady_timer>( *m_service );
+			reconnect_info.m_reconnect_timer->expires_from_now( std::chrono::milliseconds( 0 ) ); // ״
+			reconnect_info.m_reconnect_timer->async_wait( boost::bind( &NetClient_P::Client_HandleReconnect, this, boost::asio::placeholders::error, reconnect_info.m_identity ) );
+			m_list_reconnect_info.push_back( reconnect_info );
+		}
+		m_reconnect_info_lock.unlock();
+		if( false == in_reconnect_list ) {
+			std::string log_info;
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  {0}:{1}:{2} رգתУ", connect_info->m_adress_r, connect_info->m_port_r, connect_info->m_node_type );
+			LogPrint( syslog_level::c_warn, m_log_cate, log_info );
 		}
 	}
 
-	void NetClient_P::MakeReconnect() {
-		if( false == m_auto_reconnect_client ) { // Ӵʱһֱֶȡ
-			m_reconnect_info_lock.lock();
-			m_list_reconnect_info.clear();
-			m_reconnect_info_lock.unlock();
+	void NetClient_P::Client_HandleReconnect( const boost::system::error_code& error, int32_t identity ) {
+		if( boost::asio::error::operation_aborted == error ) {
 			return;
 		}
 
-		std::list<ReconnectInfo> list_reconnect_info; // һݼ
+		if( false == m_auto_reconnect_client ) {
+			Client_ClearReconnect();
+			return;
+		}
 
+		bool in_reconnect_list = false;
+		ReconnectInfo reconnect_info;
 		m_reconnect_info_lock.lock();
 		for( auto it_ri = m_list_reconnect_info.begin(); it_ri != m_list_reconnect_info.end(); it_ri++ ) {
-			it_ri->m_reconnect_count++; //
-			list_reconnect_info.push_back( *it_ri );
+			if( it_ri->m_identity == identity ) {
+				it_ri->m_reconnect_count++; //
+				reconnect_info = *it_ri;
+				in_reconnect_list = true;
+				break;
+			}
 		}
 		m_reconnect_info_lock.unlock();
+		if( false == in_reconnect_list ) { // ɹ
+			return;
+		}
+
+		m_stat_reconnect_attempt++;
+		std::string log_info;
+		FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  {0}:{1}:{2} ĵ {3} ", reconnect_info.m_address, reconnect_info.m_port, reconnect_info.m_node_type, reconnect_info.m_reconnect_count );
+		LogPrint( syslog_level::c_info, m_log_cate, log_info );
+
+		if( true == IsShmAddress( reconnect_info.m_address ) ) { // ڴδʱʧ
+			if( Client_CanAddConnect() ) {
+				Client_StartConnectShm( reconnect_info.m_address, reconnect_info.m_port, reconnect_info.m_node_type, identity ); // ʧʱѰ´
+			}
+			else {
+				Client_ReconnectFailed( identity );
+			}
+			return;
+		}
 
-		for( auto it_ri = list_reconnect_info.begin(); it_ri != list_reconnect_info.end(); it_ri++ ) {
-			Client_AddConnect( it_ri->m_address, it_ri->m_port, it_ri->m_node_type );
-			// ￴ǷӳɹģҪ Client_HandleConnect() Ƿ񱨴 Client_AddNewInfo() 
+		try { // 첽Ҳ߳
+			std::string port_r_temp;
+			FormatLibrary::StandardLibrary::FormatTo( port_r_temp, "{0}", reconnect_info.m_port );
+			ResolverPtr resolver = std::make_shared<boost::asio::ip::tcp::resolver>( *m_service );
+			boost::asio::ip::tcp::resolver::query query( reconnect_info.m_address, port_r_temp );
+			resolver->async_resolve( query, boost::bind( &NetClient_P::Client_HandleResolve, this, boost::asio::placeholders::error, boost::asio::placeholders::iterator, resolver, reconnect_info.m_address, reconnect_info.m_port, reconnect_info.m_node_type, identity ) );
+		}
+		catch( std::exception& ex ) {
+			if( 1 == m_log_test ) {
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ   쳣{0}", ex.what() );
+			}
+			else {
+				log_info = "ͻ   쳣";
+			}
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+			Client_ReconnectFailed( identity );
+		}
+	}
+
+	void NetClient_P::Client_HandleResolve( const boost::system::error_code& error, boost::asio::ip::tcp::resolver::iterator endpoint_iterator, ResolverPtr resolver, std::string address_r, int32_t port_r, std::string node_type_r, int32_t identity ) {
+		if( error ) {
+			std::string log_info;
+			if( 1 == m_log_test ) {
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  {0}:{1}:{2}  {3}", address_r, port_r, node_type_r, error.message().c_str() );
+			}
+			else {
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  {0}:{1}:{2}  ", address_r, port_r, node_type_r );
+			}
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+			Client_ReconnectFailed( identity );
+			return;
+		}
+
+		if( !Client_CanAddConnect() ) {
 			std::string log_info;
-			FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  {0}:{1}:{2} ĵ {3} ", it_ri->m_address, it_ri->m_port, it_ri->m_node_type, it_ri->m_reconnect_count );
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ ȫ {0}:{1} ݻ {2}:{3}:{4}", m_total_remote_connect, m_max_connect_total_c, address_r, port_r, node_type_r );
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+			Client_ReconnectFailed( identity );
+			return;
+		}
+
+		int32_t endpoint_number = (int32_t)std::distance( endpoint_iterator, boost::asio::ip::tcp::resolver::iterator() );
+		if( endpoint_number <= 1 ) {
+			Client_StartConnect( endpoint_iterator, address_r, port_r, node_type_r, identity ); // ʧʱѰ´
+			return;
+		}
+
+		// ַʱÿַԷӣصǰһַʱȳɹ߱ȫʧܲŰ´
+		ConnectRacePtr connect_race = std::make_shared<ConnectRace>();
+		connect_race->m_pending = endpoint_number;
+		connect_race->m_finish = false;
+		for( boost::asio::ip::tcp::resolver::iterator it_ep = endpoint_iterator; it_ep != boost::asio::ip::tcp::resolver::iterator(); it_ep++ ) {
+			Client_StartConnect( it_ep, address_r, port_r, node_type_r, identity, connect_race ); // ֻ it_ep ָĵַ
+		}
+	}
+
+	bool NetClient_P::Client_ConnectRaceFailed( ConnectRacePtr connect_race ) { // һӳʧܣǷҪ´
+		if( nullptr == connect_race ) {
+			return true;
+		}
+		return 1 == connect_race->m_pending.fetch_sub( 1 ) && false == connect_race->m_finish;
+	}
+
+	void NetClient_P::Client_ReconnectFailed( int32_t identity ) { // ָ˱ܼ´
+		m_stat_reconnect_failure++;
+		m_reconnect_info_lock.lock();
+		for( auto it_ri = m_list_reconnect_info.begin(); it_ri != m_list_reconnect_info.end(); it_ri++ ) {
+			if( it_ri->m_identity == identity ) {
+				int32_t shift = std::min( it_ri->m_reconnect_count - 1, 20 );
+				int64_t backoff_time = std::min( (int64_t)m_reconnect_backoff_min << ( shift > 0 ? shift : 0 ), (int64_t)m_reconnect_backoff_max );
+				std::uniform_int_distribution<int64_t> jitter( backoff_time / 2, backoff_time );
+				it_ri->m_reconnect_timer->expires_from_now( std::chrono::milliseconds( jitter( m_reconnect_random ) ) );
+				it_ri->m_reconnect_timer->async_wait( boost::bind( &NetClient_P::Client_HandleReconnect, this, boost::asio::placeholders::error, identity ) );
+				break;
+			}
+		}
+		m_reconnect_info_lock.unlock();
+	}
+
+	void NetClient_P::Client_ReconnectSucceed( ConnectInfo* connect_info ) {
+		std::string log_info;
+		m_reconnect_info_lock.lock();
+		for( auto it_ri = m_list_reconnect_info.begin(); it_ri != m_list_reconnect_info.end(); it_ri++ ) {
+			// İԭӱƥ䣬ֶֻҪַ˿һҲɹ
+			if( ( connect_info->m_reconnect_identity != 0 && it_ri->m_identity == connect_info->m_reconnect_identity ) ||
+				( it_ri->m_address == connect_info->m_adress_r && it_ri->m_port == connect_info->m_port_r && it_ri->m_node_type == connect_info->m_node_type ) ) {
+				int64_t latency_time = GetSteadyTimeMs() - it_ri->m_disconnect_time;
+				int32_t bucket = 0;
+				while( bucket < RECONNECT_HISTOGRAM_SIZE - 1 && ( (int64_t)1 << bucket ) <= latency_time ) {
+					bucket++;
+				}
+				m_stat_reconnect_latency[bucket]++;
+				m_stat_reconnect_success++;
+				it_ri->m_reconnect_timer->cancel();
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "ͻ  {0}:{1}:{2} ɹʱ {3} 롣", it_ri->m_address, it_ri->m_port, it_ri->m_node_type, latency_time );
+				m_list_reconnect_info.erase( it_ri ); // ˵ѳɹ
+				break;
+			}
+		}
+		m_reconnect_info_lock.unlock();
+		if( !log_info.empty() ) {
 			LogPrint( syslog_level::c_info, m_log_cate, log_info );
 		}
 	}
 
+	void NetClient_P::Client_ClearReconnect() {
+		m_reconnect_info_lock.lock();
+		for( auto it_ri = m_list_reconnect_info.begin(); it_ri != m_list_reconnect_info.end(); it_ri++ ) {
+			it_ri->m_reconnect_timer->cancel();
+		}
+		m_list_reconnect_info.clear();
+		m_reconnect_info_lock.unlock();
+	}
+
 	size_t NetClient_P::Client_GetConnectCount() {
 		return m_list_remote_info.size();
 	}
@@ -1273,6 +2361,37 @@ namespace basicx {
 		m_net_client_p->Client_SetAutoReconnect( auto_reconnect );
 	}
 
+	void NetClient::Client_SetReconnectBackoff( int32_t backoff_min, int32_t backoff_max ) {
+		m_net_client_p->Client_SetReconnectBackoff( backoff_min, backoff_max );
+	}
+
+	NetMetrics NetClient::Client_GetMetrics( bool with_connect ) {
+		NetMetrics net_metrics;
+		m_net_client_p->CollectMetrics( net_metrics, with_connect );
+		net_metrics.m_snapshot_time = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::system_clock::now().time_since_epoch() ).count();
+		return net_metrics;
+	}
+
+	NetClientReconnectStat NetClient::Client_GetReconnectStat() {
+		return m_net_client_p->Client_GetReconnectStat();
+	}
+
+	void NetClient::Client_SetIdleTimeout( int32_t idle_timeout ) {
+		m_net_client_p->Client_SetIdleTimeout( idle_timeout );
+	}
+
+	void NetClient::Client_SetBinaryHead( bool binary_head ) {
+		m_net_client_p->Client_SetBinaryHead( binary_head );
+	}
+
+	void NetClient::Client_SetCompression( std::string node_type_r, int32_t codec, size_t threshold, std::string dict ) {
+		m_net_client_p->Client_SetCompression( node_type_r, codec, threshold, dict );
+	}
+
+	void NetClient::Client_SetSendQueue( std::string node_type_r, size_t queue_limit, int32_t queue_policy, int32_t backlog_timeout ) {
+		m_net_client_p->Client_SetSendQueue( node_type_r, queue_limit, queue_policy, backlog_timeout );
+	}
+
 	int32_t NetClient::Client_SendDataAll( int32_t type, int32_t code, std::string& data ) {
 		return m_net_client_p->Client_SendDataAll( type, code, data );
 	}
@@ -1281,6 +2400,18 @@ namespace basicx {
 		return m_net_client_p->Client_SendData( connect_info, type, code, data );
 	}
 
+	int32_t NetClient::Client_SendRequest( ConnectInfo* connect_info, int32_t code, std::string& data, int32_t time_out_ms, NetClientAnswer answer ) {
+		return m_net_client_p->Client_SendRequest( connect_info, code, data, time_out_ms, answer );
+	}
+
+	std::future<NetClientReply> NetClient::Client_SendRequest( ConnectInfo* connect_info, int32_t code, std::string& data, int32_t time_out_ms ) {
+		return m_net_client_p->Client_SendRequest( connect_info, code, data, time_out_ms );
+	}
+
+	size_t NetClient::Client_GetRequestCount() {
+		return m_net_client_p->Client_GetRequestCount();
+	}
+
 	void NetClient::Client_CloseAll() {
 		m_net_client_p->Client_CloseAll();
 	}
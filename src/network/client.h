@@ -23,12 +23,26 @@
 #define BASICX_NETWORK_CLIENT_H
 
 #include <string>
+#include <memory>
+#include <future>
 #include <stdint.h>
+#include <functional>
 
 #include <common/compile.h>
 
+#include "metrics.h"
+
 namespace basicx {
 
+	#define RECONNECT_BACKOFF_MIN 100 // 룬״У֮ÿʧܵȴʱӴֵ𷭱
+	#define RECONNECT_BACKOFF_MAX 30000 // 룬ȴʱޣʵʵȴһ뵽ȫ֮ͬ
+	#define RECONNECT_HISTOGRAM_SIZE 20 //  0 Ϊ 1 ڣ i Ϊ [2^(i-1), 2^i) 룬һ񺬸
+
+	#define REQUEST_RESULT_SUCCESS 0
+	#define REQUEST_RESULT_SEND_FAILED -1 // δܼ뷢ͶУ future ʽ᷵
+	#define REQUEST_RESULT_TIMEOUT -2 // ʱδյӦ֮󵽴Ӧ𽫱
+	#define REQUEST_RESULT_CLOSED -3 // յӦǰѹر
+
 	#pragma pack( push )
 	#pragma pack( 1 )
 
@@ -65,6 +79,33 @@ namespace basicx {
 		NetClientData( std::string& node_type, int32_t identity, int32_t code, std::string& data );
 	};
 
+	struct BASICX_NETWORK_EXPIMP NetClientView // ͣݣm_data ڻصڼЧ
+	{
+		const std::string* m_node_type; // פͬͽڵַͬڳЧ
+		int32_t m_identity;
+		int32_t m_code;
+		const char* m_data;
+		size_t m_size;
+		std::shared_ptr<char>* m_data_owner; // ڲʹ
+
+		std::shared_ptr<const char> TakeData() const; // ȡȨƣָ m_data ͬصЧ
+	};
+
+	struct NetClientReconnectStat // Զͳ
+	{
+		uint64_t m_attempt_count; // ѷ
+		uint64_t m_success_count;
+		uint64_t m_failure_count; // ʧܻʱ
+		uint64_t m_latency_histogram[RECONNECT_HISTOGRAM_SIZE]; // ӱϿɹĺʱֲ
+	};
+
+	struct NetClientReply // Ӧ future ʽ
+	{
+		int32_t m_result; // REQUEST_RESULT_*
+		int32_t m_code;
+		std::string m_data;
+	};
+
 	#pragma pack( pop )
 
 	class BASICX_NETWORK_EXPIMP NetClient_X
@@ -75,8 +116,11 @@ namespace basicx {
 
 		virtual void OnNetClientInfo( NetClientInfo& net_client_info ) = 0;
 		virtual void OnNetClientData( NetClientData& net_client_data ) = 0;
+		virtual void OnNetClientView( NetClientView& net_client_view ); // ĬתΪ NetClientData  OnNetClientData()ؼȥ
 	};
 
+	typedef std::function<void( int32_t result, NetClientView* net_client_view )> NetClientAnswer; // ʧʱ net_client_view Ϊ
+
 	struct ConnectInfo;
 
 	class NetClient_P;
@@ -98,12 +142,25 @@ namespace basicx {
 	public:
 		bool Client_CanAddConnect();
 		bool Client_CanAddServer( std::string address_r, int32_t port_r ); // ֻԶһַһ˿ֻһʱ
-		bool Client_AddConnect( std::string address_r, int32_t port_r, std::string node_type_r );
+		bool Client_AddConnect( std::string address_r, int32_t port_r, std::string node_type_r ); // address_r Ϊ "shm://name" ʱͬڴ
 		void Client_SetAutoReconnect( bool auto_reconnect );
+		void Client_SetReconnectBackoff( int32_t backoff_min, int32_t backoff_max ); // 룬Ĭ RECONNECT_BACKOFF_MIN  RECONNECT_BACKOFF_MAX
+		NetClientReconnectStat Client_GetReconnectStat();
+		NetMetrics Client_GetMetrics( bool with_connect = true ); // ʵշͳƿգwith_connect Ϊ false ʱֻȡϼ
+		void Client_SetIdleTimeout( int32_t idle_timeout ); // 룬ʱδյ()رӣ0 Ϊ⣬Ĭϲ
+		void Client_SetBinaryHead( bool binary_head ); // ǷöưͷĬϲԼݾɰ
+		void Client_SetCompression( std::string node_type_r, int32_t codec, size_t threshold, std::string dict = "" ); // ֮ĸýڵӣЭΪưͷ岻С threshold ֽڼ NW_COMPRESS_* ѹdict ΪԼԤֵ( Json )Զ˵Ǽͬһֵܽѹ
+		void Client_SetSendQueue( std::string node_type_r, size_t queue_limit, int32_t queue_policy, int32_t backlog_timeout = 0 ); // ֮ĸýڵӣϢﵽ queue_limit ʱ NW_QUEUE_* ĴϢ backlog_timeout δдϿ0 ΪޣĬ϶
 
 		int32_t Client_SendDataAll( int32_t type, int32_t code, std::string& data );
 		int32_t Client_SendData( ConnectInfo* connect_info, int32_t type, int32_t code, std::string& data );
 
+		// ӦͬһӿͬʱжδӦӦƥ䣬Ҫ򷵻أ NetServer::Server_SendAnswer() Ӧ
+		// Ӧ𡢳ʱӹرʱ߳лصһΣʱʱֵĿ̶ȼ⣬time_out_ms Ϊ 0 ʱֻӹرʱʧ
+		int32_t Client_SendRequest( ConnectInfo* connect_info, int32_t code, std::string& data, int32_t time_out_ms, NetClientAnswer answer ); // ֵͬ Client_SendData()ʧʱص
+		std::future<NetClientReply> Client_SendRequest( ConnectInfo* connect_info, int32_t code, std::string& data, int32_t time_out_ms ); // Ӧݻᱻ
+		size_t Client_GetRequestCount(); // δӦ
+
 		void Client_CloseAll();
 		void Client_Close( ConnectInfo* connect_info );
 		void Client_Close( int32_t identity );
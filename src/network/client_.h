@@ -22,6 +22,8 @@
 #ifndef BASICX_NETWORK_CLIENT_P_H
 #define BASICX_NETWORK_CLIENT_P_H
 
+#include <random>
+
 #include "struct.h"
 #include "client.h"
 
@@ -29,7 +31,13 @@ namespace basicx {
 
 	class SysLog_S;
 
-	class NetClient_P
+	struct PendingRequest
+	{
+		int32_t m_identity; // ӣӹرʱݴ˻صʧ
+		NetClientAnswer m_answer;
+	};
+
+	class NetClient_P : public NetMetricsSource
 	{
 	public:
 		NetClient_P();
@@ -41,7 +49,6 @@ namespace basicx {
 		void LogPrint( syslog_level log_level, std::string& log_cate, std::string& log_info, int32_t log_show = 0 );
 
 	public:
-		void Thread_ClientOnTime();
 		void Thread_NetClient();
 		void StartNetwork( NetClientCfg& config );
 		bool IsNetworkStarted();
@@ -51,18 +58,42 @@ namespace basicx {
 
 		bool Client_CanAddConnect();
 		bool Client_CanAddServer( std::string address_r, int32_t port_r ); // ֻԶһַһ˿ֻһʱ
+		std::string Client_GetServerEndpoint( const std::string& address_r, int32_t port_r ); // ԶϢļ"tcp://192.16.1.23:333""shm://name"
+		void Client_AddServerInfo( std::string address_r, int32_t port_r, std::string node_type_r );
 		bool Client_AddConnect( std::string address_r, int32_t port_r, std::string node_type_r );
+		bool Client_StartConnect( boost::asio::ip::tcp::resolver::iterator endpoint_iterator, std::string address_r, int32_t port_r, std::string node_type_r, int32_t reconnect_identity, ConnectRacePtr connect_race = nullptr );
+		bool Client_ConnectRaceFailed( ConnectRacePtr connect_race );
 		void Client_HandleConnect( const boost::system::error_code& error, ConnectInfo* connect_info );
 		void Client_CheckConnectTime( ConnectInfo* connect_info );
 		void Client_SetAutoReconnect( bool auto_reconnect );
+		void Client_SetReconnectBackoff( int32_t backoff_min, int32_t backoff_max );
+		NetClientReconnectStat Client_GetReconnectStat();
+		void CollectMetrics( NetMetrics& net_metrics, bool with_connect );
+		void Client_SetIdleTimeout( int32_t idle_timeout ); // 룬ʱδյرӣ0 Ϊ
+		void Client_SetBinaryHead( bool binary_head ); // ǷöưͷĬϲԼݾɰ
+		void Client_SetCompression( std::string node_type_r, int32_t codec, size_t threshold, std::string dict );
+		void Client_InitCompress( ConnectInfo* connect_info );
+		void Client_SetSendQueue( std::string node_type_r, size_t queue_limit, int32_t queue_policy, int32_t backlog_timeout );
+		void Client_InitSendQueue( ConnectInfo* connect_info );
 
 		void Client_HandleRecvHead( const boost::system::error_code& error, ConnectInfo* connect_info );
-		void Client_HandleRecvData( const boost::system::error_code& error, ConnectInfo* connect_info, int32_t type, int32_t code, int32_t size );
+		void Client_HandleRecvData( const boost::system::error_code& error, ConnectInfo* connect_info, int32_t type, int32_t code, int32_t flag, int32_t size );
+		bool Client_HandleRecvFrame( ConnectInfo* connect_info, int32_t type, int32_t code, int32_t flag, int32_t size ); //  m_recv_buf_data У false ʾݰ쳣ѹر
 	
 		int32_t Client_SendDataAll( int32_t type, int32_t code, std::string& data );
 		int32_t Client_SendData( ConnectInfo* connect_info, int32_t type, int32_t code, std::string& data );
+		int32_t Client_SendRequest( ConnectInfo* connect_info, int32_t code, std::string& data, int32_t time_out_ms, NetClientAnswer answer );
+		std::future<NetClientReply> Client_SendRequest( ConnectInfo* connect_info, int32_t code, std::string& data, int32_t time_out_ms );
+		void Client_HandleAnswer( ConnectInfo* connect_info, int32_t code, int32_t size );
+		void Client_FinishRequest( uint64_t request_id, int32_t result );
+		void Client_FailRequest( int32_t identity );
+		size_t Client_GetRequestCount();
 		void Client_HandleSendMsgs();
-		void Client_HandleSendData( const boost::system::error_code& error, SendBufInfo* send_buf_info );
+		void Client_HandleSendBuf( SendBufInfo* slot_buf_info );
+		void Client_WriteSendBufs( ConnectInfo* connect_info );
+		void Client_HandleSendData( const boost::system::error_code& error, ConnectInfo* connect_info );
+		void Client_ReleaseSendBuf( SendBufInfo* send_buf_info );
+		void Client_CloseBacklog( ConnectInfo* connect_info );
 
 		void Client_CloseOnError( ConnectInfo* connect_info );
 		void Client_PassiveClose( ConnectInfo* connect_info );
@@ -71,8 +102,27 @@ namespace basicx {
 		void Client_Close( ConnectInfo* connect_info );
 		void Client_Close( int32_t identity );
 
-		void SendHeartCheck();
-		void MakeReconnect();
+		bool Client_StartConnectShm( std::string address_r, int32_t port_r, std::string node_type_r, int32_t reconnect_identity );
+		void Client_CreateConnectShm( ShmSegmentPtr shm_segment, int32_t slot_index, std::string address_r, int32_t port_r, std::string node_type_r, int32_t reconnect_identity );
+		int32_t Client_ClaimShmSlot( ShmSegmentPtr shm_segment ); // ˽ܵĲλλ -1
+		int32_t Client_WaitShmSlot( ShmSegmentPtr shm_segment, int32_t slot_index ); // ȴ˽ܣزλʱز -1
+		void Client_HandleShmClaim( const boost::system::error_code& error, std::shared_ptr<ShmClaimInfo> shm_claim_info );
+		void Client_WithdrawShmSlot( ShmSegmentPtr shm_segment, int32_t slot_index );
+		void Thread_ClientShm();
+		bool Client_PollShm( ConnectInfo* connect_info, int64_t now_time, bool update_alive ); //  false ʾӱֿ
+		bool Client_RecvShm( ConnectInfo* connect_info );
+		int32_t Client_SendShm( ConnectInfo* connect_info, int32_t type, int32_t code, std::string& data );
+
+		void Client_StartWheel();
+		void Client_HandleWheel( const boost::system::error_code& error );
+		void Client_CheckConnect( int32_t identity, int64_t now_time );
+		int64_t Client_GetCheckTime( ConnectInfo* connect_info );
+		void Client_AddReconnect( ConnectInfo* connect_info );
+		void Client_HandleReconnect( const boost::system::error_code& error, int32_t identity );
+		void Client_HandleResolve( const boost::system::error_code& error, boost::asio::ip::tcp::resolver::iterator endpoint_iterator, ResolverPtr resolver, std::string address_r, int32_t port_r, std::string node_type_r, int32_t identity );
+		void Client_ReconnectFailed( int32_t identity );
+		void Client_ReconnectSucceed( ConnectInfo* connect_info );
+		void Client_ClearReconnect();
 
 		size_t Client_GetConnectCount();
 		ConnectInfo* Client_GetConnect( int32_t identity );
@@ -84,6 +134,15 @@ namespace basicx {
 		int32_t m_identity_count;
 
 		bool m_auto_reconnect_client; // ͻԶ // û
+		std::atomic<bool> m_binary_head_client; // ͻưͷ
+		TimerWheel<int32_t>* m_heart_wheel; // ӱǵм
+		SteadyTimerPtr m_wheel_timer;
+		int32_t m_idle_timeout_c; // 
+
+		std::atomic<uint64_t> m_request_id; //  1 ʼ0 ʾ
+		std::mutex m_pending_request_lock;
+		std::unordered_map<uint64_t, PendingRequest> m_map_pending_request; // δӦ
+		TimerWheel<uint64_t>* m_request_wheel; // ǵȳʱöʱ
 
 		TCPSocketOption m_tcp_socket_option;
 
@@ -109,10 +168,33 @@ namespace basicx {
 
 		std::mutex m_reconnect_info_lock;
 		std::list<ReconnectInfo> m_list_reconnect_info;
+		std::mt19937 m_reconnect_random; // ˱ܶ m_reconnect_info_lock ʹ
+		int32_t m_reconnect_backoff_min; // 
+		int32_t m_reconnect_backoff_max; // 
+		std::atomic<uint64_t> m_stat_reconnect_attempt;
+		std::atomic<uint64_t> m_stat_reconnect_success;
+		std::atomic<uint64_t> m_stat_reconnect_failure;
+		std::atomic<uint64_t> m_stat_reconnect_latency[RECONNECT_HISTOGRAM_SIZE];
+		LatencyHistogram m_stat_send_latency; // ӵд
+		ConnectStatTotal m_stat_closed;
 
 		std::mutex m_server_info_lock;
 		std::map<std::string, ServerInfo*> m_map_server_info;
 
+		std::thread m_shm_thread; // йڴӹһѯ߳
+		std::atomic<bool> m_shm_running;
+		std::mutex m_shm_connect_lock;
+		std::vector<ConnectInfo*> m_vec_shm_connect;
+
+		std::mutex m_compress_lock;
+		std::map<std::string, CompressConfig> m_map_compress_config; // ڵ
+		CompressDictTable m_compress_dict_table; // ùֵ䣬еֵǲҺѹ
+
+		std::mutex m_send_queue_lock;
+		std::map<std::string, SendQueueConfig> m_map_send_queue_config; // ڵ
+		std::mutex m_send_pool_lock;
+		std::vector<SendBufInfo*> m_vec_send_pool; // ;ϢӲλĻ棬д黹
+
 		int32_t m_log_test;
 		int32_t m_heart_check_time;
 		size_t m_max_msg_cache_number;
@@ -123,7 +205,6 @@ namespace basicx {
 		size_t m_max_data_length_c;
 
 		std::thread m_thread_net_client;
-		std::thread m_thread_client_on_time;
 		size_t m_total_remote_connect; // Զ̷
 
 	private:
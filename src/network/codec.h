@@ -0,0 +1,448 @@
+/*
+* Copyright (c) 2017-2018 the BasicX authors
+* All rights reserved.
+*
+* The project sponsor and lead author is Xu Rendong.
+* E-mail: xrd@ustc.edu, QQ: 277195007, WeChat: ustc_xrd
+* See the contributors file for names of other contributors.
+*
+* Commercial use of this code in source and binary forms is
+* governed by a LGPL v3 license. You may get a copy from the
+* root directory. Or else you should get a specific written
+* permission from the project author.
+*
+* Individual and educational use of this code in source and
+* binary forms is governed by a 3-clause BSD license. You may
+* get a copy from the root directory. Certainly welcome you
+* to contribute code of all sorts.
+*
+* Be sure to retain the above copyright notice and conditions.
+*/
+
+#ifndef BASICX_NETWORK_CODEC_H
+#define BASICX_NETWORK_CODEC_H
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef BASICX_NETWORK_ZLIB
+#include <zlib.h>
+#endif
+
+#include <common/define.h>
+
+#include "frame.h"
+
+namespace basicx {
+
+	// ѹ壺[0~3]ԭʼ(uint32 С) [4~7]ֵ(uint32 Сˣ0 Ϊֵ) [8~]ѹ
+	// ֻڶưͷɰͷ FLAG ֽڵ FRAME_FLAG_COMPRESS_* ͷ CODE ԭֵ
+	#define COMPRESS_HEAD_BYTES 8
+	#define COMPRESS_DICT_MAX 65536 // LZ ݴ 64KBֵ䳬ֻȡĩβ
+	#define COMPRESS_ZLIB_LEVEL 6
+
+	// LZ ѹ LZ4 ʽһ£token( 4 λȣ 4 λƥ䳤 - 4) []  ƫ(uint16 С) [ƥ䳤]
+	#define LZ_MIN_MATCH 4
+	#define LZ_LAST_LITERALS 5 // ĩβ 5 ֽΪ
+	#define LZ_MATCH_LIMIT 12 // һƥĩβ 12 ֽ֮ǰʼ
+	#define LZ_MAX_OFFSET 65535
+	#define LZ_HASH_BITS 14
+
+	struct CompressDict
+	{
+		uint32_t m_dict_id;
+		std::string m_dict;
+		std::vector<uint32_t> m_hash_table; // ֵλõ LZ ϣʱúֻ߳ѹʱԭƥ
+	};
+
+	typedef std::shared_ptr<const CompressDict> CompressDictPtr;
+
+	struct CompressConfig // ڵãӽʱƵ ConnectInfo
+	{
+		int32_t m_codec; // NW_COMPRESS_*
+		size_t m_threshold; // 岻СڸóȲѹ
+		CompressDictPtr m_dict; // Ϊ
+	};
+
+	inline uint32_t ReadUint32( const char* data ) {
+		const uint8_t* p = (const uint8_t*)data;
+		return (uint32_t)p[0] | ( (uint32_t)p[1] << 8 ) | ( (uint32_t)p[2] << 16 ) | ( (uint32_t)p[3] << 24 );
+	}
+
+	inline void WriteUint32( char* data, uint32_t value ) {
+		data[0] = (char)( value & 0xFF );
+		data[1] = (char)( ( value >> 8 ) & 0xFF );
+		data[2] = (char)( ( value >> 16 ) & 0xFF );
+		data[3] = (char)( ( value >> 24 ) & 0xFF );
+	}
+
+	inline uint32_t LzHash( const uint8_t* p ) {
+		uint32_t value = 0;
+		memcpy( &value, p, 4 );
+		return ( value * 2654435761U ) >> ( 32 - LZ_HASH_BITS );
+	}
+
+	inline CompressDictPtr MakeCompressDict( const std::string& dict ) { // ֵ䷵ؿ
+		if( dict.empty() ) {
+			return nullptr;
+		}
+		std::shared_ptr<CompressDict> compress_dict = std::make_shared<CompressDict>();
+		compress_dict->m_dict = dict.length() > COMPRESS_DICT_MAX ? dict.substr( dict.length() - COMPRESS_DICT_MAX ) : dict;
+		uint32_t hash = 2166136261U; // FNV-1a˰ݵõͬ
+		for( size_t i = 0; i < compress_dict->m_dict.length(); i++ ) {
+			hash ^= (uint8_t)compress_dict->m_dict[i];
+			hash *= 16777619U;
+		}
+		compress_dict->m_dict_id = 0 == hash ? 1 : hash;
+		compress_dict->m_hash_table.assign( (size_t)1 << LZ_HASH_BITS, 0xFFFFFFFF );
+		const uint8_t* dict_base = (const uint8_t*)compress_dict->m_dict.data();
+		for( size_t i = 0; i + LZ_MIN_MATCH <= compress_dict->m_dict.length(); i++ ) { // λøǰģƫƸС
+			compress_dict->m_hash_table[LzHash( dict_base + i )] = (uint32_t)i;
+		}
+		return compress_dict;
+	}
+
+	// ֵǼǱշеֵǲңֻɾѵǼǵֵڽһֱЧ
+	class CompressDictTable
+	{
+	public:
+		void Add( const CompressDictPtr& dict ) {
+			if( dict != nullptr ) {
+				std::lock_guard<std::mutex> lock( m_dict_lock );
+				m_map_dict[dict->m_dict_id] = dict;
+			}
+		}
+
+		CompressDictPtr Find( uint32_t dict_id ) {
+			std::lock_guard<std::mutex> lock( m_dict_lock );
+			auto it_d = m_map_dict.find( dict_id );
+			return it_d != m_map_dict.end() ? it_d->second : nullptr;
+		}
+
+	private:
+		std::mutex m_dict_lock;
+		std::map<uint32_t, CompressDictPtr> m_map_dict;
+	};
+
+	inline void LzWriteLength( std::string& dst, size_t& op, size_t length ) { // ֽڣÿ 255 һ
+		while( length >= 255 ) {
+			dst[op++] = (char)255;
+			length -= 255;
+		}
+		dst[op++] = (char)length;
+	}
+
+	// ׷ӵ dst ĩβѹСԭʱ false
+	inline bool LzCompress( const CompressDict* dict, const char* src, size_t src_size, std::string& dst ) {
+		thread_local std::vector<uint32_t> hash_table( (size_t)1 << LZ_HASH_BITS, 0xFFFFFFFF ); // ֻǼǱڵλ
+
+		// ֵ䲻Ҳ¹ϣδʱֵԴĹϣƫԽͷֵָĩβÿֻй
+		// ϣգλֻҪ ip ֮ǰݱȶһ¾ǺϷƥ
+		size_t dict_size = dict != nullptr ? dict->m_dict.length() : 0;
+		const uint8_t* dict_base = dict_size > 0 ? (const uint8_t*)dict->m_dict.data() : nullptr;
+		const uint8_t* base = (const uint8_t*)src;
+
+		size_t dst_begin = dst.length();
+		size_t dst_limit = dst_begin + src_size; // ԭ
+		dst.resize( dst_begin + src_size + src_size / 255 + 16 );
+		size_t op = dst_begin;
+
+		size_t end = src_size;
+		size_t anchor = 0;
+		size_t ip = 0;
+		if( src_size > LZ_MATCH_LIMIT ) {
+			size_t match_limit = end - LZ_MATCH_LIMIT;
+			size_t search = 0; // δʱ𲽼Ӵ󲽳ѹҲܿɨ
+			while( ip < match_limit ) {
+				uint32_t hash = LzHash( base + ip );
+				uint32_t ref = hash_table[hash];
+				hash_table[hash] = (uint32_t)ip;
+				size_t offset = 0;
+				size_t match_length = LZ_MIN_MATCH;
+				if( ref < ip && ip - ref <= LZ_MAX_OFFSET && 0 == memcmp( base + ref, base + ip, LZ_MIN_MATCH ) ) {
+					while( ip + match_length < end - LZ_LAST_LITERALS && base[ref + match_length] == base[ip + match_length] ) {
+						match_length++;
+					}
+					offset = ip - ref;
+				}
+				else if( dict_size > 0 ) {
+					uint32_t dict_ref = dict->m_hash_table[hash];
+					if( dict_ref < dict_size && ip + dict_size - dict_ref <= LZ_MAX_OFFSET && 0 == memcmp( dict_base + dict_ref, base + ip, LZ_MIN_MATCH ) ) {
+						while( ip + match_length < end - LZ_LAST_LITERALS && dict_ref + match_length < dict_size && dict_base[dict_ref + match_length] == base[ip + match_length] ) {
+							match_length++;
+						}
+						offset = ip + dict_size - dict_ref;
+					}
+				}
+				if( 0 == offset ) {
+					ip += 1 + ( search++ >> 6 );
+					continue;
+				}
+				search = 0;
+
+				size_t literal_length = ip - anchor;
+				if( op + 1 + literal_length + literal_length / 255 + 2 + ( match_length - LZ_MIN_MATCH ) / 255 + 1 > dst_limit ) {
+					dst.resize( dst_begin );
+					return false;
+				}
+				size_t token = op++;
+				uint8_t token_value = 0;
+				if( literal_length >= 15 ) {
+					token_value = 15 << 4;
+					LzWriteLength( dst, op, literal_length - 15 );
+				}
+				else {
+					token_value = (uint8_t)( literal_length << 4 );
+				}
+				memcpy( &dst[op], base + anchor, literal_length );
+				op += literal_length;
+				dst[op++] = (char)( offset & 0xFF );
+				dst[op++] = (char)( offset >> 8 );
+				if( match_length - LZ_MIN_MATCH >= 15 ) {
+					token_value |= 15;
+					LzWriteLength( dst, op, match_length - LZ_MIN_MATCH - 15 );
+				}
+				else {
+					token_value |= (uint8_t)( match_length - LZ_MIN_MATCH );
+				}
+				dst[token] = (char)token_value;
+
+				ip += match_length;
+				anchor = ip;
+				if( ip < match_limit ) {
+					hash_table[LzHash( base + ip - 2 )] = (uint32_t)( ip - 2 );
+				}
+			}
+		}
+
+		size_t literal_length = end - anchor; // һֻ
+		if( op + 1 + literal_length + literal_length / 255 + 1 > dst_limit ) {
+			dst.resize( dst_begin );
+			return false;
+		}
+		size_t token = op++;
+		if( literal_length >= 15 ) {
+			dst[token] = (char)( 15 << 4 );
+			LzWriteLength( dst, op, literal_length - 15 );
+		}
+		else {
+			dst[token] = (char)( literal_length << 4 );
+		}
+		memcpy( &dst[op], base + anchor, literal_length );
+		op += literal_length;
+		dst.resize( op );
+		return true;
+	}
+
+	// ȱΪ dst_sizeԽʽʱ false
+	inline bool LzDecompress( const CompressDict* dict, const char* src, size_t src_size, char* dst, size_t dst_size ) {
+		const uint8_t* ip = (const uint8_t*)src;
+		const uint8_t* ip_end = ip + src_size;
+		char* op = dst;
+		char* op_end = dst + dst_size;
+		size_t dict_size = dict != nullptr ? dict->m_dict.length() : 0;
+
+		while( ip < ip_end ) {
+			uint8_t token = *ip++;
+			size_t literal_length = token >> 4;
+			if( 15 == literal_length ) {
+				uint8_t value = 255;
+				while( 255 == value ) {
+					if( ip >= ip_end ) {
+						return false;
+					}
+					value = *ip++;
+					literal_length += value;
+				}
+			}
+			if( literal_length > (size_t)( ip_end - ip ) || literal_length > (size_t)( op_end - op ) ) {
+				return false;
+			}
+			memcpy( op, ip, literal_length );
+			op += literal_length;
+			ip += literal_length;
+			if( ip == ip_end ) { // һ
+				break;
+			}
+
+			if( ip_end - ip < 2 ) {
+				return false;
+			}
+			size_t offset = (size_t)ip[0] | ( (size_t)ip[1] << 8 );
+			ip += 2;
+			size_t match_length = token & 15;
+			if( 15 == match_length ) {
+				uint8_t value = 255;
+				while( 255 == value ) {
+					if( ip >= ip_end ) {
+						return false;
+					}
+					value = *ip++;
+					match_length += value;
+				}
+			}
+			match_length += LZ_MIN_MATCH;
+			size_t produced = op - dst;
+			if( 0 == offset || offset > produced + dict_size || match_length > (size_t)( op_end - op ) ) {
+				return false;
+			}
+
+			if( offset > produced ) { // ֵУܽͷ
+				size_t dict_back = offset - produced;
+				size_t copy_length = dict_back < match_length ? dict_back : match_length;
+				memcpy( op, dict->m_dict.data() + dict_size - dict_back, copy_length );
+				op += copy_length;
+				match_length -= copy_length;
+				const char* ref = dst;
+				while( match_length-- > 0 ) {
+					*op++ = *ref++;
+				}
+			}
+			else {
+				const char* ref = op - offset;
+				if( offset >= match_length ) {
+					memcpy( op, ref, match_length );
+					op += match_length;
+				}
+				else { // صʱֽڸƣظǰ
+					while( match_length-- > 0 ) {
+						*op++ = *ref++;
+					}
+				}
+			}
+		}
+		return op == op_end;
+	}
+
+#ifdef BASICX_NETWORK_ZLIB
+	inline bool ZlibCompress( const CompressDict* dict, const char* src, size_t src_size, std::string& dst ) {
+		z_stream stream;
+		memset( &stream, 0, sizeof( stream ) );
+		if( deflateInit( &stream, COMPRESS_ZLIB_LEVEL ) != Z_OK ) {
+			return false;
+		}
+		if( dict != nullptr ) {
+			deflateSetDictionary( &stream, (const Bytef*)dict->m_dict.data(), (uInt)dict->m_dict.length() );
+		}
+		size_t dst_begin = dst.length();
+		dst.resize( dst_begin + deflateBound( &stream, (uLong)src_size ) );
+		stream.next_in = (Bytef*)src;
+		stream.avail_in = (uInt)src_size;
+		stream.next_out = (Bytef*)&dst[dst_begin];
+		stream.avail_out = (uInt)( dst.length() - dst_begin );
+		int32_t result = deflate( &stream, Z_FINISH );
+		size_t dst_size = stream.total_out;
+		deflateEnd( &stream );
+		if( result != Z_STREAM_END || dst_size >= src_size ) {
+			dst.resize( dst_begin );
+			return false;
+		}
+		dst.resize( dst_begin + dst_size );
+		return true;
+	}
+
+	inline bool ZlibDecompress( const CompressDict* dict, const char* src, size_t src_size, char* dst, size_t dst_size ) {
+		z_stream stream;
+		memset( &stream, 0, sizeof( stream ) );
+		if( inflateInit( &stream ) != Z_OK ) {
+			return false;
+		}
+		stream.next_in = (Bytef*)src;
+		stream.avail_in = (uInt)src_size;
+		stream.next_out = (Bytef*)dst;
+		stream.avail_out = (uInt)dst_size;
+		int32_t result = inflate( &stream, Z_FINISH );
+		if( Z_NEED_DICT == result && dict != nullptr ) {
+			if( Z_OK == inflateSetDictionary( &stream, (const Bytef*)dict->m_dict.data(), (uInt)dict->m_dict.length() ) ) {
+				result = inflate( &stream, Z_FINISH );
+			}
+		}
+		bool finished = Z_STREAM_END == result && stream.total_out == dst_size;
+		inflateEnd( &stream );
+		return finished;
+	}
+#endif
+
+	inline bool IsCodecSupported( int32_t codec ) {
+#ifdef BASICX_NETWORK_ZLIB
+		return NW_COMPRESS_LZ == codec || NW_COMPRESS_ZLIB == codec;
+#else
+		return NW_COMPRESS_LZ == codec;
+#endif
+	}
+
+	// ѹд packed ذͷǣδѹ(벻ֻ֧ѹ󲻸С)ʱ 0ʱӦԭ
+	inline int32_t CompressFrame( int32_t codec, const CompressDictPtr& dict, const std::string& data, std::string& packed ) {
+		packed.resize( COMPRESS_HEAD_BYTES );
+		WriteUint32( &packed[0], (uint32_t)data.length() );
+		WriteUint32( &packed[4], dict != nullptr ? dict->m_dict_id : 0 );
+		bool compressed = false;
+		int32_t flag = 0;
+		if( NW_COMPRESS_LZ == codec ) {
+			compressed = LzCompress( dict.get(), data.data(), data.length(), packed );
+			flag = FRAME_FLAG_COMPRESS_LZ;
+		}
+#ifdef BASICX_NETWORK_ZLIB
+		else if( NW_COMPRESS_ZLIB == codec ) {
+			compressed = ZlibCompress( dict.get(), data.data(), data.length(), packed );
+			flag = FRAME_FLAG_COMPRESS_ZLIB;
+		}
+#endif
+		return true == compressed && packed.length() < data.length() ? flag : 0;
+	}
+
+	// ѹ unpack_buf治ѱⲿʱ»棬unpack_size ԭʼ
+	//  0 ɹ-1 𻵣-2 ֵδ֪-3 ԭʼȳޣ-4 ֵ֧ѹʽ
+	inline int32_t UnpackFrame( int32_t flag, const char* data, size_t size, size_t size_max, const CompressDictPtr& dict_hint, CompressDictTable& dict_table, 
+		std::shared_ptr<char>& unpack_buf, size_t& unpack_buf_size, size_t& unpack_size ) {
+		if( size < COMPRESS_HEAD_BYTES ) {
+			return -1;
+		}
+		unpack_size = ReadUint32( data );
+		uint32_t dict_id = ReadUint32( data + 4 );
+		if( unpack_size > size_max ) {
+			return -3;
+		}
+
+		CompressDictPtr dict;
+		if( dict_id != 0 ) {
+			dict = dict_hint != nullptr && dict_hint->m_dict_id == dict_id ? dict_hint : dict_table.Find( dict_id ); // ͨ뱾ӷֵͬȥ
+			if( nullptr == dict ) {
+				return -2;
+			}
+		}
+
+		if( unpack_buf_size < unpack_size || nullptr == unpack_buf || unpack_buf.use_count() > 1 ) {
+			size_t buf_size = unpack_size > unpack_buf_size ? unpack_size : unpack_buf_size;
+			if( 0 == buf_size ) {
+				buf_size = 1;
+			}
+			unpack_buf = std::shared_ptr<char>( new char[buf_size], std::default_delete<char[]>() );
+			unpack_buf_size = buf_size;
+		}
+
+		bool unpacked = false;
+		if( flag & FRAME_FLAG_COMPRESS_LZ ) {
+			unpacked = LzDecompress( dict.get(), data + COMPRESS_HEAD_BYTES, size - COMPRESS_HEAD_BYTES, unpack_buf.get(), unpack_size );
+		}
+		else if( flag & FRAME_FLAG_COMPRESS_ZLIB ) {
+#ifdef BASICX_NETWORK_ZLIB
+			unpacked = ZlibDecompress( dict.get(), data + COMPRESS_HEAD_BYTES, size - COMPRESS_HEAD_BYTES, unpack_buf.get(), unpack_size );
+#else
+			return -4;
+#endif
+		}
+		else {
+			return -4;
+		}
+		return true == unpacked ? 0 : -1;
+	}
+
+} // namespace basicx
+
+#endif // BASICX_NETWORK_CODEC_H
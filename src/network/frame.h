@@ -0,0 +1,180 @@
+/*
+* Copyright (c) 2017-2018 the BasicX authors
+* All rights reserved.
+*
+* The project sponsor and lead author is Xu Rendong.
+* E-mail: xrd@ustc.edu, QQ: 277195007, WeChat: ustc_xrd
+* See the contributors file for names of other contributors.
+*
+* Commercial use of this code in source and binary forms is
+* governed by a LGPL v3 license. You may get a copy from the
+* root directory. Or else you should get a specific written
+* permission from the project author.
+*
+* Individual and educational use of this code in source and
+* binary forms is governed by a 3-clause BSD license. You may
+* get a copy from the root directory. Certainly welcome you
+* to contribute code of all sorts.
+*
+* Be sure to retain the above copyright notice and conditions.
+*/
+
+#ifndef BASICX_NETWORK_FRAME_H
+#define BASICX_NETWORK_FRAME_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace basicx {
+
+	#define TYPE_BYTES 1 // 0~F0~15
+	#define CODE_BYTES 1 // 0~F0~15
+	#define SIZE_BYTES 6 // 000000~FFFFFF0~1677721515MB
+    #define FLAG_BYTES 2 // TYPE_BYTES + CODE_BYTES
+    #define HEAD_BYTES 8 // TYPE_BYTES + CODE_BYTES + SIZE_BYTES
+
+	#define HEAD_MODE_TEXT 0 // ʮıͷݾɰԶ
+	#define HEAD_MODE_BINARY 1 // ưͷ辭Э
+
+	// ưͷͬΪ HEAD_BYTES ȣ[0]MAGIC [1]TYPE [2]CODE [3]FLAG [4~7]SIZE(uint32 С)
+	// MAGIC ʮַҲǿո񣬽ʱֻֽڼְͷ
+	#define HEAD_BINARY_MAGIC 0xB8
+	#define HEAD_TEXT_SIZE_MAX 0x00FFFFFF // ıͷ 15MB
+	#define HEAD_BINARY_SIZE_MAX 0x7FFFFFFF // ưͷ 2GBʵ m_max_data_length_* 
+
+	// ưͷ FLAG ֽڣıͷûиֽڣΪ 0
+	#define FRAME_FLAG_COMPRESS_LZ 0x01 // 徭 LZ ѹʽ codec.h
+	#define FRAME_FLAG_COMPRESS_ZLIB 0x02 // 徭 zlib ѹʽ codec.h
+	#define FRAME_FLAG_COMPRESS ( FRAME_FLAG_COMPRESS_LZ | FRAME_FLAG_COMPRESS_ZLIB )
+
+	// NW_MSG_TYPE_REQUEST  NW_MSG_TYPE_ANSWER İǿͷuint64 Сˣͷʽ޹
+	#define REQUEST_ID_BYTES 8
+
+	struct FrameHead
+	{
+		int32_t m_type;
+		int32_t m_code;
+		int32_t m_flag;
+		size_t m_size;
+		int32_t m_head_mode;
+	};
+
+	// ıͷ std::setw() << std::hex һ£СдҶ룬󲹿ո
+	static const char g_frame_hex_char[16] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' };
+
+	// ոΪλ 0 ǷַΪ -1ʱֵһжǷǷ
+	static const int8_t g_frame_hex_value[256] = {
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		 0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, // ' '
+		 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1, // '0'~'9'
+		-1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 'A'~'F'
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 'a'~'f'
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	};
+
+	inline bool IsBinaryHead( const char* head ) {
+		return HEAD_BINARY_MAGIC == (uint8_t)head[0];
+	}
+
+	inline void EncodeHeadText( char* head, int32_t type, int32_t code, uint32_t size ) { // ǰ豣֤ size <= HEAD_TEXT_SIZE_MAX
+		head[0] = g_frame_hex_char[type & 0x0F];
+		head[1] = g_frame_hex_char[code & 0x0F];
+		head[2] = g_frame_hex_char[( size >> 20 ) & 0x0F];
+		head[3] = g_frame_hex_char[( size >> 16 ) & 0x0F];
+		head[4] = g_frame_hex_char[( size >> 12 ) & 0x0F];
+		head[5] = g_frame_hex_char[( size >> 8 ) & 0x0F];
+		head[6] = g_frame_hex_char[( size >> 4 ) & 0x0F];
+		head[7] = g_frame_hex_char[size & 0x0F];
+		for( int32_t i = FLAG_BYTES; i < HEAD_BYTES - 1 && '0' == head[i]; i++ ) { // ǰΪո std::setw() һ
+			head[i] = ' ';
+		}
+	}
+
+	inline void EncodeHeadBinary( char* head, int32_t type, int32_t code, int32_t flag, uint32_t size ) {
+		head[0] = (char)HEAD_BINARY_MAGIC;
+		head[1] = (char)type;
+		head[2] = (char)code;
+		head[3] = (char)flag;
+		head[4] = (char)( size );
+		head[5] = (char)( size >> 8 );
+		head[6] = (char)( size >> 16 );
+		head[7] = (char)( size >> 24 );
+	}
+
+	inline void EncodeHead( char* head, int32_t head_mode, int32_t type, int32_t code, int32_t flag, uint32_t size ) {
+		if( HEAD_MODE_BINARY == head_mode ) {
+			EncodeHeadBinary( head, type, code, flag, size );
+		}
+		else {
+			EncodeHeadText( head, type, code, size );
+		}
+	}
+
+	inline bool DecodeHeadText( const char* head, FrameHead& frame_head ) {
+		const uint8_t* p = (const uint8_t*)head;
+		int32_t type = g_frame_hex_value[p[0]];
+		int32_t code = g_frame_hex_value[p[1]];
+		int32_t size = 0;
+		int32_t check = type | code;
+		for( int32_t i = FLAG_BYTES; i < HEAD_BYTES; i++ ) {
+			int32_t value = g_frame_hex_value[p[i]];
+			check |= value;
+			size = ( size << 4 ) | ( value & 0x0F );
+		}
+		frame_head.m_type = type;
+		frame_head.m_code = code;
+		frame_head.m_flag = 0;
+		frame_head.m_size = (size_t)size;
+		frame_head.m_head_mode = HEAD_MODE_TEXT;
+		return check >= 0;
+	}
+
+	inline bool DecodeHeadBinary( const char* head, FrameHead& frame_head ) {
+		const uint8_t* p = (const uint8_t*)head;
+		frame_head.m_type = p[1];
+		frame_head.m_code = p[2];
+		frame_head.m_flag = p[3];
+		frame_head.m_size = (size_t)( (uint32_t)p[4] | ( (uint32_t)p[5] << 8 ) | ( (uint32_t)p[6] << 16 ) | ( (uint32_t)p[7] << 24 ) );
+		frame_head.m_head_mode = HEAD_MODE_BINARY;
+		return frame_head.m_size <= HEAD_BINARY_SIZE_MAX;
+	}
+
+	inline bool DecodeHead( const char* head, FrameHead& frame_head ) {
+		if( IsBinaryHead( head ) ) {
+			return DecodeHeadBinary( head, frame_head );
+		}
+		return DecodeHeadText( head, frame_head );
+	}
+
+	inline void EncodeRequestId( char* data, uint64_t request_id ) {
+		for( int32_t i = 0; i < REQUEST_ID_BYTES; i++ ) {
+			data[i] = (char)( request_id >> ( i * 8 ) );
+		}
+	}
+
+	inline uint64_t DecodeRequestId( const char* data ) {
+		const uint8_t* p = (const uint8_t*)data;
+		uint64_t request_id = 0;
+		for( int32_t i = REQUEST_ID_BYTES - 1; i >= 0; i-- ) {
+			request_id = ( request_id << 8 ) | p[i];
+		}
+		return request_id;
+	}
+
+	inline size_t GetHeadSizeMax( int32_t head_mode ) {
+		return HEAD_MODE_BINARY == head_mode ? HEAD_BINARY_SIZE_MAX : HEAD_TEXT_SIZE_MAX;
+	}
+
+} // namespace basicx
+
+#endif // BASICX_NETWORK_FRAME_H
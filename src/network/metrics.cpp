@@ -0,0 +1,88 @@
+/*
+* Copyright (c) 2017-2018 the BasicX authors
+* All rights reserved.
+*
+* The project sponsor and lead author is Xu Rendong.
+* E-mail: xrd@ustc.edu, QQ: 277195007, WeChat: ustc_xrd
+* See the contributors file for names of other contributors.
+*
+* Commercial use of this code in source and binary forms is
+* governed by a LGPL v3 license. You may get a copy from the
+* root directory. Or else you should get a specific written
+* permission from the project author.
+*
+* Individual and educational use of this code in source and
+* binary forms is governed by a 3-clause BSD license. You may
+* get a copy from the root directory. Certainly welcome you
+* to contribute code of all sorts.
+*
+* Be sure to retain the above copyright notice and conditions.
+*/
+
+#include <mutex>
+#include <chrono>
+
+#include "metrics.h"
+
+namespace basicx {
+
+	static std::mutex g_metrics_lock; // עʱУ֤ڼԴ
+	static std::vector<NetMetricsSource*> g_vec_metrics_source;
+	static int32_t g_metrics_source_id = 0;
+
+	NetMetricsSource::NetMetricsSource()
+		: m_source_id( 0 ) {
+	}
+
+	NetMetricsSource::~NetMetricsSource() {
+	}
+
+	void NetMetricsRegistry::Register( NetMetricsSource* source ) {
+		std::lock_guard<std::mutex> lock( g_metrics_lock );
+		source->m_source_id = ++g_metrics_source_id;
+		g_vec_metrics_source.push_back( source );
+	}
+
+	void NetMetricsRegistry::Unregister( NetMetricsSource* source ) {
+		std::lock_guard<std::mutex> lock( g_metrics_lock );
+		for( auto it_ms = g_vec_metrics_source.begin(); it_ms != g_vec_metrics_source.end(); it_ms++ ) {
+			if( *it_ms == source ) {
+				g_vec_metrics_source.erase( it_ms );
+				break;
+			}
+		}
+	}
+
+	void NetMetricsRegistry::GetSnapshot( std::vector<NetMetrics>& vec_net_metrics, bool with_connect ) {
+		int64_t snapshot_time = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::system_clock::now().time_since_epoch() ).count();
+		std::lock_guard<std::mutex> lock( g_metrics_lock );
+		vec_net_metrics.resize( g_vec_metrics_source.size() );
+		for( size_t i = 0; i < g_vec_metrics_source.size(); i++ ) {
+			g_vec_metrics_source[i]->CollectMetrics( vec_net_metrics[i], with_connect );
+			vec_net_metrics[i].m_snapshot_time = snapshot_time;
+		}
+	}
+
+	int64_t NetMetricsRegistry::GetLatencyQuantile( const uint64_t* latency_histogram, double quantile ) {
+		uint64_t total = 0;
+		for( int32_t i = 0; i < METRICS_LATENCY_BUCKET; i++ ) {
+			total += latency_histogram[i];
+		}
+		if( 0 == total ) {
+			return 0;
+		}
+		uint64_t rank = (uint64_t)( quantile * total );
+		if( rank >= total ) {
+			rank = total - 1;
+		}
+		uint64_t count = 0;
+		for( int32_t i = 0; i < METRICS_LATENCY_BUCKET; i++ ) {
+			count += latency_histogram[i];
+			if( count > rank ) {
+				return (int64_t)1 << i; //  i  2^i ΢
+			}
+		}
+		return (int64_t)1 << ( METRICS_LATENCY_BUCKET - 1 );
+	}
+
+} // namespace basicx
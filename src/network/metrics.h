@@ -0,0 +1,96 @@
+/*
+* Copyright (c) 2017-2018 the BasicX authors
+* All rights reserved.
+*
+* The project sponsor and lead author is Xu Rendong.
+* E-mail: xrd@ustc.edu, QQ: 277195007, WeChat: ustc_xrd
+* See the contributors file for names of other contributors.
+*
+* Commercial use of this code in source and binary forms is
+* governed by a LGPL v3 license. You may get a copy from the
+* root directory. Or else you should get a specific written
+* permission from the project author.
+*
+* Individual and educational use of this code in source and
+* binary forms is governed by a 3-clause BSD license. You may
+* get a copy from the root directory. Certainly welcome you
+* to contribute code of all sorts.
+*
+* Be sure to retain the above copyright notice and conditions.
+*/
+
+#ifndef BASICX_NETWORK_METRICS_H
+#define BASICX_NETWORK_METRICS_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include <common/compile.h>
+
+namespace basicx {
+
+	#define METRICS_LATENCY_BUCKET 24 // ӵдʱֵ 0  1 ΢룬 i Ϊ [2^(i-1), 2^i) ΢룬ĩ
+	#define METRICS_ROLE_SERVER 0
+	#define METRICS_ROLE_CLIENT 1
+
+	struct NetConnectMetrics // ӵۼƼ
+	{
+		int32_t m_identity;
+		std::string m_node_type;
+		std::string m_endpoint_l;
+		std::string m_endpoint_r;
+		uint64_t m_recv_bytes; // ͷҲ
+		uint64_t m_recv_msgs;
+		uint64_t m_send_bytes; // дͷ
+		uint64_t m_send_msgs;
+		uint64_t m_send_queue; // δд
+		uint64_t m_drop_msgs; // Ͷԭ
+		uint64_t m_conflate_msgs; // ϲʱͬϢ滻
+	};
+
+	struct NetMetrics //  NetServer  NetClient Ŀգϼֵѹرյ
+	{
+		int32_t m_source_id; // ǼţΨһ
+		int32_t m_role; // METRICS_ROLE_*
+		int64_t m_snapshot_time; // 룬UTC
+		size_t m_connect_count;
+		uint64_t m_recv_bytes;
+		uint64_t m_recv_msgs;
+		uint64_t m_send_bytes;
+		uint64_t m_send_msgs;
+		uint64_t m_send_queue;
+		uint64_t m_drop_msgs;
+		uint64_t m_conflate_msgs;
+		uint64_t m_reconnect_attempt; // ͻ
+		uint64_t m_reconnect_success;
+		uint64_t m_reconnect_failure;
+		uint64_t m_latency_histogram[METRICS_LATENCY_BUCKET]; // ӵдɣڴӲв
+		std::vector<NetConnectMetrics> m_vec_connect;
+	};
+
+	class BASICX_NETWORK_EXPIMP NetMetricsSource // ڲʹãNetServer  NetClient ʱǼǣʱע
+	{
+	public:
+		NetMetricsSource();
+		virtual ~NetMetricsSource();
+
+		virtual void CollectMetrics( NetMetrics& net_metrics, bool with_connect ) = 0;
+
+	public:
+		int32_t m_source_id;
+	};
+
+	// շ·ֻ relaxed ԭۼӣǼǱֻڴʱ
+	class BASICX_NETWORK_EXPIMP NetMetricsRegistry
+	{
+	public:
+		static void Register( NetMetricsSource* source );
+		static void Unregister( NetMetricsSource* source );
+		static void GetSnapshot( std::vector<NetMetrics>& vec_net_metrics, bool with_connect = true ); //  NetServer  NetClient
+		static int64_t GetLatencyQuantile( const uint64_t* latency_histogram, double quantile ); // ΢룬ڷֵޣʱ 0
+	};
+
+} // namespace basicx
+
+#endif // BASICX_NETWORK_METRICS_H
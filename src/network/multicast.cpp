@@ -0,0 +1,692 @@
+/*
+* Copyright (c) 2017-2018 the BasicX authors
+* All rights reserved.
+*
+* The project sponsor and lead author is Xu Rendong.
+* E-mail: xrd@ustc.edu, QQ: 277195007, WeChat: ustc_xrd
+* See the contributors file for names of other contributors.
+*
+* Commercial use of this code in source and binary forms is
+* governed by a LGPL v3 license. You may get a copy from the
+* root directory. Or else you should get a specific written
+* permission from the project author.
+*
+* Individual and educational use of this code in source and
+* binary forms is governed by a 3-clause BSD license. You may
+* get a copy from the root directory. Certainly welcome you
+* to contribute code of all sorts.
+*
+* Be sure to retain the above copyright notice and conditions.
+*/
+
+#include <algorithm>
+
+#include "multicast_.h"
+
+#ifdef __OS_LINUX__
+#include <errno.h>
+#include <string.h>
+#endif
+
+namespace basicx {
+
+	MulticastSender_P::MulticastSender_P()
+		: m_network_running( false )
+		, m_log_test( 0 )
+		, m_max_datagram_size( MULTICAST_DATAGRAM_MAX )
+		, m_sequence( 0 )
+		, m_stat_datagram( 0 )
+		, m_stat_message( 0 )
+		, m_log_cate( "<MULTICAST_SENDER>" ) {
+		m_syslog = SysLog_S::GetInstance();
+	}
+
+	MulticastSender_P::~MulticastSender_P() {
+		m_network_running = false;
+		if( m_socket.get() ) {
+			boost::system::error_code ec;
+			m_socket->close( ec );
+		}
+	}
+
+	void MulticastSender_P::LogPrint( syslog_level log_level, std::string& log_cate, std::string& log_info, int32_t log_show/* = 0*/ ) {
+		m_syslog->LogWrite( log_level, log_cate, log_info );
+		m_syslog->LogPrint( log_level, log_cate, "LOG>: " + log_info ); // ̨
+	}
+
+	bool MulticastSender_P::StartNetwork( NetMulticastCfg& config ) {
+		std::string log_info;
+
+		try {
+			m_log_test = config.m_log_test;
+			m_max_datagram_size = config.m_max_datagram_size > 0 ? std::min( config.m_max_datagram_size, (size_t)MULTICAST_DATAGRAM_LIMIT ) : MULTICAST_DATAGRAM_MAX;
+
+			boost::asio::ip::address group_address = boost::asio::ip::address::from_string( config.m_group_address );
+			m_group_endpoint = boost::asio::ip::udp::endpoint( group_address, (unsigned short)config.m_group_port );
+
+			m_service = std::make_shared<boost::asio::io_service>();
+			m_socket = std::make_shared<boost::asio::ip::udp::socket>( *m_service, m_group_endpoint.protocol() );
+			m_socket->set_option( boost::asio::ip::multicast::hops( config.m_ttl ) );
+			m_socket->set_option( boost::asio::ip::multicast::enable_loopback( config.m_loopback ) );
+			if( group_address.is_v4() && config.m_interface_address != "" && config.m_interface_address != "0.0.0.0" ) {
+				m_socket->set_option( boost::asio::ip::multicast::outbound_interface( boost::asio::ip::address_v4::from_string( config.m_interface_address ) ) );
+			}
+
+			m_network_running = true;
+
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "鲥Ͷ udp://{0}:{1}", config.m_group_address, config.m_group_port );
+			LogPrint( syslog_level::c_info, m_log_cate, log_info );
+		}
+		catch( std::exception& ex ) {
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "鲥Ͷ  udp://{0}:{1} 쳣{2}", config.m_group_address, config.m_group_port, ex.what() );
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+			return false;
+		}
+
+		return true;
+	}
+
+	bool MulticastSender_P::IsNetworkStarted() {
+		return m_network_running;
+	}
+
+	int32_t MulticastSender_P::Sender_SendData( int32_t type, int32_t code, std::string& data ) {
+		if( false == m_network_running ) {
+			return -4;
+		}
+
+		if( MULTICAST_SEQUENCE_BYTES + HEAD_BYTES + data.length() > m_max_datagram_size ) {
+			std::string log_info;
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "鲥Ͷ  Data Ϣ {0} > {1}", data.length(), m_max_datagram_size - MULTICAST_SEQUENCE_BYTES - HEAD_BYTES );
+			LogPrint( syslog_level::c_warn, m_log_cate, log_info );
+			return -3;
+		}
+
+		int32_t result = 0;
+		m_send_lock.lock();
+		try {
+			if( m_vec_datagram.empty() ) {
+				m_vec_datagram.resize( 1 );
+			}
+			m_vec_datagram[0].assign( MULTICAST_SEQUENCE_BYTES, '\0' ); // ڷʱд
+			Sender_AppendFrame( m_vec_datagram[0], type, code, data );
+			result = Sender_SendDatagram( 1 );
+		}
+		catch( std::exception& ex ) {
+			std::string log_info;
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "鲥Ͷ  Data 쳣{0}", ex.what() );
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+			result = -2;
+		}
+		m_send_lock.unlock();
+
+		if( 0 == result ) {
+			m_stat_message++;
+		}
+		return result;
+	}
+
+	int32_t MulticastSender_P::Sender_SendDataBatch( int32_t type, int32_t code, std::vector<std::string>& vec_data ) {
+		if( false == m_network_running ) {
+			return -4;
+		}
+
+		int32_t result = 0;
+		size_t datagram_number = 0;
+		size_t message_number = 0;
+		m_send_lock.lock();
+		try {
+			for( size_t i = 0; i < vec_data.size(); i++ ) {
+				size_t frame_size = HEAD_BYTES + vec_data[i].length();
+				if( MULTICAST_SEQUENCE_BYTES + frame_size > m_max_datagram_size ) { // ճ
+					std::string log_info;
+					FormatLibrary::StandardLibrary::FormatTo( log_info, "鲥Ͷ  Data Ϣ {0} > {1}", vec_data[i].length(), m_max_datagram_size - MULTICAST_SEQUENCE_BYTES - HEAD_BYTES );
+					LogPrint( syslog_level::c_warn, m_log_cate, log_info );
+					result = -3;
+					continue;
+				}
+				if( 0 == datagram_number || m_vec_datagram[datagram_number - 1].length() + frame_size > m_max_datagram_size ) { // ʼµݱ
+					if( m_vec_datagram.size() <= datagram_number ) {
+						m_vec_datagram.resize( datagram_number + 1 );
+					}
+					m_vec_datagram[datagram_number].assign( MULTICAST_SEQUENCE_BYTES, '\0' );
+					datagram_number++;
+				}
+				Sender_AppendFrame( m_vec_datagram[datagram_number - 1], type, code, vec_data[i] );
+				message_number++;
+			}
+			if( datagram_number > 0 ) {
+				int32_t send_result = Sender_SendDatagram( datagram_number );
+				if( send_result != 0 ) {
+					result = send_result;
+					message_number = 0;
+				}
+			}
+		}
+		catch( std::exception& ex ) {
+			std::string log_info;
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "鲥Ͷ  Data 쳣{0}", ex.what() );
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+			result = -2;
+			message_number = 0;
+		}
+		m_send_lock.unlock();
+
+		m_stat_message += message_number;
+		return result;
+	}
+
+	void MulticastSender_P::Sender_AppendFrame( std::string& datagram, int32_t type, int32_t code, std::string& data ) {
+		char head[HEAD_BYTES];
+		EncodeHeadBinary( head, type, code, 0, (uint32_t)data.length() ); // ն˰ֽԶʶ鲥˾Ϊ°棬ֱʹöưͷ
+		datagram.append( head, HEAD_BYTES );
+		datagram.append( data );
+	}
+
+	int32_t MulticastSender_P::Sender_SendDatagram( size_t datagram_number ) { //  m_send_lock ڵ
+		for( size_t i = 0; i < datagram_number; i++ ) {
+			EncodeSequence( &m_vec_datagram[i][0], ++m_sequence ); // ʧʱҲõն˻Ϊʧ
+		}
+
+#ifdef __OS_LINUX__
+		m_vec_mmsghdr.resize( datagram_number );
+		m_vec_iovec.resize( datagram_number );
+		for( size_t i = 0; i < datagram_number; i++ ) {
+			m_vec_iovec[i].iov_base = &m_vec_datagram[i][0];
+			m_vec_iovec[i].iov_len = m_vec_datagram[i].length();
+			memset( &m_vec_mmsghdr[i], 0, sizeof( mmsghdr ) );
+			m_vec_mmsghdr[i].msg_hdr.msg_name = m_group_endpoint.data();
+			m_vec_mmsghdr[i].msg_hdr.msg_namelen = (socklen_t)m_group_endpoint.size();
+			m_vec_mmsghdr[i].msg_hdr.msg_iov = &m_vec_iovec[i];
+			m_vec_mmsghdr[i].msg_hdr.msg_iovlen = 1;
+		}
+		size_t sent_number = 0;
+		while( sent_number < datagram_number ) { // ׽֣һϵͳ÷ȫ򲿷ݱ
+			int32_t number = sendmmsg( m_socket->native_handle(), &m_vec_mmsghdr[sent_number], (unsigned int)( datagram_number - sent_number ), 0 );
+			if( number < 0 ) {
+				if( EINTR == errno ) {
+					continue;
+				}
+				std::string log_info;
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "鲥Ͷ  ݱ {0}", std::string( strerror( errno ) ) );
+				LogPrint( syslog_level::c_error, m_log_cate, log_info );
+				m_stat_datagram += sent_number;
+				return -2;
+			}
+			sent_number += number;
+		}
+#else
+		for( size_t i = 0; i < datagram_number; i++ ) {
+			boost::system::error_code ec;
+			m_socket->send_to( boost::asio::buffer( m_vec_datagram[i] ), m_group_endpoint, 0, ec );
+			if( ec ) {
+				std::string log_info;
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "鲥Ͷ  ݱ {0}", ec.message().c_str() );
+				LogPrint( syslog_level::c_error, m_log_cate, log_info );
+				m_stat_datagram += i;
+				return -2;
+			}
+		}
+#endif
+
+		m_stat_datagram += datagram_number;
+		return 0;
+	}
+
+	NetMulticastStat MulticastSender_P::Sender_GetStat() {
+		NetMulticastStat multicast_stat;
+		memset( &multicast_stat, 0, sizeof( NetMulticastStat ) );
+		multicast_stat.m_datagram_count = m_stat_datagram;
+		multicast_stat.m_message_count = m_stat_message;
+		return multicast_stat;
+	}
+
+	MulticastReceiver_P::MulticastReceiver_P()
+		: m_net_client_x( nullptr )
+		, m_network_running( false )
+		, m_log_test( 0 )
+		, m_max_datagram_size( MULTICAST_DATAGRAM_MAX )
+		, m_recv_batch_number( MULTICAST_RECV_BATCH )
+		, m_node_type_intern( nullptr )
+		, m_sender_expire( (int64_t)MULTICAST_SENDER_EXPIRE * 1000 )
+		, m_expire_check_time( 0 )
+		, m_recv_time( 0 )
+		, m_retry_wait( 0 )
+		, m_stat_datagram( 0 )
+		, m_stat_message( 0 )
+		, m_stat_gap( 0 )
+		, m_stat_lost( 0 )
+		, m_stat_stale( 0 )
+		, m_log_cate( "<MULTICAST_RECEIVER>" ) {
+		m_syslog = SysLog_S::GetInstance();
+	}
+
+	MulticastReceiver_P::~MulticastReceiver_P() {
+		if( m_service.get() ) {
+			m_service->stop();
+		}
+		if( m_thread_multicast_receiver.joinable() ) {
+			m_thread_multicast_receiver.join();
+		}
+	}
+
+	void MulticastReceiver_P::ComponentInstance( NetClient_X* net_client_x ) {
+		m_net_client_x = net_client_x;
+	}
+
+	void MulticastReceiver_P::LogPrint( syslog_level log_level, std::string& log_cate, std::string& log_info, int32_t log_show/* = 0*/ ) {
+		m_syslog->LogWrite( log_level, log_cate, log_info );
+		m_syslog->LogPrint( log_level, log_cate, "LOG>: " + log_info ); // ̨
+	}
+
+	void MulticastReceiver_P::Thread_MulticastReceiver() {
+		std::string log_info;
+
+		try {
+			boost::asio::io_service::work work( *m_service );
+			m_network_running = true;
+			m_service->run();
+		}
+		catch( std::exception& ex ) {
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "鲥ն ͨŷ 쳣{0}", ex.what() );
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+		}
+		catch( ... ) {
+			log_info = "鲥ն ͨŷ̷߳δ֪";
+			LogPrint( syslog_level::c_fatal, m_log_cate, log_info );
+		}
+
+		m_network_running = false;
+
+		log_info = "鲥ն ͨŷ߳˳";
+		LogPrint( syslog_level::c_warn, m_log_cate, log_info );
+	}
+
+	bool MulticastReceiver_P::StartNetwork( NetMulticastCfg& config, std::string node_type ) {
+		std::string log_info;
+
+		try {
+			m_log_test = config.m_log_test;
+			m_max_datagram_size = config.m_max_datagram_size > 0 ? std::min( config.m_max_datagram_size, (size_t)MULTICAST_DATAGRAM_LIMIT ) : MULTICAST_DATAGRAM_MAX;
+			m_recv_batch_number = config.m_recv_batch_number > 0 ? config.m_recv_batch_number : MULTICAST_RECV_BATCH;
+			m_sender_expire = (int64_t)( config.m_sender_expire > 0 ? config.m_sender_expire : MULTICAST_SENDER_EXPIRE ) * 1000;
+			m_expire_check_time = GetSteadyTimeMs() + m_sender_expire;
+			m_node_type = node_type;
+			m_node_type_intern = InternNodeType( m_node_type );
+			FormatLibrary::StandardLibrary::FormatTo( m_endpoint_l, "udp://{0}:{1}", config.m_group_address, config.m_group_port );
+
+			boost::asio::ip::address group_address = boost::asio::ip::address::from_string( config.m_group_address );
+			boost::asio::ip::udp::endpoint listen_endpoint( group_address.is_v4() ? boost::asio::ip::udp::v4() : boost::asio::ip::udp::v6(), (unsigned short)config.m_group_port ); // Windows ²ܰ鲥ַ
+
+			m_service = std::make_shared<boost::asio::io_service>();
+			m_socket = std::make_shared<boost::asio::ip::udp::socket>( *m_service );
+			m_retry_timer = std::make_shared<boost::asio::steady_timer>( *m_service );
+			m_socket->open( listen_endpoint.protocol() );
+			m_socket->set_option( boost::asio::ip::udp::socket::reuse_address( true ) ); // ͬһжն
+			if( config.m_recv_buffer_size > 0 ) {
+				m_socket->set_option( boost::asio::socket_base::receive_buffer_size( config.m_recv_buffer_size ) );
+			}
+			m_socket->bind( listen_endpoint );
+			if( group_address.is_v4() && config.m_interface_address != "" && config.m_interface_address != "0.0.0.0" ) {
+				m_socket->set_option( boost::asio::ip::multicast::join_group( group_address.to_v4(), boost::asio::ip::address_v4::from_string( config.m_interface_address ) ) );
+			}
+			else {
+				m_socket->set_option( boost::asio::ip::multicast::join_group( group_address ) );
+			}
+			m_socket->non_blocking( true ); // ɶһ
+
+			m_vec_recv_buf.resize( m_recv_batch_number );
+			for( int32_t i = 0; i < m_recv_batch_number; i++ ) {
+				m_vec_recv_buf[i] = MakeRecvBuf( m_max_datagram_size );
+			}
+			m_vec_sender_endpoint.resize( m_recv_batch_number );
+#ifdef __OS_LINUX__
+			m_vec_mmsghdr.resize( m_recv_batch_number );
+			m_vec_iovec.resize( m_recv_batch_number );
+#endif
+
+			Receiver_StartRecv();
+			m_thread_multicast_receiver = std::thread( &MulticastReceiver_P::Thread_MulticastReceiver, this );
+			while( false == m_network_running ) {
+				std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+			}
+
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "鲥ն {0}{1}", m_endpoint_l, m_node_type );
+			LogPrint( syslog_level::c_info, m_log_cate, log_info );
+		}
+		catch( std::exception& ex ) {
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "鲥ն  udp://{0}:{1} 쳣{2}", config.m_group_address, config.m_group_port, ex.what() );
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+			return false;
+		}
+
+		return true;
+	}
+
+	bool MulticastReceiver_P::IsNetworkStarted() {
+		return m_network_running;
+	}
+
+	void MulticastReceiver_P::Receiver_StartRecv() {
+		m_socket->async_receive( boost::asio::null_buffers(), boost::bind( &MulticastReceiver_P::Receiver_HandleRecv, this, boost::asio::placeholders::error ) );
+	}
+
+	void MulticastReceiver_P::Receiver_RetryRecv() {
+		m_retry_wait = 0 == m_retry_wait ? MULTICAST_RETRY_MIN : std::min( m_retry_wait * 2, MULTICAST_RETRY_MAX );
+		m_retry_timer->expires_from_now( std::chrono::milliseconds( m_retry_wait ) );
+		m_retry_timer->async_wait( boost::bind( &MulticastReceiver_P::Receiver_HandleRetry, this, boost::asio::placeholders::error ) );
+	}
+
+	void MulticastReceiver_P::Receiver_HandleRetry( const boost::system::error_code& error ) {
+		if( boost::asio::error::operation_aborted == error ) {
+			return;
+		}
+		Receiver_StartRecv();
+	}
+
+	void MulticastReceiver_P::Receiver_HandleRecv( const boost::system::error_code& error ) {
+		if( boost::asio::error::operation_aborted == error ) {
+			return;
+		}
+
+		bool recv_error = false;
+		if( error ) {
+			recv_error = true;
+			if( m_retry_wait < MULTICAST_RETRY_MAX ) { // ʱȴѵ޺ظ¼
+				std::string log_info;
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "鲥ն ȴ ݱ {0}", error.message().c_str() );
+				LogPrint( syslog_level::c_error, m_log_cate, log_info );
+			}
+		}
+		else {
+			try {
+				m_recv_time = GetSteadyTimeMs();
+				int32_t number = 0;
+				while( ( number = Receiver_RecvBatch() ) == m_recv_batch_number ) { // һ˵ܻУȡ
+				}
+				recv_error = number < 0;
+				if( m_recv_time >= m_expire_check_time ) {
+					Receiver_ExpireSender( m_recv_time );
+				}
+			}
+			catch( std::exception& ex ) {
+				std::string log_info;
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "鲥ն  ݱ 쳣{0}", ex.what() );
+				LogPrint( syslog_level::c_error, m_log_cate, log_info );
+			}
+		}
+
+		if( true == recv_error ) { // ׽ֳʱµȴת
+			Receiver_RetryRecv();
+		}
+		else {
+			m_retry_wait = 0;
+			Receiver_StartRecv();
+		}
+	}
+
+	void MulticastReceiver_P::Receiver_ExpireSender( int64_t now_time ) {
+		std::string log_info;
+
+		for( auto it_ns = m_map_next_sequence.begin(); it_ns != m_map_next_sequence.end(); ) {
+			if( now_time - it_ns->second.m_active_time >= m_sender_expire ) {
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "鲥ն ĬͶˣ[{0}]<-[udp://{1}:{2}]", m_endpoint_l, it_ns->first.address().to_string(), it_ns->first.port() );
+				LogPrint( syslog_level::c_info, m_log_cate, log_info );
+				it_ns = m_map_next_sequence.erase( it_ns );
+			}
+			else {
+				it_ns++;
+			}
+		}
+		m_expire_check_time = now_time + m_sender_expire / 2; // ĬķͶ 1.5 ʱڱ
+	}
+
+	int32_t MulticastReceiver_P::Receiver_RecvBatch() {
+		for( int32_t i = 0; i < m_recv_batch_number; i++ ) {
+			if( m_vec_recv_buf[i].use_count() > 1 ) { // ѱصȡȨ»
+				m_vec_recv_buf[i] = MakeRecvBuf( m_max_datagram_size );
+			}
+		}
+
+		int32_t number = 0;
+#ifdef __OS_LINUX__
+		for( int32_t i = 0; i < m_recv_batch_number; i++ ) {
+			m_vec_iovec[i].iov_base = m_vec_recv_buf[i].get();
+			m_vec_iovec[i].iov_len = m_max_datagram_size;
+			memset( &m_vec_mmsghdr[i], 0, sizeof( mmsghdr ) );
+			m_vec_mmsghdr[i].msg_hdr.msg_name = m_vec_sender_endpoint[i].data();
+			m_vec_mmsghdr[i].msg_hdr.msg_namelen = (socklen_t)m_vec_sender_endpoint[i].capacity();
+			m_vec_mmsghdr[i].msg_hdr.msg_iov = &m_vec_iovec[i];
+			m_vec_mmsghdr[i].msg_hdr.msg_iovlen = 1;
+		}
+		number = recvmmsg( m_socket->native_handle(), &m_vec_mmsghdr[0], (unsigned int)m_recv_batch_number, MSG_DONTWAIT, nullptr ); // һϵͳȡݱ
+		if( number < 0 ) {
+			if( EAGAIN == errno || EWOULDBLOCK == errno || EINTR == errno ) {
+				return 0;
+			}
+			if( m_retry_wait < MULTICAST_RETRY_MAX ) { // ʱȴѵ޺ظ¼
+				std::string log_info;
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "鲥ն  ݱ {0}", std::string( strerror( errno ) ) );
+				LogPrint( syslog_level::c_error, m_log_cate, log_info );
+			}
+			return -1;
+		}
+		for( int32_t i = 0; i < number; i++ ) {
+			if( m_vec_mmsghdr[i].msg_hdr.msg_flags & MSG_TRUNC ) {
+				std::string log_info;
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "鲥ն յ ݱѽض϶ݱޣ{0}", m_max_datagram_size );
+				LogPrint( syslog_level::c_error, m_log_cate, log_info );
+				continue;
+			}
+			m_vec_sender_endpoint[i].resize( m_vec_mmsghdr[i].msg_hdr.msg_namelen );
+			Receiver_HandleDatagram( i, m_vec_mmsghdr[i].msg_len, m_vec_sender_endpoint[i] );
+		}
+#else
+		for( ; number < m_recv_batch_number; number++ ) { // ׽֣յΪֹ
+			boost::system::error_code ec;
+			size_t size = m_socket->receive_from( boost::asio::buffer( m_vec_recv_buf[number].get(), m_max_datagram_size ), m_vec_sender_endpoint[number], 0, ec );
+			if( boost::asio::error::would_block == ec ) {
+				break;
+			}
+			if( boost::asio::error::message_size == ec ) { // ݱֻһ
+				std::string log_info;
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "鲥ն յ ݱѽض϶ݱޣ{0}", m_max_datagram_size );
+				LogPrint( syslog_level::c_error, m_log_cate, log_info );
+				continue;
+			}
+			if( ec ) { // ɵ˱
+				if( m_retry_wait < MULTICAST_RETRY_MAX ) {
+					std::string log_info;
+					FormatLibrary::StandardLibrary::FormatTo( log_info, "鲥ն  ݱ {0}", ec.message().c_str() );
+					LogPrint( syslog_level::c_error, m_log_cate, log_info );
+				}
+				return -1;
+			}
+			Receiver_HandleDatagram( number, size, m_vec_sender_endpoint[number] );
+		}
+#endif
+		return number;
+	}
+
+	void MulticastReceiver_P::Receiver_HandleDatagram( int32_t index, size_t size, const boost::asio::ip::udp::endpoint& sender_endpoint ) {
+		m_stat_datagram++;
+
+		const char* datagram = m_vec_recv_buf[index].get();
+		if( size < MULTICAST_SEQUENCE_BYTES ) {
+			std::string log_info;
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "鲥ն յ 쳣ݱС{0}", size );
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+			return;
+		}
+
+		if( false == Receiver_CheckSequence( DecodeSequence( datagram ), sender_endpoint ) ) {
+			return;
+		}
+
+		size_t offset = MULTICAST_SEQUENCE_BYTES;
+		while( offset < size ) {
+			FrameHead frame_head; // ıưͷֽԶʶ
+			if( size - offset < HEAD_BYTES || false == DecodeHead( datagram + offset, frame_head ) || frame_head.m_size > size - offset - HEAD_BYTES ) {
+				std::string log_info;
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "鲥ն յ ǷݰݱС{0}λã{1}", size, offset );
+				LogPrint( syslog_level::c_error, m_log_cate, log_info );
+				return;
+			}
+
+			if( 1 == m_log_test ) {
+				std::string log_info;
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "<--[{0}]Type:{1} Code:{2} Size:{3}", m_endpoint_l, frame_head.m_type, frame_head.m_code, frame_head.m_size );
+				LogPrint( syslog_level::c_info, m_log_cate, log_info );
+			}
+
+			if( frame_head.m_type >= NW_MSG_USER_TYPE_MIN && frame_head.m_type <= NW_MSG_USER_TYPE_MAX && frame_head.m_size > 0 ) {
+				m_stat_message++;
+				try {
+					if( m_net_client_x != nullptr ) {
+						NetClientView net_client_view; // ֱָջ
+						net_client_view.m_node_type = m_node_type_intern;
+						net_client_view.m_identity = 0;
+						net_client_view.m_code = frame_head.m_code;
+						net_client_view.m_data = datagram + offset + HEAD_BYTES;
+						net_client_view.m_size = frame_head.m_size;
+						net_client_view.m_data_owner = &m_vec_recv_buf[index];
+						m_net_client_x->OnNetClientView( net_client_view );
+					}
+				}
+				catch( ... ) {
+					std::string log_info;
+					log_info = "鲥ն  Data  ת δ֪";
+					LogPrint( syslog_level::c_error, m_log_cate, log_info );
+				}
+			}
+
+			offset += HEAD_BYTES + frame_head.m_size;
+		}
+	}
+
+	bool MulticastReceiver_P::Receiver_CheckSequence( uint64_t sequence, const boost::asio::ip::udp::endpoint& sender_endpoint ) {
+		std::string log_info;
+
+		auto it_ns = m_map_next_sequence.find( sender_endpoint );
+		if( it_ns == m_map_next_sequence.end() ) { // ;Ĭյĵһݱʼ
+			SenderState& sender_state = m_map_next_sequence[sender_endpoint];
+			sender_state.m_next_sequence = sequence + 1;
+			sender_state.m_active_time = m_recv_time;
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "鲥ն Ͷˣ[{0}]<-[udp://{1}:{2}]", m_endpoint_l, sender_endpoint.address().to_string(), sender_endpoint.port() );
+			LogPrint( syslog_level::c_info, m_log_cate, log_info );
+			return true;
+		}
+
+		it_ns->second.m_active_time = m_recv_time;
+		uint64_t& next_sequence = it_ns->second.m_next_sequence;
+		if( sequence == next_sequence ) {
+			next_sequence++;
+			return true;
+		}
+
+		if( sequence > next_sequence ) { // мݱѶʧUDP شϲǷв
+			m_stat_gap++;
+			m_stat_lost += sequence - next_sequence;
+
+			std::string endpoint_r;
+			FormatLibrary::StandardLibrary::FormatTo( endpoint_r, "udp://{0}:{1}", sender_endpoint.address().to_string(), sender_endpoint.port() );
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "鲥ն Ծ[{0}]<-[{1}]  {2} յ {3}", m_endpoint_l, endpoint_r, next_sequence, sequence );
+			LogPrint( syslog_level::c_warn, m_log_cate, log_info );
+
+			next_sequence = sequence + 1;
+
+			if( nullptr != m_net_client_x ) {
+				NetClientInfo net_client_info( WM_MY_MULTICAST_GAP, m_node_type, 0, m_endpoint_l, endpoint_r ); // ͨģ鲥ռ⵽Ծ
+				m_net_client_x->OnNetClientInfo( net_client_info );
+			}
+			return true;
+		}
+
+		if( 1 == sequence ) { // Ͷ
+			next_sequence = 2;
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "鲥ն Ͷ[{0}]<-[udp://{1}:{2}]", m_endpoint_l, sender_endpoint.address().to_string(), sender_endpoint.port() );
+			LogPrint( syslog_level::c_warn, m_log_cate, log_info );
+			return true;
+		}
+
+		m_stat_stale++; // ظٵ
+		return false;
+	}
+
+	NetMulticastStat MulticastReceiver_P::Receiver_GetStat() {
+		NetMulticastStat multicast_stat;
+		multicast_stat.m_datagram_count = m_stat_datagram;
+		multicast_stat.m_message_count = m_stat_message;
+		multicast_stat.m_gap_count = m_stat_gap;
+		multicast_stat.m_lost_count = m_stat_lost;
+		multicast_stat.m_stale_count = m_stat_stale;
+		return multicast_stat;
+	}
+
+	MulticastSender::MulticastSender()
+		: m_multicast_sender_p( nullptr ) {
+		try {
+			m_multicast_sender_p = new MulticastSender_P();
+		}
+		catch( ... ) {}
+	}
+
+	MulticastSender::~MulticastSender() {
+		if( m_multicast_sender_p != nullptr ) {
+			delete m_multicast_sender_p;
+			m_multicast_sender_p = nullptr;
+		}
+	}
+
+	bool MulticastSender::StartNetwork( NetMulticastCfg& config ) {
+		return m_multicast_sender_p->StartNetwork( config );
+	}
+
+	bool MulticastSender::IsNetworkStarted() {
+		return m_multicast_sender_p->IsNetworkStarted();
+	}
+
+	int32_t MulticastSender::Sender_SendData( int32_t type, int32_t code, std::string& data ) {
+		return m_multicast_sender_p->Sender_SendData( type, code, data );
+	}
+
+	int32_t MulticastSender::Sender_SendDataBatch( int32_t type, int32_t code, std::vector<std::string>& vec_data ) {
+		return m_multicast_sender_p->Sender_SendDataBatch( type, code, vec_data );
+	}
+
+	NetMulticastStat MulticastSender::Sender_GetStat() {
+		return m_multicast_sender_p->Sender_GetStat();
+	}
+
+	MulticastReceiver::MulticastReceiver()
+		: m_multicast_receiver_p( nullptr ) {
+		try {
+			m_multicast_receiver_p = new MulticastReceiver_P();
+		}
+		catch( ... ) {}
+	}
+
+	MulticastReceiver::~MulticastReceiver() {
+		if( m_multicast_receiver_p != nullptr ) {
+			delete m_multicast_receiver_p;
+			m_multicast_receiver_p = nullptr;
+		}
+	}
+
+	void MulticastReceiver::ComponentInstance( NetClient_X* net_client_x ) {
+		m_multicast_receiver_p->ComponentInstance( net_client_x );
+	}
+
+	bool MulticastReceiver::StartNetwork( NetMulticastCfg& config, std::string node_type ) {
+		return m_multicast_receiver_p->StartNetwork( config, node_type );
+	}
+
+	bool MulticastReceiver::IsNetworkStarted() {
+		return m_multicast_receiver_p->IsNetworkStarted();
+	}
+
+	NetMulticastStat MulticastReceiver::Receiver_GetStat() {
+		return m_multicast_receiver_p->Receiver_GetStat();
+	}
+
+} // namespace basicx
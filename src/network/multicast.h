@@ -0,0 +1,114 @@
+/*
+* Copyright (c) 2017-2018 the BasicX authors
+* All rights reserved.
+*
+* The project sponsor and lead author is Xu Rendong.
+* E-mail: xrd@ustc.edu, QQ: 277195007, WeChat: ustc_xrd
+* See the contributors file for names of other contributors.
+*
+* Commercial use of this code in source and binary forms is
+* governed by a LGPL v3 license. You may get a copy from the
+* root directory. Or else you should get a specific written
+* permission from the project author.
+*
+* Individual and educational use of this code in source and
+* binary forms is governed by a 3-clause BSD license. You may
+* get a copy from the root directory. Certainly welcome you
+* to contribute code of all sorts.
+*
+* Be sure to retain the above copyright notice and conditions.
+*/
+
+#ifndef BASICX_NETWORK_MULTICAST_H
+#define BASICX_NETWORK_MULTICAST_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include <common/compile.h>
+
+#include "client.h"
+
+namespace basicx {
+
+	#define MULTICAST_DATAGRAM_MAX 1472 // ̫ MTU 1500 - IP ͷ 20 - UDP ͷ 8ᱻƬһƬݱ
+	#define MULTICAST_DATAGRAM_LIMIT 65507 // UDP ݱ
+	#define MULTICAST_RECV_BATCH 64 // һϵͳȡݱ
+	#define MULTICAST_SENDER_EXPIRE 300 // 룬Ͷ˾Ĭʱż¼
+
+	#pragma pack( push )
+	#pragma pack( 1 )
+
+	struct NetMulticastCfg //  // Աᱻֵ
+	{
+		int32_t m_log_test;
+		std::string m_group_address; // 鲥ַ 239.255.0.1
+		int32_t m_group_port;
+		std::string m_interface_address; // ַ0.0.0.0 ΪϵͳĬ
+		int32_t m_ttl; // Ͷˣ1 Ϊ
+		bool m_loopback; // ͶˣĽնǷҲյزʱ
+		size_t m_max_datagram_size; // շһ£Ĭ MULTICAST_DATAGRAM_MAX MULTICAST_DATAGRAM_LIMIT
+		int32_t m_recv_batch_number; // նˣĬ MULTICAST_RECV_BATCH
+		int32_t m_recv_buffer_size; // նˣ׽ֽջ棬߷ʱӴں˶0 ΪϵͳĬ
+		int32_t m_sender_expire; // նˣ룬Ͷ˾Ĭʱż¼յʱ¼봦Ĭ MULTICAST_SENDER_EXPIRE
+	};
+
+	struct NetMulticastStat // 鲥շͳ
+	{
+		uint64_t m_datagram_count; // ͻյݱ
+		uint64_t m_message_count; // ͻյϢ
+		uint64_t m_gap_count; // նˣ⵽ԾĴ
+		uint64_t m_lost_count; // նˣݱ
+		uint64_t m_stale_count; // նˣظٵݱ
+	};
+
+	#pragma pack( pop )
+
+	class MulticastSender_P;
+
+	// 鲥ͶˣݱΪ 8 ֽżһݰݰʽ TCP ̵ͬ߳
+	class BASICX_NETWORK_EXPIMP MulticastSender
+	{
+	public:
+		MulticastSender();
+		~MulticastSender();
+
+	public:
+		bool StartNetwork( NetMulticastCfg& config );
+		bool IsNetworkStarted();
+
+		int32_t Sender_SendData( int32_t type, int32_t code, std::string& data ); // Ϣݱ
+		int32_t Sender_SendDataBatch( int32_t type, int32_t code, std::vector<std::string>& vec_data ); // ϲΪٵݱLinux  sendmmsg() һη
+		NetMulticastStat Sender_GetStat();
+
+	private:
+		MulticastSender_P* m_multicast_sender_p;
+	};
+
+	class MulticastReceiver_P;
+
+	// 鲥նˣͶ˷ֱţԾʱ WM_MY_MULTICAST_GAP  OnNetClientInfo()
+	// ݾ OnNetClientView() ͣ鲥ӣm_identity Ϊ 0
+	class BASICX_NETWORK_EXPIMP MulticastReceiver
+	{
+	public:
+		MulticastReceiver();
+		~MulticastReceiver();
+
+	public:
+		void ComponentInstance( NetClient_X* net_client_x );
+
+	public:
+		bool StartNetwork( NetMulticastCfg& config, std::string node_type );
+		bool IsNetworkStarted();
+
+		NetMulticastStat Receiver_GetStat();
+
+	private:
+		MulticastReceiver_P* m_multicast_receiver_p;
+	};
+
+} // namespace basicx
+
+#endif // BASICX_NETWORK_MULTICAST_H
@@ -0,0 +1,171 @@
+/*
+* Copyright (c) 2017-2018 the BasicX authors
+* All rights reserved.
+*
+* The project sponsor and lead author is Xu Rendong.
+* E-mail: xrd@ustc.edu, QQ: 277195007, WeChat: ustc_xrd
+* See the contributors file for names of other contributors.
+*
+* Commercial use of this code in source and binary forms is
+* governed by a LGPL v3 license. You may get a copy from the
+* root directory. Or else you should get a specific written
+* permission from the project author.
+*
+* Individual and educational use of this code in source and
+* binary forms is governed by a 3-clause BSD license. You may
+* get a copy from the root directory. Certainly welcome you
+* to contribute code of all sorts.
+*
+* Be sure to retain the above copyright notice and conditions.
+*/
+
+#ifndef BASICX_NETWORK_MULTICAST_P_H
+#define BASICX_NETWORK_MULTICAST_P_H
+
+#include <common/sysdef.h>
+
+#include "struct.h"
+#include "multicast.h"
+
+#ifdef __OS_LINUX__
+#include <sys/socket.h> // recvmmsgsendmmsg
+#endif
+
+namespace basicx {
+
+	#define MULTICAST_SEQUENCE_BYTES 8 // ݱſͷuint64 СˣÿͶ˴ 1 ʼ
+	#define MULTICAST_RETRY_MIN 10 // 룬ճ״Եȴʱμӱ
+	#define MULTICAST_RETRY_MAX 5000 // 룬ճԵȴ
+
+	typedef std::shared_ptr<boost::asio::ip::udp::socket> UdpSocketPtr;
+
+	inline void EncodeSequence( char* data, uint64_t sequence ) {
+		for( int32_t i = 0; i < MULTICAST_SEQUENCE_BYTES; i++ ) {
+			data[i] = (char)( sequence >> ( i * 8 ) );
+		}
+	}
+
+	inline uint64_t DecodeSequence( const char* data ) {
+		const uint8_t* p = (const uint8_t*)data;
+		uint64_t sequence = 0;
+		for( int32_t i = MULTICAST_SEQUENCE_BYTES - 1; i >= 0; i-- ) {
+			sequence = ( sequence << 8 ) | p[i];
+		}
+		return sequence;
+	}
+
+	class SysLog_S;
+
+	class MulticastSender_P
+	{
+	public:
+		MulticastSender_P();
+		~MulticastSender_P();
+
+	public:
+		void LogPrint( syslog_level log_level, std::string& log_cate, std::string& log_info, int32_t log_show = 0 );
+
+	public:
+		bool StartNetwork( NetMulticastCfg& config );
+		bool IsNetworkStarted();
+
+		int32_t Sender_SendData( int32_t type, int32_t code, std::string& data );
+		int32_t Sender_SendDataBatch( int32_t type, int32_t code, std::vector<std::string>& vec_data );
+		void Sender_AppendFrame( std::string& datagram, int32_t type, int32_t code, std::string& data );
+		int32_t Sender_SendDatagram( size_t datagram_number );
+		NetMulticastStat Sender_GetStat();
+
+	public:
+		ServicePtr m_service; // ֻڴ׽֣ڵ߳ͬ
+		UdpSocketPtr m_socket;
+		boost::asio::ip::udp::endpoint m_group_endpoint;
+		bool m_network_running;
+		int32_t m_log_test;
+		size_t m_max_datagram_size;
+
+		std::mutex m_send_lock;
+		uint64_t m_sequence; //  m_send_lock ʹ
+		std::vector<std::string> m_vec_datagram; // ã m_send_lock ʹ
+#ifdef __OS_LINUX__
+		std::vector<mmsghdr> m_vec_mmsghdr;
+		std::vector<iovec> m_vec_iovec;
+#endif
+
+		std::atomic<uint64_t> m_stat_datagram;
+		std::atomic<uint64_t> m_stat_message;
+
+		std::string m_log_cate;
+		SysLog_S* m_syslog;
+	};
+
+	class MulticastReceiver_P
+	{
+	public:
+		MulticastReceiver_P();
+		~MulticastReceiver_P();
+
+		void ComponentInstance( NetClient_X* net_client_x );
+
+	public:
+		void LogPrint( syslog_level log_level, std::string& log_cate, std::string& log_info, int32_t log_show = 0 );
+
+	public:
+		void Thread_MulticastReceiver();
+		bool StartNetwork( NetMulticastCfg& config, std::string node_type );
+		bool IsNetworkStarted();
+
+		void Receiver_StartRecv();
+		void Receiver_RetryRecv(); // ճ˱ʱȴ¿ʼ
+		void Receiver_HandleRetry( const boost::system::error_code& error );
+		void Receiver_HandleRecv( const boost::system::error_code& error );
+		void Receiver_ExpireSender( int64_t now_time );
+		int32_t Receiver_RecvBatch(); // յݱʱΪ -1
+		void Receiver_HandleDatagram( int32_t index, size_t size, const boost::asio::ip::udp::endpoint& sender_endpoint );
+		bool Receiver_CheckSequence( uint64_t sequence, const boost::asio::ip::udp::endpoint& sender_endpoint );
+		NetMulticastStat Receiver_GetStat();
+
+	public:
+		NetClient_X* m_net_client_x;
+		ServicePtr m_service;
+		UdpSocketPtr m_socket;
+		std::thread m_thread_multicast_receiver;
+		std::atomic<bool> m_network_running;
+		int32_t m_log_test;
+		size_t m_max_datagram_size;
+		int32_t m_recv_batch_number;
+		std::string m_node_type;
+		const std::string* m_node_type_intern;
+		std::string m_endpoint_l; // "udp://239.255.0.1:6000"
+
+		std::vector<std::shared_ptr<char>> m_vec_recv_buf; // ÿݱһ飬ʱɱȡȨʱ軻»
+		std::vector<boost::asio::ip::udp::endpoint> m_vec_sender_endpoint;
+#ifdef __OS_LINUX__
+		std::vector<mmsghdr> m_vec_mmsghdr;
+		std::vector<iovec> m_vec_iovec;
+#endif
+		struct SenderState
+		{
+			uint64_t m_next_sequence; // һ
+			int64_t m_active_time; // 룬һյݱʱ
+		};
+
+		std::map<boost::asio::ip::udp::endpoint, SenderState> m_map_next_sequence; // Ͷ˵ż¼Ĭ m_sender_expire ı߳ʹ
+		int64_t m_sender_expire; // 
+		int64_t m_expire_check_time; // 룬´μ龲ĬͶ˵ʱ
+		int64_t m_recv_time; // 룬ֽյʱ
+		SteadyTimerPtr m_retry_timer;
+		int32_t m_retry_wait; // 룬0 Ϊδ˱
+
+		std::atomic<uint64_t> m_stat_datagram;
+		std::atomic<uint64_t> m_stat_message;
+		std::atomic<uint64_t> m_stat_gap;
+		std::atomic<uint64_t> m_stat_lost;
+		std::atomic<uint64_t> m_stat_stale;
+
+		std::string m_log_cate;
+		SysLog_S* m_syslog;
+	};
+
+} // namespace basicx
+
+#endif // BASICX_NETWORK_MULTICAST_P_H
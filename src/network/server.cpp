@@ -23,8 +23,16 @@
 #include <iomanip> // std::setw
 #include <iostream>
 
+#include <common/sysdef.h>
+
 #include "server_.h"
 
+#ifdef __OS_WINDOWS__
+#include <windows.h> // SetThreadAffinityMask boost/asio.hpp ֮
+#else
+#include <pthread.h>
+#endif
+
 namespace basicx {
 
 	NetServerInfo::NetServerInfo( int32_t info_type, std::string& node_type, int32_t identity, std::string& endpoint_l, std::string& endpoint_r )
@@ -38,7 +46,8 @@ namespace basicx {
 	NetServerData::NetServerData( std::string& node_type, int32_t identity, int32_t code, std::string& data )
 		: m_node_type( node_type )
 		, m_identity( identity )
-		, m_code( code ) {
+		, m_code( code )
+		, m_request_id( 0 ) {
 		m_data = std::move( data ); // ʹ std::string& m_data; Ȼ m_data( data ) һ
 	}
 
@@ -48,15 +57,35 @@ namespace basicx {
 	NetServer_X::~NetServer_X() {
 	}
 
+	void NetServer_X::OnNetServerView( NetServerView& net_server_view ) {
+		std::string data( net_server_view.m_data, net_server_view.m_size );
+		NetServerData net_server_data( const_cast<std::string&>( *net_server_view.m_node_type ), net_server_view.m_identity, net_server_view.m_code, data ); // std::move( data )
+		net_server_data.m_request_id = net_server_view.m_request_id;
+		OnNetServerData( net_server_data );
+	}
+
+	std::shared_ptr<const char> NetServerView::TakeData() const {
+		return std::shared_ptr<const char>( *m_data_owner, m_data ); // ջ棬ģ鷢ֱкỻ»
+	}
+
 	NetServer_P::NetServer_P()
 		: m_net_server_x( nullptr )
 		, m_network_running( false )
-		, m_identity_count( 0 )
-		, m_unique_lock( m_sender_lock )
-		, m_sender_vector_1( nullptr )
-		, m_sender_vector_2( nullptr )
-		, m_sender_vector_read( nullptr )
-		, m_sender_vector_write( nullptr )
+		, m_shard_number( 0 )
+		, m_shard_cpu_affinity( false )
+		, m_shard_round( 0 )
+		, m_sender_waiting( false )
+		, m_sender_ring( nullptr )
+		, m_sender_policy( -1 ) // δ
+		, m_sender_spill_count( 0 )
+		, m_stat_send_count( 0 )
+		, m_stat_write_count( 0 )
+		, m_stat_drop_count( 0 )
+		, m_stat_block_count( 0 )
+		, m_stat_grow_count( 0 )
+		, m_shm_running( false )
+		, m_shm_slot_number( SHM_SLOT_NUMBER )
+		, m_shm_ring_size( SHM_RING_SIZE )
 		, m_sender_running( false )
 		, m_log_test( 0 )
 		, m_heart_check_time( 10 )
@@ -65,34 +94,65 @@ namespace basicx {
 		, m_client_connect_timeout( 2000 )
 		, m_max_connect_total_s( 1000 )
 		, m_max_data_length_s( 102400 )
+		, m_idle_timeout_s( 0 ) // 0 Ϊ
+		, m_binary_head_s( true )
+		, m_recv_buf_size_s( 65536 )
 		, m_total_local_connect( 0 )
 		, m_log_cate( "<NET_SERVER>" ) {
 		m_syslog = SysLog_S::GetInstance();
+		NetMetricsRegistry::Register( this );
 	}
 
 	NetServer_P::~NetServer_P() {
+		NetMetricsRegistry::Unregister( this ); // ӣղٷʱʵ
+		if( true == m_shm_running ) {
+			m_shm_running = false;
+			m_shm_thread.join();
+		}
+
 		m_sender_running = false;
 		m_sender_condition.notify_all();
 		m_sender_thread.join();
-		if( m_sender_vector_1 != nullptr ) {
-			delete m_sender_vector_1;
-		}
-		if( m_sender_vector_2 != nullptr ) {
-			delete m_sender_vector_2;
-		}
 
 		if( true == m_network_running ) {
 			m_network_running = false;
-			m_service->stop();
+			for( size_t i = 0; i < m_vec_shard.size(); i++ ) {
+				m_vec_shard[i]->m_service->stop();
+			}
+		}
+
+		for( auto it_sb = m_list_sender_spill.begin(); it_sb != m_list_sender_spill.end(); it_sb++ ) {
+			delete (*it_sb);
+		}
+		m_list_sender_spill.clear();
+		if( m_sender_ring != nullptr ) {
+			delete m_sender_ring;
+			m_sender_ring = nullptr;
 		}
 
-		for( auto it_ci = m_list_local_info.begin(); it_ci != m_list_local_info.end(); it_ci++ ) {
-			if( (*it_ci) != nullptr ) {
-				(*it_ci)->clear();
-				delete (*it_ci);
-				(*it_ci) = nullptr;
+		for( size_t i = 0; i < m_vec_send_pool.size(); i++ ) {
+			delete m_vec_send_pool[i];
+		}
+		m_vec_send_pool.clear();
+
+		for( size_t i = 0; i < m_vec_shard.size(); i++ ) {
+			std::vector<ConnectInfo*> vec_local_info;
+			m_vec_shard[i]->m_connect_table->Collect( vec_local_info );
+			for( size_t j = 0; j < vec_local_info.size(); j++ ) {
+				for( size_t k = 0; k < vec_local_info[j]->m_vec_send_pending.size(); k++ ) { // ֹͣδдĲٻص黹
+					delete vec_local_info[j]->m_vec_send_pending[k];
+				}
+				for( size_t k = 0; k < vec_local_info[j]->m_vec_send_writing.size(); k++ ) {
+					delete vec_local_info[j]->m_vec_send_writing[k];
+				}
+				vec_local_info[j]->clear();
+				delete vec_local_info[j];
 			}
+			delete m_vec_shard[i]->m_connect_table;
+			delete m_vec_shard[i]->m_heart_wheel;
+			delete m_vec_shard[i];
 		}
+		m_vec_shard.clear();
 
 		for( auto it_li = m_map_listen_info.begin(); it_li != m_map_listen_info.end(); it_li++ ) {
 			if( it_li->second != nullptr ) {
@@ -101,6 +161,11 @@ namespace basicx {
 			}
 		}
 
+		for( size_t i = 0; i < m_vec_shm_listen.size(); i++ ) { // еƬӱɾ
+			delete m_vec_shm_listen[i];
+		}
+		m_vec_shm_listen.clear();
+
 		for( auto it_di = m_list_disconnect_info.begin(); it_di != m_list_disconnect_info.end(); it_di++ ) {
 			if( (*it_di) != nullptr ) {
 				// (*it_di)->clear(); // ʱ
@@ -119,29 +184,6 @@ namespace basicx {
 		m_syslog->LogPrint( log_level, log_cate, "LOG>: " + log_info ); // ̨
 	}
 
-	void NetServer_P::Thread_ServerOnTime() {
-		std::string log_info;
-
-		log_info = " ͨŶʱ߳, ʼͨŶʱ ...";
-		LogPrint( syslog_level::c_info, m_log_cate, log_info );
-
-		try {
-			while( true ) {
-				std::this_thread::sleep_for( std::chrono::milliseconds( m_heart_check_time * 1000 ) );
-				if( IsNetworkStarted() ) {
-					SendHeartCheck(); // 
-				}
-			}
-		} // try
-		catch( ... ) {
-			log_info = " ͨŶʱ̷߳δ֪";
-			LogPrint( syslog_level::c_fatal, m_log_cate, log_info );
-		}
-
-		log_info = " ͨŶʱ߳˳";
-		LogPrint( syslog_level::c_warn, m_log_cate, log_info );
-	}
-
 	void NetServer_P::Thread_NetServer() {
 		std::string log_info;
 
@@ -150,14 +192,35 @@ namespace basicx {
 
 		try {
 			try {
-				m_service = std::make_shared<boost::asio::io_service>();
-				boost::asio::io_service::work work( *m_service );
+				// ƬģʽÿƬһ̣߳򵥸Ƭ m_io_work_thread_number ̣߳ԭһ
+				int32_t shard_number = m_shard_number > 0 ? m_shard_number : 1;
+				int32_t thread_number = m_shard_number > 0 ? 1 : m_io_work_thread_number;
+				int32_t cpu_number = (int32_t)std::thread::hardware_concurrency();
+				std::vector<std::shared_ptr<boost::asio::io_service::work>> vec_work;
+
+				for( int32_t i = 0; i < shard_number; i++ ) {
+					ServerShard* shard = new ServerShard();
+					shard->m_shard_index = i;
+					shard->m_cpu_core = ( true == m_shard_cpu_affinity && m_shard_number > 0 && cpu_number > 0 ) ? i % cpu_number : -1;
+					shard->m_service = std::make_shared<boost::asio::io_service>( thread_number ); // ʾ߳ʱʡȥڲ
+					shard->m_connect_table = new ConnectTable( m_max_connect_total_s, 214748364 / shard_number ); // ӿܼĳƬÿƬȫ޷λ
+					shard->m_heart_wheel = new TimerWheel<int32_t>( WHEEL_SLOT_NUMBER, WHEEL_TICK_MS, GetSteadyTimeMs() );
+					shard->m_wheel_timer = std::make_shared<boost::asio::steady_timer>( *shard->m_service );
+					Server_StartWheel( shard ); // мڱƬ߳ڽ
+					vec_work.push_back( std::make_shared<boost::asio::io_service::work>( *shard->m_service ) );
+					m_vec_shard.push_back( shard );
+				}
 
-				for( int32_t i = 0; i < m_io_work_thread_number; i++ ) {
-					ThreadPtr thread_ptr( new std::thread( boost::bind( &boost::asio::io_service::run, m_service ) ) );
-					m_vec_thread.push_back( thread_ptr );
+				for( size_t i = 0; i < m_vec_shard.size(); i++ ) {
+					for( int32_t j = 0; j < thread_number; j++ ) {
+						ThreadPtr thread_ptr( new std::thread( &NetServer_P::Thread_ServerShard, this, m_vec_shard[i] ) );
+						m_vec_thread.push_back( thread_ptr );
+					}
 				}
 
+				FormatLibrary::StandardLibrary::FormatTo( log_info, " ͨŷ Ƭ{0} ÿƬ̣߳{1} 󶨺ģ{2}", shard_number, thread_number, m_vec_shard[0]->m_cpu_core >= 0 ? "" : "" );
+				LogPrint( syslog_level::c_info, m_log_cate, log_info );
+
 				m_network_running = true;
 
 				for( size_t i = 0; i < m_vec_thread.size(); i++ ) { // ȴ߳˳
@@ -181,13 +244,30 @@ namespace basicx {
 
 		if( true == m_network_running ) {
 			m_network_running = false;
-			m_service->stop();
+			for( size_t i = 0; i < m_vec_shard.size(); i++ ) {
+				m_vec_shard[i]->m_service->stop();
+			}
 		}
 
 		log_info = " ͨŷ߳˳";
 		LogPrint( syslog_level::c_warn, m_log_cate, log_info );
 	}
 
+	void NetServer_P::Thread_ServerShard( ServerShard* shard ) {
+		if( shard->m_cpu_core >= 0 ) {
+#ifdef __OS_WINDOWS__
+			SetThreadAffinityMask( GetCurrentThread(), (DWORD_PTR)1 << shard->m_cpu_core );
+#else
+			cpu_set_t cpu_set;
+			CPU_ZERO( &cpu_set );
+			CPU_SET( shard->m_cpu_core, &cpu_set );
+			pthread_setaffinity_np( pthread_self(), sizeof( cpu_set_t ), &cpu_set );
+#endif
+		}
+
+		shard->m_service->run();
+	}
+
 	void NetServer_P::StartNetwork( NetServerCfg& config ) {
 		std::string log_info;
 
@@ -204,20 +284,17 @@ namespace basicx {
 		log_info = "  ͨŷ ̡߳";
 		LogPrint( syslog_level::c_info, m_log_cate, log_info );
 
-		m_thread_server_on_time = std::thread( &NetServer_P::Thread_ServerOnTime, this );
-		log_info = "  ͨŶʱ ̡߳";
-		LogPrint( syslog_level::c_info, m_log_cate, log_info );
-
 		// нģʽ£Ҫ while() Ƿᵼ LogPrint() е SendMessage ߱ǴڴǰҪͽϢ
 		while( false == m_network_running ) {
 			std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
 		}
 
-		m_sender_vector_1 = new SenderVector( m_max_msg_cache_number );
-		m_sender_vector_2 = new SenderVector( m_max_msg_cache_number );
-		// ʵʻֵָ
-		m_sender_vector_read = m_sender_vector_1;
-		m_sender_vector_write = m_sender_vector_1;
+		if( m_sender_policy < SENDER_POLICY_DROP || m_sender_policy > SENDER_POLICY_GROW ) { // δǷƻѡ
+			m_sender_policy = 0 == m_max_msg_cache_number ? SENDER_POLICY_GROW : SENDER_POLICY_DROP;
+		}
+		m_sender_ring = new SenderRing( m_max_msg_cache_number ); // ʵȡСֵָ 2 
+		FormatLibrary::StandardLibrary::FormatTo( log_info, " Ͷ {0} ԣ{1}", m_sender_ring->GetCapacity(), m_sender_policy );
+		LogPrint( syslog_level::c_info, m_log_cate, log_info );
 		m_sender_running = true;
 		m_sender_thread = std::thread( &NetServer_P::Server_HandleSendMsgs, this );
 		log_info = "  ͨŴ ̡߳";
@@ -236,12 +313,48 @@ namespace basicx {
 	}
 
 	// int32_t->2147483647(000000001~214748364)*10+2NetServer2
-	int32_t NetServer_P::Server_GetIdentity() {
-		if( 214748364 == m_identity_count ) {
-			m_identity_count = 0;
+	// (000000001~214748364) Ϊ ӱ * Ƭ + Ƭ + 1ӹرպɱǼʧЧ
+	int32_t NetServer_P::Server_AddConnect( ConnectInfo* connect_info ) {
+		if( !Server_CanAddConnect() ) {
+			return -1;
+		}
+		ServerShard* shard = connect_info->m_shard;
+		int32_t handle = shard->m_connect_table->Insert( connect_info );
+		if( handle < 0 ) {
+			return -1;
 		}
-		m_identity_count++; //
-		return m_identity_count * 10 + 2; // NetServer2
+		m_total_local_connect++;
+		return ( handle * (int32_t)m_vec_shard.size() + shard->m_shard_index + 1 ) * 10 + 2; // NetServer2
+	}
+
+	ServerShard* NetServer_P::Server_GetShard( int32_t identity ) {
+		if( identity < 10 || identity % 10 != 2 || m_vec_shard.empty() ) {
+			return nullptr;
+		}
+		return m_vec_shard[( identity / 10 - 1 ) % m_vec_shard.size()];
+	}
+
+	int32_t NetServer_P::Server_GetHandle( int32_t identity ) {
+		return (int32_t)( ( identity / 10 - 1 ) / m_vec_shard.size() );
+	}
+
+	ServerShard* NetServer_P::Server_NextShard() {
+		return m_vec_shard[m_shard_round++ % m_vec_shard.size()];
+	}
+
+	void NetServer_P::Server_GetConnectList( std::vector<ConnectInfo*>& vec_local_info ) {
+		for( size_t i = 0; i < m_vec_shard.size(); i++ ) {
+			m_vec_shard[i]->m_connect_table->Collect( vec_local_info ); // 
+		}
+	}
+
+	bool NetServer_P::Server_EraseConnect( ConnectInfo* connect_info ) {
+		bool erased = connect_info->m_shard->m_connect_table->Erase( Server_GetHandle( connect_info->m_identity ) ); // ظرʱѹ
+		if( true == erased ) {
+			m_total_local_connect--;
+			m_stat_closed.Merge( connect_info );
+		}
+		return erased;
 	}
 
 	bool NetServer_P::Server_CanAddConnect() {
@@ -249,8 +362,7 @@ namespace basicx {
 	}
 
 	bool NetServer_P::Server_CanAddListen( std::string address_l, int32_t port_l ) {
-		std::string listen_endpoint;
-		FormatLibrary::StandardLibrary::FormatTo( listen_endpoint, "tcp://0.0.0.0:{0}", port_l ); // 0.0.0.0
+		std::string listen_endpoint = Server_GetListenEndpoint( address_l, port_l );
 
 		bool can_add_listen = true;
 
@@ -267,7 +379,7 @@ namespace basicx {
 	bool NetServer_P::Server_AddListen( std::string address_l, int32_t port_l, std::string node_type_l ) {
 		std::string log_info;
 
-		ConnectInfo* connect_info = nullptr;
+		std::vector<AcceptorPtr> vec_acceptor;
 
 		try {
 			if( !IsNetworkStarted() ) {
@@ -282,19 +394,36 @@ namespace basicx {
 				return false;
 			}
 
+			if( true == IsShmAddress( address_l ) ) {
+				return Server_AddListenShm( address_l, node_type_l );
+			}
+
 			// תΪIPַ
 			boost::asio::ip::tcp::endpoint endpoint( boost::asio::ip::tcp::v4(), port_l );
 
-			connect_info = new ConnectInfo();
-			connect_info->m_socket = std::make_shared<boost::asio::ip::tcp::socket>( *m_service );
-			connect_info->m_available = false;
-			connect_info->m_node_type = node_type_l; //
-
-			AcceptorPtr acceptor = std::make_shared<boost::asio::ip::tcp::acceptor>( *m_service, endpoint );
+			// ֧ SO_REUSEPORT ʱÿƬԼͬһ˿ڣдڱƬ߳
+			// ֻڵһƬ䵽Ƭ
+			bool reuse_port = false;
+#ifdef SO_REUSEPORT
+			reuse_port = m_vec_shard.size() > 1;
+#endif
+			size_t acceptor_number = true == reuse_port ? m_vec_shard.size() : 1;
+			for( size_t i = 0; i < acceptor_number; i++ ) {
+				AcceptorPtr acceptor = std::make_shared<boost::asio::ip::tcp::acceptor>( *m_vec_shard[i]->m_service );
+				acceptor->open( endpoint.protocol() );
+				acceptor->set_option( boost::asio::ip::tcp::acceptor::reuse_address( true ) );
+#ifdef SO_REUSEPORT
+				if( true == reuse_port ) {
+					acceptor->set_option( ReusePortOption( true ) );
+				}
+#endif
+				acceptor->bind( endpoint );
+				acceptor->listen();
+				vec_acceptor.push_back( acceptor );
+			}
 
 			// ¼ؼϢ
-			std::string listen_endpoint;
-			FormatLibrary::StandardLibrary::FormatTo( listen_endpoint, "tcp://0.0.0.0:{0}", port_l ); // 0.0.0.0
+			std::string listen_endpoint = Server_GetListenEndpoint( address_l, port_l );
 			m_listen_info_lock.lock();
 			auto it_li = m_map_listen_info.find( listen_endpoint );
 			if( it_li == m_map_listen_info.end() ) {
@@ -303,7 +432,8 @@ namespace basicx {
 				listen_info->m_port = port_l;
 				listen_info->m_node_type = node_type_l;
 				listen_info->m_connect_number = 0;
-				listen_info->m_acceptor = acceptor;
+				listen_info->m_acceptor = vec_acceptor[0];
+				listen_info->m_vec_acceptor = vec_acceptor;
 				m_map_listen_info.insert( std::pair<std::string, ListenInfo*>( listen_endpoint, listen_info ) );
 				FormatLibrary::StandardLibrary::FormatTo( log_info, "  ؼ{0}:{1}:{2}", address_l, port_l, node_type_l );
 				LogPrint( syslog_level::c_info, m_log_cate, log_info );
@@ -311,7 +441,9 @@ namespace basicx {
 			m_listen_info_lock.unlock();
 
 			// 첽
-			acceptor->async_accept( *(connect_info->m_socket), boost::bind( &NetServer_P::Server_HandleAccept, this, boost::asio::placeholders::error, connect_info, acceptor ) );
+			for( size_t i = 0; i < vec_acceptor.size(); i++ ) {
+				Server_KeepOnAccept( node_type_l, vec_acceptor[i], true == reuse_port ? m_vec_shard[i] : nullptr );
+			}
 		}
 		catch( std::exception& ex ) {
 			if( 1 == m_log_test ) {
@@ -322,13 +454,9 @@ namespace basicx {
 			}
 			LogPrint( syslog_level::c_error, m_log_cate, log_info );
 
-			if( connect_info ) {
-				if( connect_info->m_socket.get() ) {
-					connect_info->m_socket->close();
-				}
-
-				delete connect_info;
-				connect_info = nullptr;
+			for( size_t i = 0; i < vec_acceptor.size(); i++ ) {
+				boost::system::error_code error;
+				vec_acceptor[i]->close( error );
 			}
 
 			return false;
@@ -337,14 +465,27 @@ namespace basicx {
 		return true;
 	}
 
-	void NetServer_P::Server_HandleAccept( const boost::system::error_code& error, ConnectInfo* connect_info, AcceptorPtr acceptor ) {
+	std::string NetServer_P::Server_GetListenEndpoint( const std::string& address_l, int32_t port_l ) {
+		if( true == IsShmAddress( address_l ) ) {
+			return address_l;
+		}
+		std::string listen_endpoint;
+		FormatLibrary::StandardLibrary::FormatTo( listen_endpoint, "tcp://0.0.0.0:{0}", port_l ); // 0.0.0.0
+		return listen_endpoint;
+	}
+
+	void NetServer_P::Server_HandleAccept( const boost::system::error_code& error, ConnectInfo* connect_info, AcceptorPtr acceptor, ServerShard* accept_shard ) {
 		std::string log_info;
 
 		if( !error ) {
-			connect_info->m_identity = Server_GetIdentity();
+			connect_info->m_identity = 0; // ӱʱ
 			connect_info->m_available = true;
 			time( &connect_info->m_heart_check_time );
 			connect_info->m_active_close = false;
+			connect_info->m_send_time = GetSteadyTimeMs();
+			connect_info->m_recv_time = connect_info->m_send_time.load();
+			connect_info->m_head_mode = HEAD_MODE_TEXT; // ȴͻл
+			connect_info->m_strand = std::make_shared<boost::asio::io_service::strand>( *connect_info->m_shard->m_service ); // ׽ͬһƬ
 
 			connect_info->m_protocol_r = "tcp";
 			connect_info->m_adress_r = connect_info->m_socket->remote_endpoint().address().to_string().c_str();
@@ -358,14 +499,27 @@ namespace basicx {
 			FormatLibrary::StandardLibrary::FormatTo( connect_info->m_str_port_l, "{0}", connect_info->m_port_l );
 			connect_info->m_endpoint_l = connect_info->m_protocol_l + "://" + connect_info->m_adress_l + ":" + connect_info->m_str_port_l; // ӱ"tcp://192.16.1.38:465"
 
-			connect_info->m_recv_buf_head = new char[HEAD_BYTES];
-			connect_info->m_recv_buf_data = new char[1024];
-			connect_info->m_recv_buf_data_size = 1024;
+			connect_info->m_node_type_intern = InternNodeType( connect_info->m_node_type );
 
-			connect_info->m_stat_lost_msg = 0;
+			connect_info->m_recv_buf_head = nullptr; // ʽգͷֱ m_recv_buf_data н
+			connect_info->m_recv_buf_share = MakeRecvBuf( m_recv_buf_size_s );
+			connect_info->m_recv_buf_data = connect_info->m_recv_buf_share.get();
+			connect_info->m_recv_buf_data_size = m_recv_buf_size_s;
+			connect_info->m_recv_buf_begin = 0;
+			connect_info->m_recv_buf_end = 0;
+
+			Server_InitCompress( connect_info );
+			Server_InitSendQueue( connect_info );
+
+			connect_info->ResetStat();
 
-			if( !Server_CanAddConnect() ) {
-				FormatLibrary::StandardLibrary::FormatTo( log_info, " ȫ {0}:{1} ܾӣ[{2}]<-[{3}]", m_total_local_connect, m_max_connect_total_s, connect_info->m_endpoint_l, connect_info->m_endpoint_r );
+			connect_info->m_send_writing = false;
+			connect_info->m_send_backlog_time = 0;
+			connect_info->m_send_pending_base = 0;
+
+			connect_info->m_identity = Server_AddConnect( connect_info );
+			if( connect_info->m_identity < 0 ) {
+				FormatLibrary::StandardLibrary::FormatTo( log_info, " ȫ {0}:{1} ܾӣ[{2}]<-[{3}]", m_total_local_connect.load(), m_max_connect_total_s, connect_info->m_endpoint_l, connect_info->m_endpoint_r );
 				LogPrint( syslog_level::c_error, m_log_cate, log_info );
 				std::string node_type = connect_info->m_node_type;
 				if( connect_info ) {
@@ -377,24 +531,17 @@ namespace basicx {
 					connect_info = nullptr;
 				}
 				// ׼µ
-				Server_KeepOnAccept( node_type, acceptor );
+				Server_KeepOnAccept( node_type, acceptor, accept_shard );
 				return;
 			}
 
-			m_local_info_lock.lock();
-			m_list_local_info.push_back( connect_info );
-			m_total_local_connect = m_list_local_info.size(); //
-			m_local_info_lock.unlock();
-			m_local_info_index_lock.lock();
-			m_map_local_info_index.insert( std::pair<int32_t, ConnectInfo*>( connect_info->m_identity, connect_info ) );
-			m_local_info_index_lock.unlock();
-
 			FormatLibrary::StandardLibrary::FormatTo( log_info, " ӣ[{0}]<-[{1}]{2}", connect_info->m_endpoint_l, connect_info->m_endpoint_r, connect_info->m_identity );
 			LogPrint( syslog_level::c_info, m_log_cate, log_info );
 
+			connect_info->m_shard->m_heart_wheel->Schedule( connect_info->m_identity, Server_GetCheckTime( connect_info ) );
+
 			// ±ؼϢ
-			std::string listen_endpoint;
-			FormatLibrary::StandardLibrary::FormatTo( listen_endpoint, "tcp://0.0.0.0:{0}", connect_info->m_port_l ); // 0.0.0.0
+			std::string listen_endpoint = Server_GetListenEndpoint( connect_info->m_endpoint_l, connect_info->m_port_l );
 			m_listen_info_lock.lock();
 			auto it_li = m_map_listen_info.find( listen_endpoint );
 			if( it_li != m_map_listen_info.end() ) {
@@ -409,12 +556,11 @@ namespace basicx {
 				connect_info->m_socket->set_option( boost::asio::socket_base::receive_buffer_size( m_tcp_socket_option.m_recv_buffer_size ) );
 				connect_info->m_socket->set_option( boost::asio::socket_base::send_buffer_size( m_tcp_socket_option.m_send_buffer_size ) );
 
-				// ׼ӿͻ˽ Type 
-				memset( connect_info->m_recv_buf_head, 0, HEAD_BYTES );
-				boost::asio::async_read( *(connect_info->m_socket), boost::asio::buffer( connect_info->m_recv_buf_head, HEAD_BYTES ), boost::bind( &NetServer_P::Server_HandleRecvHead, this, boost::asio::placeholders::error, connect_info ) );
+				// ׼ӿͻ˽ݣ˺ӵв m_strand н
+				connect_info->m_strand->post( boost::bind( &NetServer_P::Server_RecvData, this, connect_info ) );
 
 				// ׼µ
-				Server_KeepOnAccept( connect_info->m_node_type, acceptor );
+				Server_KeepOnAccept( connect_info->m_node_type, acceptor, accept_shard );
 			}
 			catch( std::exception& ex ) {
 				Server_CloseOnError( connect_info );
@@ -452,17 +598,18 @@ namespace basicx {
 		}
 	}
 
-	void NetServer_P::Server_KeepOnAccept( std::string node_type_l, AcceptorPtr acceptor ) {
+	void NetServer_P::Server_KeepOnAccept( std::string node_type_l, AcceptorPtr acceptor, ServerShard* accept_shard ) {
 		ConnectInfo* connect_info = nullptr;
 
 		try {
 			connect_info = new ConnectInfo();
-			connect_info->m_socket = std::make_shared<boost::asio::ip::tcp::socket>( *m_service );
+			connect_info->m_shard = accept_shard != nullptr ? accept_shard : Server_NextShard();
+			connect_info->m_socket = std::make_shared<boost::asio::ip::tcp::socket>( *connect_info->m_shard->m_service ); // ׽ĸƬдĸƬ߳
 			connect_info->m_available = false;
 			connect_info->m_node_type = node_type_l; //
 
 			// 첽
-			acceptor->async_accept( *(connect_info->m_socket), boost::bind( &NetServer_P::Server_HandleAccept, this, boost::asio::placeholders::error, connect_info, acceptor ) );
+			acceptor->async_accept( *(connect_info->m_socket), boost::bind( &NetServer_P::Server_HandleAccept, this, boost::asio::placeholders::error, connect_info, acceptor, accept_shard ) );
 		}
 		catch( std::exception& ex ) {
 			std::string log_info;
@@ -485,69 +632,62 @@ namespace basicx {
 		}
 	}
 
-	void NetServer_P::Server_HandleRecvHead( const boost::system::error_code& error, ConnectInfo* connect_info ) {
+	void NetServer_P::Server_RecvData( ConnectInfo* connect_info ) {
+		// жٶ٣һɿܺжݰҲֻа
+		boost::asio::mutable_buffers_1 recv_buffer = boost::asio::buffer( connect_info->m_recv_buf_data + connect_info->m_recv_buf_end, connect_info->m_recv_buf_data_size - connect_info->m_recv_buf_end );
+		connect_info->m_socket->async_read_some( recv_buffer, connect_info->m_strand->wrap( boost::bind( &NetServer_P::Server_HandleRecvData, this, boost::asio::placeholders::error, boost::asio::placeholders::bytes_transferred, connect_info ) ) );
+	}
+
+	void NetServer_P::Server_HandleRecvData( const boost::system::error_code& error, size_t recv_size, ConnectInfo* connect_info ) {
 		if( !error ) {
 			try {
-				int32_t type( 0 );
-				int32_t code( 0 );
-				int32_t size( 0 );
-				std::istringstream type_temp( std::string( connect_info->m_recv_buf_head, TYPE_BYTES ) );
-				std::istringstream code_temp( std::string( connect_info->m_recv_buf_head, TYPE_BYTES, CODE_BYTES ) );
-				std::istringstream size_temp( std::string( connect_info->m_recv_buf_head, FLAG_BYTES, SIZE_BYTES ) );
-				type_temp >> std::hex >> type;
-				code_temp >> std::hex >> code;
-				size_temp >> std::hex >> size;
-
-				if( 1 == m_log_test ) {
-					std::string log_info;
-					FormatLibrary::StandardLibrary::FormatTo( log_info, "<--[{0}]Type:{1} Code:{2} Size:{3}", connect_info->m_endpoint_r, type, code, size );
-					LogPrint( syslog_level::c_info, m_log_cate, log_info );
+				connect_info->m_recv_time.store( GetSteadyTimeMs(), std::memory_order_relaxed );
+				connect_info->m_recv_buf_end += recv_size;
+
+				size_t frame_size = 0; // δݰܳ
+				while( connect_info->m_recv_buf_end - connect_info->m_recv_buf_begin >= HEAD_BYTES ) {
+					const char* frame = connect_info->m_recv_buf_data + connect_info->m_recv_buf_begin;
+					size_t unparsed_size = connect_info->m_recv_buf_end - connect_info->m_recv_buf_begin;
+					if( false == Server_HandleRecvFrame( connect_info, frame, unparsed_size, frame_size ) ) {
+						return; // ѹر
+					}
+					if( false == connect_info->m_available ) { // صйرӣջͷ
+						return;
+					}
+					if( frame_size > unparsed_size ) { // δ
+						break;
+					}
+					connect_info->m_recv_buf_begin += frame_size;
+					frame_size = 0;
 				}
 
-				if( type < NW_MSG_ATOM_TYPE_MIN || type > NW_MSG_USER_TYPE_MAX ) {
-					std::string log_info;
-					Server_CloseOnError( connect_info );
-					FormatLibrary::StandardLibrary::FormatTo( log_info, " յ δ֪ݰͣ{0}", type );
-					LogPrint( syslog_level::c_error, m_log_cate, log_info );
+				// ʣĲݰƵ濪ͷͨһƶС
+				size_t remain_size = connect_info->m_recv_buf_end - connect_info->m_recv_buf_begin;
+				if( frame_size > connect_info->m_recv_buf_data_size || connect_info->m_recv_buf_share.use_count() > 1 ) { // ݰС򻺴ѱصȡȨ»
+					size_t recv_buf_size = frame_size > connect_info->m_recv_buf_data_size ? frame_size : connect_info->m_recv_buf_data_size;
+					std::shared_ptr<char> recv_buf_share = MakeRecvBuf( recv_buf_size );
+					memcpy( recv_buf_share.get(), connect_info->m_recv_buf_data + connect_info->m_recv_buf_begin, remain_size );
+					connect_info->m_recv_buf_share = recv_buf_share;
+					connect_info->m_recv_buf_data = recv_buf_share.get();
+					connect_info->m_recv_buf_data_size = recv_buf_size;
 				}
-
-				if( code < NW_MSG_CODE_TYPE_MIN || code > NW_MSG_CODE_TYPE_MAX ) {
-					std::string log_info;
-					Server_CloseOnError( connect_info );
-					FormatLibrary::StandardLibrary::FormatTo( log_info, " յ δ֪ݰ룺{0}", code );
-					LogPrint( syslog_level::c_error, m_log_cate, log_info );
+				else if( remain_size > 0 && connect_info->m_recv_buf_begin > 0 ) {
+					memmove( connect_info->m_recv_buf_data, connect_info->m_recv_buf_data + connect_info->m_recv_buf_begin, remain_size );
 				}
+				connect_info->m_recv_buf_begin = 0;
+				connect_info->m_recv_buf_end = remain_size;
 
-				if( 0 == size ) {
-					// ׼ӿͻ˽ Type 
-					memset( connect_info->m_recv_buf_head, 0, HEAD_BYTES );
-					boost::asio::async_read( *(connect_info->m_socket), boost::asio::buffer( connect_info->m_recv_buf_head, HEAD_BYTES ), boost::bind( &NetServer_P::Server_HandleRecvHead, this, boost::asio::placeholders::error, connect_info ) );
-				}
-				else if( size > 0 && size <= m_max_data_length_s ) {
-					// ׼ӿͻ˽ Data 
-					if( connect_info->m_recv_buf_data_size < size ) {
-						delete[] connect_info->m_recv_buf_data;
-						connect_info->m_recv_buf_data = new char[size];
-						connect_info->m_recv_buf_data_size = size;
-					}
-					memset( connect_info->m_recv_buf_data, 0, size );
-					boost::asio::async_read( *(connect_info->m_socket), boost::asio::buffer( connect_info->m_recv_buf_data, size ), boost::bind( &NetServer_P::Server_HandleRecvData, this, boost::asio::placeholders::error, connect_info, type, code, size ) );
-				}
-				else {
-					std::string log_info;
-					Server_CloseOnError( connect_info );
-					FormatLibrary::StandardLibrary::FormatTo( log_info, " յ 쳣ݰС{0}", size );
-					LogPrint( syslog_level::c_error, m_log_cate, log_info );
-				}
+				// ׼ӿͻ˽
+				Server_RecvData( connect_info );
 			}
 			catch( std::exception& ex ) {
 				std::string log_info;
 				Server_CloseOnError( connect_info );
 				if( 1 == m_log_test ) {
-					FormatLibrary::StandardLibrary::FormatTo( log_info, "  Head  쳣{0}", ex.what() );
+					FormatLibrary::StandardLibrary::FormatTo( log_info, "  Data  쳣{0}", ex.what() );
 				}
 				else {
-					log_info = "  Head  쳣";
+					log_info = "  Data  쳣";
 				}
 				LogPrint( syslog_level::c_error, m_log_cate, log_info );
 			}
@@ -556,87 +696,151 @@ namespace basicx {
 			std::string log_info;
 			Server_CloseOnError( connect_info );
 			if( 1 == m_log_test ) {
-				FormatLibrary::StandardLibrary::FormatTo( log_info, "  Head  {0}", error.message().c_str() );
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "  Data  {0}", error.message().c_str() );
 			}
 			else {
-				log_info = "  Head  ";
+				log_info = "  Data  ";
 			}
 			LogPrint( syslog_level::c_error, m_log_cate, log_info );
 		}
 	}
 
-	void NetServer_P::Server_HandleRecvData( const boost::system::error_code& error, ConnectInfo* connect_info, int32_t type, int32_t code, int32_t size ) {
-		if( !error ) {
-			try {
-				std::string data( connect_info->m_recv_buf_data, size );
+	//  frame ݰframe_size ݰܳȣ recv_size ʱʾδ꣬δ
+	//  false ʾݰ쳣ѹر
+	bool NetServer_P::Server_HandleRecvFrame( ConnectInfo* connect_info, const char* frame, size_t recv_size, size_t& frame_size ) {
+		FrameHead frame_head; // ıưͷֽԶʶ
+		bool head_valid = DecodeHead( frame, frame_head );
+		int32_t type = frame_head.m_type;
+		int32_t code = frame_head.m_code;
+		size_t size = frame_head.m_size;
 
-				if( 1 == m_log_test ) {
-					std::string log_info;
-					FormatLibrary::StandardLibrary::FormatTo( log_info, "<--[{0}]Data:{1}", connect_info->m_endpoint_r, data.length() );
-					LogPrint( syslog_level::c_info, m_log_cate, log_info );
-				}
+		if( false == head_valid ) {
+			std::string log_info;
+			Server_CloseOnError( connect_info );
+			FormatLibrary::StandardLibrary::FormatTo( log_info, " յ Ƿݰͷ{0}", std::string( frame, HEAD_BYTES ) );
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+			return false;
+		}
 
-				if( !data.empty() ) {
-					try {
-						if( m_net_server_x != nullptr ) {
-							NetServerData net_server_data( connect_info->m_node_type, connect_info->m_identity, code, data ); // std::move( data )
-							m_net_server_x->OnNetServerData( net_server_data );
-						}
-						else {
-							std::string log_info;
-							log_info = "ͨŵģָ m_net_server_x Ϊգ";
-							LogPrint( syslog_level::c_warn, m_log_cate, log_info );
-						}
-					}
-					catch( ... ) {
-						std::string log_info;
-						log_info = "  Data  ת δ֪";
-						LogPrint( syslog_level::c_error, m_log_cate, log_info );
-					}
+		if( type < NW_MSG_ATOM_TYPE_MIN || type > NW_MSG_USER_TYPE_MAX ) {
+			std::string log_info;
+			Server_CloseOnError( connect_info );
+			FormatLibrary::StandardLibrary::FormatTo( log_info, " յ δ֪ݰͣ{0}", type );
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+			return false;
+		}
 
-					// ׼ӿͻ˽ Type 
-					memset( connect_info->m_recv_buf_head, 0, HEAD_BYTES );
-					boost::asio::async_read( *(connect_info->m_socket), boost::asio::buffer( connect_info->m_recv_buf_head, HEAD_BYTES ), boost::bind( &NetServer_P::Server_HandleRecvHead, this, boost::asio::placeholders::error, connect_info ) );
-				}
-				else {
-					std::string log_info;
-					Server_CloseOnError( connect_info );
-					log_info = " յ ݰΪգ";
-					LogPrint( syslog_level::c_error, m_log_cate, log_info );
-				}
+		if( code < NW_MSG_CODE_TYPE_MIN || code > NW_MSG_CODE_TYPE_MAX ) {
+			std::string log_info;
+			Server_CloseOnError( connect_info );
+			FormatLibrary::StandardLibrary::FormatTo( log_info, " յ δ֪ݰ룺{0}", code );
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+			return false;
+		}
+
+		if( size > m_max_data_length_s ) {
+			std::string log_info;
+			Server_CloseOnError( connect_info );
+			FormatLibrary::StandardLibrary::FormatTo( log_info, " յ 쳣ݰС{0}", size );
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+			return false;
+		}
+
+		frame_size = HEAD_BYTES + size;
+		if( frame_size > recv_size ) { // ȴ
+			return true;
+		}
+		connect_info->m_stat_recv_bytes.fetch_add( frame_size, std::memory_order_relaxed );
+		connect_info->m_stat_recv_msgs.fetch_add( 1, std::memory_order_relaxed );
+
+		if( 1 == m_log_test ) {
+			std::string log_info;
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "<--[{0}]Type:{1} Code:{2} Size:{3}", connect_info->m_endpoint_r, type, code, size );
+			LogPrint( syslog_level::c_info, m_log_cate, log_info );
+		}
+
+		if( 0 == size ) {
+			if( NW_MSG_TYPE_HEART_CHECK == type && NW_MSG_CODE_HEAD_BINARY == code ) { // ͻöưͷ
+				Server_HandleHeadBinary( connect_info );
 			}
-			catch( std::exception& ex ) {
+			return true;
+		}
+
+		const char* data = frame + HEAD_BYTES;
+		std::shared_ptr<char>* data_owner = &connect_info->m_recv_buf_share;
+		if( frame_head.m_flag & FRAME_FLAG_COMPRESS ) { // ҲѹУȽѹ
+			size_t unpack_size = 0;
+			int32_t result = UnpackFrame( frame_head.m_flag, data, size, m_max_data_length_s, connect_info->m_compress_dict, m_compress_dict_table, connect_info->m_unpack_buf_share, connect_info->m_unpack_buf_size, unpack_size );
+			if( result != 0 ) { // ͷãֻϢ
+				std::string log_info;
+				FormatLibrary::StandardLibrary::FormatTo( log_info, " ѹ ݰ ʧܣ{0}{1} {2}", connect_info->m_endpoint_r, result, size );
+				LogPrint( syslog_level::c_error, m_log_cate, log_info );
+				return true;
+			}
+			data = connect_info->m_unpack_buf_share.get();
+			size = unpack_size;
+			data_owner = &connect_info->m_unpack_buf_share;
+		}
+
+		uint64_t request_id = 0;
+		if( NW_MSG_TYPE_REQUEST == type ) {
+			if( size < REQUEST_ID_BYTES ) {
 				std::string log_info;
 				Server_CloseOnError( connect_info );
-				if( 1 == m_log_test ) {
-					FormatLibrary::StandardLibrary::FormatTo( log_info, "  Data  쳣{0}", ex.what() );
-				}
-				else {
-					log_info = "  Data  쳣";
-				}
+				FormatLibrary::StandardLibrary::FormatTo( log_info, " յ 쳣С{0}", size );
 				LogPrint( syslog_level::c_error, m_log_cate, log_info );
+				return false;
 			}
+			request_id = DecodeRequestId( data );
+			data += REQUEST_ID_BYTES;
+			size -= REQUEST_ID_BYTES;
 		}
-		else {
-			std::string log_info;
-			Server_CloseOnError( connect_info );
-			if( 1 == m_log_test ) {
-				FormatLibrary::StandardLibrary::FormatTo( log_info, "  Data  {0}", error.message().c_str() );
+
+		try {
+			if( m_net_server_x != nullptr ) {
+				NetServerView net_server_view; // ֱָջ
+				net_server_view.m_node_type = connect_info->m_node_type_intern;
+				net_server_view.m_identity = connect_info->m_identity;
+				net_server_view.m_code = code;
+				net_server_view.m_data = data;
+				net_server_view.m_size = size;
+				net_server_view.m_request_id = request_id;
+				net_server_view.m_data_owner = data_owner;
+				m_net_server_x->OnNetServerView( net_server_view );
 			}
 			else {
-				log_info = "  Data  ";
+				std::string log_info;
+				log_info = "ͨŵģָ m_net_server_x Ϊգ";
+				LogPrint( syslog_level::c_warn, m_log_cate, log_info );
 			}
+		}
+		catch( ... ) {
+			std::string log_info;
+			log_info = "  Data  ת δ֪";
 			LogPrint( syslog_level::c_error, m_log_cate, log_info );
 		}
+		return true;
+	}
+
+	void NetServer_P::Server_HandleHeadBinary( ConnectInfo* connect_info ) {
+		if( true == m_binary_head_s && connect_info->m_head_mode != HEAD_MODE_BINARY ) {
+			// ȷϢıͷӣ֮ϢöưͷԶ˰ÿͷԶʶ𣬲лʱ
+			Server_SendData( connect_info, NW_MSG_TYPE_HEART_CHECK, NW_MSG_CODE_HEAD_BINARY, std::string( "" ) );
+			connect_info->m_head_mode = HEAD_MODE_BINARY;
+
+			std::string log_info;
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "   ưͷ[{0}]<-[{1}]{2}", connect_info->m_endpoint_l, connect_info->m_endpoint_r, connect_info->m_identity );
+			LogPrint( syslog_level::c_info, m_log_cate, log_info );
+		}
 	}
 
 	int32_t NetServer_P::Server_SendDataAll( int32_t type, int32_t code, std::string& data ) {
-		m_local_info_lock.lock();
-		std::list<ConnectInfo*> list_local_info = m_list_local_info;
-		m_local_info_lock.unlock();
+		std::vector<ConnectInfo*> vec_local_info;
+		Server_GetConnectList( vec_local_info );
 		int32_t send_count = 0;
-		for( auto it_ci = list_local_info.begin(); it_ci != list_local_info.end(); it_ci++ ) {
-			if( 0 == Server_SendData( *it_ci, type, code, data ) ) {
+		FramePtr send_frames[2]; //  HEAD_MODE_TEXT  HEAD_MODE_BINARY һΣӹ
+		for( auto it_ci = vec_local_info.begin(); it_ci != vec_local_info.end(); it_ci++ ) {
+			if( 0 == Server_SendData( *it_ci, type, code, data, send_frames, nullptr ) ) {
 				send_count++;
 			}
 		}
@@ -644,58 +848,131 @@ namespace basicx {
 	}
 
 	int32_t NetServer_P::Server_SendData( ConnectInfo* connect_info, int32_t type, int32_t code, std::string& data ) {
+		return Server_SendData( connect_info, type, code, data, nullptr, nullptr );
+	}
+
+	int32_t NetServer_P::Server_SendData( int32_t identity, int32_t type, int32_t code, std::string& data ) {
+		return Server_SendData( Server_GetConnect( identity ), type, code, data, nullptr, nullptr ); // ǹʱΪգ -4
+	}
+
+	int32_t NetServer_P::Server_SendConflateAll( int32_t type, int32_t code, const std::string& conflate_key, std::string& data ) {
+		std::vector<ConnectInfo*> vec_local_info;
+		Server_GetConnectList( vec_local_info );
+		int32_t send_count = 0;
+		FramePtr send_frames[2];
+		for( auto it_ci = vec_local_info.begin(); it_ci != vec_local_info.end(); it_ci++ ) {
+			if( 0 == Server_SendData( *it_ci, type, code, data, send_frames, &conflate_key ) ) {
+				send_count++;
+			}
+		}
+		return send_count;
+	}
+
+	int32_t NetServer_P::Server_SendConflate( ConnectInfo* connect_info, int32_t type, int32_t code, const std::string& conflate_key, std::string& data ) {
+		return Server_SendData( connect_info, type, code, data, nullptr, &conflate_key );
+	}
+
+	int32_t NetServer_P::Server_SendConflate( int32_t identity, int32_t type, int32_t code, const std::string& conflate_key, std::string& data ) {
+		return Server_SendData( Server_GetConnect( identity ), type, code, data, nullptr, &conflate_key );
+	}
+
+	int32_t NetServer_P::Server_SendAnswer( int32_t identity, uint64_t request_id, int32_t code, std::string& data ) {
+		std::string answer( REQUEST_ID_BYTES + data.length(), '\0' );
+		EncodeRequestId( &answer[0], request_id );
+		memcpy( &answer[REQUEST_ID_BYTES], data.c_str(), data.length() );
+		return Server_SendData( Server_GetConnect( identity ), NW_MSG_TYPE_ANSWER, code, answer, nullptr, nullptr );
+	}
+
+	int32_t NetServer_P::Server_SendData( ConnectInfo* connect_info, int32_t type, int32_t code, std::string& data, FramePtr* send_frames, const std::string* conflate_key ) {
 		int32_t result = 0;
 		if( connect_info != nullptr && connect_info->m_available != false ) {
+			if( connect_info->m_shm_channel != nullptr ) { // ڴֱд뻷λ棬߳
+				return Server_SendShm( connect_info, type, code, data );
+			}
 			size_t size = data.length();
-			if( size <= m_max_data_length_s ) {
-				std::ostringstream type_temp;
-				std::ostringstream code_temp;
-				std::ostringstream size_temp;
-				type_temp << std::setw( TYPE_BYTES ) << std::hex << type;
-				code_temp << std::setw( CODE_BYTES ) << std::hex << code;
-				size_temp << std::setw( SIZE_BYTES ) << std::hex << size;
-
-				//std::string str_type = type_temp.str();
-				//std::string str_code = code_temp.str();
-				//std::string str_size = size_temp.str();
+			int32_t head_mode = connect_info->m_head_mode;
+			if( size <= m_max_data_length_s && size <= GetHeadSizeMax( head_mode ) ) {
 				//std::string log_info;
-				//FormatLibrary::StandardLibrary::FormatTo( log_info, "AddSend{0} {1} {2} {3}", str_type.c_str(), str_code.c_str(), str_size.c_str(), data.c_str() );
+				//FormatLibrary::StandardLibrary::FormatTo( log_info, "AddSend{0} {1} {2} {3}", type, code, size, data.c_str() );
 				//LogPrint( syslog_level::c_info, m_log_cate, log_info );
 
-				m_writing_vector_lock.lock();
+				SendBufInfo* send_buf_info = nullptr;
 				try {
-					bool sender_is_full = false;
-					if( m_sender_vector_write->m_count == m_sender_vector_write->m_capacity ) { // 軻Уд capacity ſǸ
-						m_changing_vector_lock.lock();
-						if( m_sender_vector_write == m_sender_vector_read ) { // ߳δռĿУл
-							m_sender_vector_write = m_sender_vector_write == m_sender_vector_1 ? m_sender_vector_2 : m_sender_vector_1; // л
-							m_sender_vector_write->m_count = 0; // ¿ʼڶм
+					std::string* send_data = &data;
+					int32_t send_flag = 0;
+					thread_local std::string send_packed; // ̸߳ѹ
+					if( connect_info->m_compress_codec != NW_COMPRESS_NONE && HEAD_MODE_BINARY == head_mode && size >= connect_info->m_compress_threshold && code != NW_MSG_CODE_ZLIB ) { // NW_MSG_CODE_ZLIB Ϊѹ
+						send_flag = CompressFrame( connect_info->m_compress_codec, connect_info->m_compress_dict, data, send_packed );
+						if( send_flag != 0 ) {
+							send_data = &send_packed;
+						}
+					}
+					FramePtr send_frame;
+					if( send_frames != nullptr && 0 == send_flag ) { // ѹֵ죬
+						if( nullptr == send_frames[head_mode] ) {
+							send_frames[head_mode] = MakeSendFrame( head_mode, type, code, data );
+						}
+						send_frame = send_frames[head_mode];
+					}
+					if( 0 == m_sender_spill_count ) { // Ϣδʱռòλ֤Ϣ˳
+						send_buf_info = m_sender_ring->Claim();
+					}
+					if( nullptr == send_buf_info && SENDER_POLICY_BLOCK == m_sender_policy ) {
+						m_stat_block_count++;
+						std::chrono::steady_clock::time_point block_until = std::chrono::steady_clock::now() + std::chrono::milliseconds( SENDER_BLOCK_TIMEOUT );
+						while( nullptr == send_buf_info && true == m_sender_running && std::chrono::steady_clock::now() < block_until ) {
+							std::this_thread::yield();
+							send_buf_info = m_sender_ring->Claim();
+						}
+					}
+					if( send_buf_info != nullptr ) {
+						if( send_frame != nullptr ) {
+							send_buf_info->Update( connect_info, send_frame );
 						}
 						else {
-							if( 0 == m_max_msg_cache_number ) { // ޻
-								m_sender_vector_write->m_capacity += m_sender_vector_write->m_capacity; // ӵȣȴ߳뿪Ŀ
-							}
-							else { // ƻ
-								sender_is_full = true;
-								connect_info->m_stat_lost_msg++;
-								result = -1;
-							}
+							send_buf_info->Update( connect_info, head_mode, type, code, *send_data, send_flag );
+						}
+						if( conflate_key != nullptr ) {
+							send_buf_info->m_conflate_key = *conflate_key; // Update() ʱλúֵٷ
 						}
-						m_changing_vector_lock.unlock();
+						connect_info->m_stat_send_queue.fetch_add( 1, std::memory_order_relaxed ); // ڷ룬̼߳һʱڴ˴
+						m_sender_ring->Publish( send_buf_info );
+						send_buf_info = nullptr; // ѷ
 					}
-					if( false == sender_is_full ) {
-						if( m_sender_vector_write->m_count < m_sender_vector_write->m_vec_send_buf_info.size() ) { // ʹþԪ
-							m_sender_vector_write->m_vec_send_buf_info[m_sender_vector_write->m_count]->Update( connect_info, size, type_temp, code_temp, size_temp, data );
-							m_sender_vector_write->m_count++; // Ժ
+					else if( SENDER_POLICY_GROW == m_sender_policy ) {
+						SendBufInfo* spill_buf_info = nullptr;
+						if( send_frame != nullptr ) {
+							spill_buf_info = new SendBufInfo();
+							spill_buf_info->Update( connect_info, send_frame );
 						}
-						else { // ʹ½Ԫ
-							m_sender_vector_write->m_vec_send_buf_info.push_back( new SendBufInfo( connect_info, size, type_temp, code_temp, size_temp, data ) );
-							m_sender_vector_write->m_count++; // Ժ
+						else {
+							spill_buf_info = new SendBufInfo( connect_info, head_mode, type, code, *send_data, send_flag );
+						}
+						if( conflate_key != nullptr ) {
+							spill_buf_info->m_conflate_key = *conflate_key;
 						}
-						m_sender_condition.notify_all(); //
+						connect_info->m_stat_send_queue.fetch_add( 1, std::memory_order_relaxed );
+						m_sender_spill_lock.lock();
+						m_list_sender_spill.push_back( spill_buf_info );
+						m_sender_spill_count++;
+						m_sender_spill_lock.unlock();
+						m_stat_grow_count++;
+					}
+					else {
+						connect_info->m_stat_lost_msg++;
+						connect_info->m_stat_drop_msgs.fetch_add( 1, std::memory_order_relaxed );
+						m_stat_drop_count++;
+						result = -1;
+					}
+					if( 0 == result && true == m_sender_waiting ) {
+						m_sender_condition.notify_all();
 					}
 				}
 				catch( std::exception& ex ) {
+					if( send_buf_info != nullptr ) { // ռõĲλ뷢Ȼ̻߳ͣڴ˴
+						send_buf_info->m_connect_info = nullptr;
+						m_sender_ring->Publish( send_buf_info );
+					}
 					std::string log_info;
 					if( 1 == m_log_test ) {
 						FormatLibrary::StandardLibrary::FormatTo( log_info, "  Data Ϣ 쳣{0}", ex.what() );
@@ -706,11 +983,10 @@ namespace basicx {
 					LogPrint( syslog_level::c_error, m_log_cate, log_info );
 					result = -2;
 				}
-				m_writing_vector_lock.unlock();
 			}
 			else {
 				std::string log_info;
-				FormatLibrary::StandardLibrary::FormatTo( log_info, "  Data Ϣ {0} > {1}", size, m_max_data_length_s );
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "  Data Ϣ {0} > {1}", size, std::min( m_max_data_length_s, GetHeadSizeMax( head_mode ) ) );
 				LogPrint( syslog_level::c_warn, m_log_cate, log_info );
 				result = -3;
 			}
@@ -724,89 +1000,145 @@ namespace basicx {
 	}
 
 	void NetServer_P::Server_HandleSendMsgs() {
+		std::unique_lock<std::mutex> sender_lock( m_sender_lock ); // ڷ߳ڼȴʱɱ߳ͷź»
 		while( true == m_sender_running ) {
-			m_sender_condition.wait( m_unique_lock );
-			for( ; m_sender_vector_read->m_handled < m_sender_vector_read->m_count; ) {
-				m_sender_vector_read->m_handled++;
-				SendBufInfo* send_buf_info = m_sender_vector_read->m_vec_send_buf_info[m_sender_vector_read->m_handled - 1];
-				try {
-					if( send_buf_info->m_connect_info != nullptr && send_buf_info->m_connect_info->m_available != false ) { // 룡ȻѶϿȥݣȡ˻ᷢѶϿ
-						boost::asio::async_write( *( send_buf_info->m_connect_info->m_socket ), boost::asio::buffer( send_buf_info->m_send_buf ), boost::bind( &NetServer_P::Server_HandleSendData, this, boost::asio::placeholders::error, send_buf_info ) );
-					}
-				}
-				catch( std::exception& ex ) {
-					std::string log_info;
-					Server_CloseOnError( send_buf_info->m_connect_info );
-					if( 1 == m_log_test ) {
-						FormatLibrary::StandardLibrary::FormatTo( log_info, "  Msgs  쳣{0}", ex.what() );
-					}
-					else {
-						log_info = "  Msgs  쳣";
-					}
-					LogPrint( syslog_level::c_error, m_log_cate, log_info );
-				}
+			SendBufInfo* send_buf_info = m_sender_ring->Consume();
+			if( send_buf_info != nullptr ) {
+				Server_HandleSendBuf( send_buf_info );
+				continue;
 			}
-			while( m_sender_vector_read->m_handled == m_sender_vector_read->m_capacity ) { // 軻У capacity ſǸ
-				bool changed = false;
-				m_changing_vector_lock.lock();
-				if( m_sender_vector_read != m_sender_vector_write ) { // д߳ĿУл
-					m_sender_vector_read = m_sender_vector_read == m_sender_vector_1 ? m_sender_vector_2 : m_sender_vector_1; // л
-					m_sender_vector_read->m_handled = 0; // ¿ʼڶм
-					changed = true; //
-				}
-				// else {} // ȴд߳Ŀ
-				m_changing_vector_lock.unlock();
-				if( true == changed ) { // ѻ¶
-					for( ; m_sender_vector_read->m_handled < m_sender_vector_read->m_count; ) {
-						m_sender_vector_read->m_handled++;
-						SendBufInfo* send_buf_info = m_sender_vector_read->m_vec_send_buf_info[m_sender_vector_read->m_handled - 1];
-						try {
-							if( send_buf_info->m_connect_info != nullptr && send_buf_info->m_connect_info->m_available != false ) { // 룡ȻѶϿȥݣȡ˻ᷢѶϿ
-								boost::asio::async_write( *( send_buf_info->m_connect_info->m_socket ), boost::asio::buffer( send_buf_info->m_send_buf ), boost::bind( &NetServer_P::Server_HandleSendData, this, boost::asio::placeholders::error, send_buf_info ) );
-							}
-						}
-						catch( std::exception& ex ) {
-							std::string log_info;
-							Server_CloseOnError( send_buf_info->m_connect_info );
-							if( 1 == m_log_test ) {
-								FormatLibrary::StandardLibrary::FormatTo( log_info, "  Msgs  쳣{0}", ex.what() );
-							}
-							else {
-								log_info = "  Msgs  쳣";
-							}
-							LogPrint( syslog_level::c_error, m_log_cate, log_info );
-						}
-					}
+			if( false == m_sender_ring->IsEmpty() ) { // λռõδԺ򼴿
+				std::this_thread::yield();
+				continue;
+			}
+			if( m_sender_spill_count > 0 ) { // ζӵϢȫȡٴϢ
+				std::list<SendBufInfo*> list_sender_spill;
+				m_sender_spill_lock.lock();
+				list_sender_spill.swap( m_list_sender_spill );
+				m_sender_spill_count -= list_sender_spill.size();
+				m_sender_spill_lock.unlock();
+				for( auto it_sb = list_sender_spill.begin(); it_sb != list_sender_spill.end(); it_sb++ ) {
+					Server_HandleSendBuf( *it_sb );
 				}
-				// ڴϢУдְ߳̿ѶдˣԲǷл
+				continue;
 			}
+			m_sender_waiting = true;
+			if( true == m_sender_ring->IsEmpty() && 0 == m_sender_spill_count ) { // ǺٲһΣʱֻΪֹ©
+				m_sender_condition.wait_for( sender_lock, std::chrono::milliseconds( 1 ) );
+			}
+			m_sender_waiting = false;
 		}
 	}
 
-	void NetServer_P::Server_HandleSendData( const boost::system::error_code& error, SendBufInfo* send_buf_info ) {
-		if( !error ) {
-			try {
-				if( 1 == m_log_test ) {
-					int32_t type( 0 );
-					std::istringstream type_temp( std::string( send_buf_info->m_send_buf, 0, TYPE_BYTES ) );
-					type_temp >> std::hex >> type;
-					int32_t code( 0 );
-					std::istringstream code_temp( std::string( send_buf_info->m_send_buf, TYPE_BYTES, CODE_BYTES ) );
-					code_temp >> std::hex >> code;
-					int32_t size( 0 );
-					std::istringstream size_temp( std::string( send_buf_info->m_send_buf, FLAG_BYTES, SIZE_BYTES ) );
-					size_temp >> std::hex >> size;
-					std::string data( send_buf_info->m_send_buf, HEAD_BYTES, size );
-					std::string log_info;
-					FormatLibrary::StandardLibrary::FormatTo( log_info, "-->[{0}]Type:{1} Code:{2} Size:{3} Data:{4}", send_buf_info->m_connect_info->m_endpoint_r, type, code, size, data.length() );
-					LogPrint( syslog_level::c_info, m_log_cate, log_info );
-				}
+	void NetServer_P::Server_HandleSendBuf( SendBufInfo* slot_buf_info ) { // ݻӵĴУλ漴黹Ӳռûζ
+		SendBufInfo* send_buf_info = nullptr;
+		if( slot_buf_info->m_sender_slot != nullptr ) {
+			m_send_pool_lock.lock();
+			if( !m_vec_send_pool.empty() ) {
+				send_buf_info = m_vec_send_pool.back();
+				m_vec_send_pool.pop_back();
 			}
-			catch( std::exception& ex ) {
-				std::string log_info;
-				Server_CloseOnError( send_buf_info->m_connect_info );
-				if( 1 == m_log_test ) {
-					FormatLibrary::StandardLibrary::FormatTo( log_info, "  Data  쳣{0}", ex.what() );
+			m_send_pool_lock.unlock();
+			if( nullptr == send_buf_info ) {
+				send_buf_info = new SendBufInfo();
+			}
+			send_buf_info->SwapData( *slot_buf_info );
+			m_sender_ring->Release( slot_buf_info );
+		}
+		else { // ʱģֱʹãдͬ뻺
+			send_buf_info = slot_buf_info;
+		}
+
+		ConnectInfo* connect_info = send_buf_info->m_connect_info;
+		if( connect_info != nullptr && connect_info->m_available != false ) { // 룡ȻѶϿȥݣȡ˻ᷢѶϿ
+			bool need_write = false;
+			SendBufInfo* drop_buf_info = nullptr;
+			connect_info->m_send_buf_lock.lock();
+			int32_t push_result = PushSendPending( connect_info, send_buf_info, drop_buf_info );
+			if( push_result >= 0 && false == connect_info->m_send_writing ) { // ûз;𣬷;ɺϲ
+				connect_info->m_send_writing = true;
+				need_write = true;
+			}
+			connect_info->m_send_buf_lock.unlock();
+			m_stat_send_count++;
+			if( 2 == push_result ) { // ͬϢ滻㶪ʧ
+				connect_info->m_stat_conflate_msgs.fetch_add( 1, std::memory_order_relaxed );
+				Server_ReleaseSendBuf( drop_buf_info );
+			}
+			else if( drop_buf_info != nullptr ) { // ֻӵϢ߳
+				connect_info->m_stat_lost_msg++;
+				connect_info->m_stat_drop_msgs.fetch_add( 1, std::memory_order_relaxed );
+				Server_ReleaseSendBuf( drop_buf_info );
+			}
+			if( -2 == push_result ) {
+				Server_CloseBacklog( connect_info );
+			}
+			if( true == need_write ) { // ת strand з𣬱ջصͬʱ socket
+				connect_info->m_strand->post( boost::bind( &NetServer_P::Server_WriteSendBufs, this, connect_info ) );
+			}
+		}
+		else {
+			Server_ReleaseSendBuf( send_buf_info );
+		}
+	}
+
+	void NetServer_P::Server_WriteSendBufs( ConnectInfo* connect_info ) { // ǰ m_send_writing 
+		try {
+			connect_info->m_send_buf_lock.lock();
+			connect_info->m_vec_send_writing.swap( connect_info->m_vec_send_pending ); // m_vec_send_writing ʱΪ
+			connect_info->m_map_send_conflate.clear(); // ;Ĳٺϲ
+			connect_info->m_send_buf_lock.unlock();
+			connect_info->m_send_backlog_time.store( connect_info->m_vec_send_writing[0]->m_enqueue_time, std::memory_order_relaxed ); // зǿղŻᷢ
+			connect_info->m_vec_send_buffers.clear();
+			for( size_t i = 0; i < connect_info->m_vec_send_writing.size(); i++ ) {
+				connect_info->m_vec_send_buffers.push_back( boost::asio::buffer( connect_info->m_vec_send_writing[i]->GetSendBuf() ) );
+			}
+			m_stat_write_count++;
+			boost::asio::async_write( *( connect_info->m_socket ), connect_info->m_vec_send_buffers, connect_info->m_strand->wrap( boost::bind( &NetServer_P::Server_HandleSendData, this, boost::asio::placeholders::error, connect_info ) ) );
+		}
+		catch( std::exception& ex ) {
+			std::string log_info;
+			Server_CloseOnError( connect_info );
+			if( 1 == m_log_test ) {
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "  Msgs  쳣{0}", ex.what() );
+			}
+			else {
+				log_info = "  Msgs  쳣";
+			}
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+			Server_HandleSendData( boost::asio::error::operation_aborted, connect_info ); // 黹沢λͱ
+		}
+	}
+
+	void NetServer_P::Server_HandleSendData( const boost::system::error_code& error, ConnectInfo* connect_info ) {
+		if( !error ) {
+			try {
+				connect_info->m_send_time.store( GetSteadyTimeMs(), std::memory_order_relaxed );
+				int64_t now_time = GetSteadyTimeUs();
+				uint64_t send_bytes = 0;
+				for( size_t i = 0; i < connect_info->m_vec_send_writing.size(); i++ ) {
+					SendBufInfo* send_buf_info = connect_info->m_vec_send_writing[i];
+					send_bytes += send_buf_info->GetSendBuf().length();
+					m_stat_send_latency.Record( now_time - send_buf_info->m_enqueue_time );
+				}
+				connect_info->m_stat_send_bytes.fetch_add( send_bytes, std::memory_order_relaxed );
+				connect_info->m_stat_send_msgs.fetch_add( connect_info->m_vec_send_writing.size(), std::memory_order_relaxed );
+				if( 1 == m_log_test ) {
+					for( size_t i = 0; i < connect_info->m_vec_send_writing.size(); i++ ) {
+						SendBufInfo* send_buf_info = connect_info->m_vec_send_writing[i];
+						FrameHead frame_head;
+						DecodeHead( send_buf_info->GetSendBuf().c_str(), frame_head );
+						std::string log_info;
+						FormatLibrary::StandardLibrary::FormatTo( log_info, "-->[{0}]Type:{1} Code:{2} Size:{3} Data:{4}", connect_info->m_endpoint_r, frame_head.m_type, frame_head.m_code, frame_head.m_size, send_buf_info->m_send_size );
+						LogPrint( syslog_level::c_info, m_log_cate, log_info );
+					}
+				}
+			}
+			catch( std::exception& ex ) {
+				std::string log_info;
+				Server_CloseOnError( connect_info );
+				if( 1 == m_log_test ) {
+					FormatLibrary::StandardLibrary::FormatTo( log_info, "  Data  쳣{0}", ex.what() );
 				}
 				else {
 					log_info = "  Data  쳣";
@@ -814,9 +1146,9 @@ namespace basicx {
 				LogPrint( syslog_level::c_error, m_log_cate, log_info );
 			}
 		}
-		else {
+		else if( error != boost::asio::error::operation_aborted ) {
 			std::string log_info;
-			Server_CloseOnError( send_buf_info->m_connect_info );
+			Server_CloseOnError( connect_info );
 			if( 1 == m_log_test ) {
 				FormatLibrary::StandardLibrary::FormatTo( log_info, "  Data  {0}", error.message().c_str() );
 			}
@@ -825,6 +1157,55 @@ namespace basicx {
 			}
 			LogPrint( syslog_level::c_error, m_log_cate, log_info );
 		}
+
+		for( size_t i = 0; i < connect_info->m_vec_send_writing.size(); i++ ) {
+			Server_ReleaseSendBuf( connect_info->m_vec_send_writing[i] );
+		}
+		connect_info->m_vec_send_writing.clear();
+
+		bool need_write = false;
+		connect_info->m_send_buf_lock.lock();
+		if( connect_info->m_vec_send_pending.empty() ) {
+			connect_info->m_send_writing = false;
+			connect_info->m_send_backlog_time.store( 0, std::memory_order_relaxed );
+		}
+		else if( !error && connect_info->m_available != false ) { // ;ڼܵϢϲΪһη
+			need_write = true;
+		}
+		else { // ѶϿܵϢֱӹ黹
+			for( size_t i = 0; i < connect_info->m_vec_send_pending.size(); i++ ) {
+				Server_ReleaseSendBuf( connect_info->m_vec_send_pending[i] );
+			}
+			connect_info->m_vec_send_pending.clear();
+			connect_info->m_map_send_conflate.clear();
+			connect_info->m_send_writing = false;
+			connect_info->m_send_backlog_time.store( 0, std::memory_order_relaxed );
+		}
+		connect_info->m_send_buf_lock.unlock();
+		if( true == need_write ) {
+			Server_WriteSendBufs( connect_info );
+		}
+	}
+
+	void NetServer_P::Server_ReleaseSendBuf( SendBufInfo* send_buf_info ) {
+		if( send_buf_info->m_connect_info != nullptr ) { // дӶϿڴ˳
+			send_buf_info->m_connect_info->m_stat_send_queue.fetch_sub( 1, std::memory_order_relaxed );
+			send_buf_info->m_connect_info = nullptr;
+		}
+		send_buf_info->m_send_frame.reset(); // ͷŹݰ
+		m_send_pool_lock.lock();
+		m_vec_send_pool.push_back( send_buf_info );
+		m_send_pool_lock.unlock();
+	}
+
+	void NetServer_P::Server_CloseBacklog( ConnectInfo* connect_info ) { // ߳ⶼܵãֻرһ
+		bool active_close = false;
+		if( true == connect_info->m_active_close.compare_exchange_strong( active_close, true ) ) {
+			std::string log_info;
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "  ͻѹϿ[{0}]<-[{1}]{2} {3}", connect_info->m_endpoint_l, connect_info->m_endpoint_r, connect_info->m_identity, connect_info->m_stat_send_queue.load() );
+			LogPrint( syslog_level::c_warn, m_log_cate, log_info );
+			Server_Close( connect_info );
+		}
 	}
 
 	//int32_t NetServer_P::Server_SendData( ConnectInfo* connect_info, int32_t type, int32_t code, std::string& data ) {
@@ -987,22 +1368,12 @@ namespace basicx {
 		if( connect_info ) {
 			connect_info->m_available = false;
 
-			m_local_info_lock.lock();
-			for( auto it_ci = m_list_local_info.begin(); it_ci != m_list_local_info.end(); it_ci++ ) {
-				if( (*it_ci)->m_identity == connect_info->m_identity ) {
-					m_list_local_info.erase( it_ci );
-					m_total_local_connect = m_list_local_info.size(); //
-					break;
-				}
+			if( false == Server_EraseConnect( connect_info ) ) { // 뷢ͳȺرͬһӣֻȲһɺ
+				return;
 			}
-			m_local_info_lock.unlock();
-			m_local_info_index_lock.lock();
-			m_map_local_info_index.erase( connect_info->m_identity );
-			m_local_info_index_lock.unlock();
 
 			// ±ؼϢ
-			std::string listen_endpoint;
-			FormatLibrary::StandardLibrary::FormatTo( listen_endpoint, "tcp://0.0.0.0:{0}", connect_info->m_port_l ); // 0.0.0.0
+			std::string listen_endpoint = Server_GetListenEndpoint( connect_info->m_endpoint_l, connect_info->m_port_l );
 			m_listen_info_lock.lock();
 			auto it_li = m_map_listen_info.find( listen_endpoint );
 			if( it_li != m_map_listen_info.end() ) {
@@ -1038,22 +1409,12 @@ namespace basicx {
 		if( connect_info ) {
 			connect_info->m_available = false;
 
-			m_local_info_lock.lock();
-			for( auto it_ci = m_list_local_info.begin(); it_ci != m_list_local_info.end(); it_ci++ ) {
-				if( (*it_ci)->m_identity == connect_info->m_identity ) {
-					m_list_local_info.erase( it_ci );
-					m_total_local_connect = m_list_local_info.size(); //
-					break;
-				}
+			if( false == Server_EraseConnect( connect_info ) ) { // 뷢ͳȺرͬһӣֻȲһɺ
+				return;
 			}
-			m_local_info_lock.unlock();
-			m_local_info_index_lock.lock();
-			m_map_local_info_index.erase( connect_info->m_identity );
-			m_local_info_index_lock.unlock();
 
 			// ±ؼϢ
-			std::string listen_endpoint;
-			FormatLibrary::StandardLibrary::FormatTo( listen_endpoint, "tcp://0.0.0.0:{0}", connect_info->m_port_l ); // 0.0.0.0
+			std::string listen_endpoint = Server_GetListenEndpoint( connect_info->m_endpoint_l, connect_info->m_port_l );
 			m_listen_info_lock.lock();
 			auto it_li = m_map_listen_info.find( listen_endpoint );
 			if( it_li != m_map_listen_info.end() ) {
@@ -1084,74 +1445,537 @@ namespace basicx {
 	}
 
 	void NetServer_P::Server_CloseAll() { // ر
-		m_local_info_lock.lock();
-		std::list<ConnectInfo*> list_local_info = m_list_local_info;
-		m_local_info_lock.unlock();
+		std::vector<ConnectInfo*> vec_local_info;
+		Server_GetConnectList( vec_local_info );
 
-		for( auto it_ci = list_local_info.begin(); it_ci != list_local_info.end(); it_ci++ ) {
+		for( auto it_ci = vec_local_info.begin(); it_ci != vec_local_info.end(); it_ci++ ) {
 			Server_Close( *it_ci );
 		}
 	}
 
 	void NetServer_P::Server_Close( ConnectInfo* connect_info ) {
-		if( connect_info && connect_info->m_socket.get() ) {
+		if( connect_info && connect_info->m_shm_channel.get() ) {
 			connect_info->m_active_close = true; // 
-			connect_info->m_socket->shutdown( boost::asio::ip::tcp::socket::shutdown_both, boost::system::error_code() );
+			connect_info->m_shm_channel->m_close_request = true; // ɹڴѯ̹߳ر
+		}
+		else if( connect_info && connect_info->m_socket.get() ) {
+			connect_info->m_active_close = true; // 
+			if( connect_info->m_strand.get() ) { // ӵ
+				connect_info->m_strand->post( boost::bind( &NetServer_P::Server_Shutdown, this, connect_info ) );
+			}
+			else {
+				Server_Shutdown( connect_info );
+			}
 		}
 	}
 
-	void NetServer_P::Server_Close( int32_t identity ) {
-		ConnectInfo* connect_info = nullptr;
+	void NetServer_P::Server_Shutdown( ConnectInfo* connect_info ) {
+		boost::system::error_code error;
+		connect_info->m_socket->shutdown( boost::asio::ip::tcp::socket::shutdown_both, error ); // ջصյرմ
+	}
 
-		m_local_info_index_lock.lock();
-		auto it_ci = m_map_local_info_index.find( identity );
-		if( it_ci != m_map_local_info_index.end() ) {
-			connect_info = it_ci->second;
-		}
-		m_local_info_index_lock.unlock();
+	void NetServer_P::Server_Close( int32_t identity ) {
+		ConnectInfo* connect_info = Server_GetConnect( identity );
 
 		if( connect_info ) {
 			Server_Close( connect_info );
 		}
 	}
 
-	void NetServer_P::SendHeartCheck() {
-		time_t now_time_t;
-		time( &now_time_t );
-		m_local_info_lock.lock();
-		std::list<ConnectInfo*> list_local_info = m_list_local_info;
-		m_local_info_lock.unlock();
+	bool NetServer_P::Server_AddListenShm( std::string address_l, std::string node_type_l ) {
+		std::string log_info;
+
+		try {
+			ShmSegmentPtr shm_segment = std::make_shared<ShmSegment>();
+			shm_segment->Create( address_l.substr( strlen( SHM_PROTOCOL ) ), m_shm_slot_number, m_shm_ring_size );
+
+			ShmListenInfo* shm_listen_info = new ShmListenInfo();
+			shm_listen_info->m_address = address_l;
+			shm_listen_info->m_node_type = node_type_l;
+			shm_listen_info->m_segment = shm_segment;
+			shm_listen_info->m_vec_connect_info.resize( m_shm_slot_number, nullptr );
+
+			// ¼ؼϢ
+			m_listen_info_lock.lock();
+			ListenInfo* listen_info = new ListenInfo();
+			listen_info->m_address = address_l;
+			listen_info->m_port = 0;
+			listen_info->m_node_type = node_type_l;
+			listen_info->m_connect_number = 0;
+			m_map_listen_info.insert( std::pair<std::string, ListenInfo*>( address_l, listen_info ) );
+			m_listen_info_lock.unlock();
+
+			m_shm_listen_lock.lock();
+			m_vec_shm_listen.push_back( shm_listen_info );
+			if( false == m_shm_running ) {
+				m_shm_running = true;
+				m_shm_thread = std::thread( &NetServer_P::Thread_ServerShm, this );
+			}
+			m_shm_listen_lock.unlock();
+
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "  ڴ{0}:{1} λ{2} λ棺{3}", address_l, node_type_l, m_shm_slot_number, m_shm_ring_size );
+			LogPrint( syslog_level::c_info, m_log_cate, log_info );
+		}
+		catch( std::exception& ex ) {
+			if( 1 == m_log_test ) {
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "  ڴ 쳣{0}", ex.what() );
+			}
+			else {
+				log_info = "  ڴ 쳣";
+			}
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+			return false;
+		}
+
+		return true;
+	}
+
+	void NetServer_P::Thread_ServerShm() {
+		std::string log_info = " ڴѯ߳ ";
+		LogPrint( syslog_level::c_info, m_log_cate, log_info );
+
+		ShmIdleWait idle_wait;
+		int64_t alive_time = 0;
+		std::vector<ShmListenInfo*> vec_shm_listen;
+		while( true == m_shm_running ) {
+			m_shm_listen_lock.lock();
+			if( vec_shm_listen.size() != m_vec_shm_listen.size() ) { // ֻ
+				vec_shm_listen = m_vec_shm_listen;
+			}
+			m_shm_listen_lock.unlock();
+
+			int64_t now_time = GetSteadyTimeMs();
+			bool update_alive = now_time - alive_time >= SHM_ALIVE_INTERVAL;
+			bool is_busy = false;
+			for( size_t i = 0; i < vec_shm_listen.size(); i++ ) {
+				if( true == update_alive ) {
+					vec_shm_listen[i]->m_segment->GetHead()->m_server_alive_time.store( now_time, std::memory_order_relaxed );
+				}
+				for( uint32_t j = 0; j < vec_shm_listen[i]->m_vec_connect_info.size(); j++ ) {
+					if( true == Server_PollShm( vec_shm_listen[i], j, now_time ) ) {
+						is_busy = true;
+					}
+				}
+			}
+			if( true == update_alive ) {
+				alive_time = now_time;
+			}
+
+			if( true == is_busy ) {
+				idle_wait.Reset();
+			}
+			else {
+				idle_wait.Wait();
+			}
+		}
+
+		log_info = " ڴѯ߳ ˳";
+		LogPrint( syslog_level::c_warn, m_log_cate, log_info );
+	}
+
+	bool NetServer_P::Server_PollShm( ShmListenInfo* shm_listen_info, uint32_t slot_index, int64_t now_time ) {
+		ShmSlot* shm_slot = shm_listen_info->m_segment->GetSlot( slot_index );
+		uint32_t state = shm_slot->m_state.load( std::memory_order_acquire );
+		bool client_dead = now_time - shm_slot->m_client_alive_time.load( std::memory_order_relaxed ) >= SHM_ALIVE_TIMEOUT;
+		ConnectInfo* connect_info = shm_listen_info->m_vec_connect_info[slot_index];
 
-		for( auto it_ci = list_local_info.begin(); it_ci != list_local_info.end(); it_ci++ ) {
-			if( difftime( now_time_t, (*it_ci)->m_heart_check_time ) >= m_heart_check_time ) { // m_heart_check_time û͹
-				Server_SendData( *it_ci, NW_MSG_TYPE_HEART_CHECK, NW_MSG_CODE_NONE, std::string( "" ) );
+		if( nullptr == connect_info ) {
+			if( SHM_SLOT_CLAIMED == state ) {
+				Server_AcceptShm( shm_listen_info, slot_index );
+				return true;
 			}
+			if( state != SHM_SLOT_FREE && true == client_dead ) { // ͻ쳣˳Ĳλ
+				shm_slot->m_state.store( SHM_SLOT_FREE, std::memory_order_release );
+			}
+			return false;
 		}
+
+		ShmChannel* shm_channel = connect_info->m_shm_channel.get();
+		if( true == connect_info->m_available && false == shm_channel->m_close_request && SHM_SLOT_CONNECTED == state && false == client_dead ) {
+			return Server_RecvShm( connect_info );
+		}
+
+		// ֹͣд벢λ TCP ͬĹرմرʱ Server_Close()  m_active_close 
+		shm_channel->Close( true, client_dead );
+		shm_listen_info->m_vec_connect_info[slot_index] = nullptr;
+		if( true == connect_info->m_available ) {
+			Server_CloseOnError( connect_info );
+		}
+		return true;
+	}
+
+	void NetServer_P::Server_AcceptShm( ShmListenInfo* shm_listen_info, uint32_t slot_index ) {
 		std::string log_info;
-		for( auto it_ci = list_local_info.begin(); it_ci != list_local_info.end(); it_ci++ ) {
-			if( (*it_ci)->m_stat_lost_msg > 0 ) {
-				FormatLibrary::StandardLibrary::FormatTo( log_info, " {0} ʧ {1} Ϣ", (*it_ci)->m_endpoint_r, (*it_ci)->m_stat_lost_msg );
-				LogPrint( syslog_level::c_warn, m_log_cate, log_info );
-				(*it_ci)->m_stat_lost_msg = 0;
+
+		ConnectInfo* connect_info = new ConnectInfo();
+		connect_info->m_shard = Server_NextShard(); // мڷƬշڹڴѯ̺߳͵߳
+		connect_info->m_shm_channel = std::make_shared<ShmChannel>( shm_listen_info->m_segment, slot_index, true );
+		connect_info->m_node_type = shm_listen_info->m_node_type;
+		connect_info->m_identity = 0; // ӱʱ
+		connect_info->m_available = true;
+		time( &connect_info->m_heart_check_time );
+		connect_info->m_active_close = false;
+		connect_info->m_send_time = GetSteadyTimeMs();
+		connect_info->m_recv_time = connect_info->m_send_time.load();
+		connect_info->m_head_mode = HEAD_MODE_BINARY; // й̶ʹöưͷЭ
+
+		connect_info->m_protocol_r = "shm";
+		connect_info->m_adress_r = shm_listen_info->m_address;
+		connect_info->m_port_r = slot_index;
+		FormatLibrary::StandardLibrary::FormatTo( connect_info->m_str_port_r, "{0}", connect_info->m_port_r );
+		connect_info->m_endpoint_r = connect_info->m_adress_r + "#" + connect_info->m_str_port_r; // ӱ"shm://name#3"λ
+
+		connect_info->m_protocol_l = "shm";
+		connect_info->m_adress_l = shm_listen_info->m_address;
+		connect_info->m_port_l = 0;
+		connect_info->m_str_port_l = "0";
+		connect_info->m_endpoint_l = shm_listen_info->m_address; // ӱ"shm://name"
+
+		connect_info->m_node_type_intern = InternNodeType( connect_info->m_node_type );
+
+		connect_info->m_recv_buf_head = nullptr;
+		connect_info->m_recv_buf_share = MakeRecvBuf( m_recv_buf_size_s );
+		connect_info->m_recv_buf_data = connect_info->m_recv_buf_share.get();
+		connect_info->m_recv_buf_data_size = m_recv_buf_size_s;
+		connect_info->m_recv_buf_begin = 0;
+		connect_info->m_recv_buf_end = 0;
+
+		Server_InitCompress( connect_info ); // ڴӲѹ
+		Server_InitSendQueue( connect_info );
+
+		connect_info->ResetStat();
+
+		connect_info->m_send_writing = false;
+		connect_info->m_send_backlog_time = 0;
+		connect_info->m_send_pending_base = 0;
+
+		connect_info->m_identity = Server_AddConnect( connect_info );
+		if( connect_info->m_identity < 0 ) {
+			FormatLibrary::StandardLibrary::FormatTo( log_info, " ȫ {0}:{1} ܾӣ[{2}]<-[{3}]", m_total_local_connect.load(), m_max_connect_total_s, connect_info->m_endpoint_l, connect_info->m_endpoint_r );
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+			connect_info->m_shm_channel->m_slot->m_state.store( SHM_SLOT_SERVER_CLOSED, std::memory_order_release ); // ͻ˿ӲͷŲλ
+			connect_info->clear();
+			delete connect_info;
+			return;
+		}
+
+		connect_info->m_shm_channel->m_slot->m_state.store( SHM_SLOT_CONNECTED, std::memory_order_release );
+		shm_listen_info->m_vec_connect_info[slot_index] = connect_info;
+
+		FormatLibrary::StandardLibrary::FormatTo( log_info, " ӣ[{0}]<-[{1}]{2}", connect_info->m_endpoint_l, connect_info->m_endpoint_r, connect_info->m_identity );
+		LogPrint( syslog_level::c_info, m_log_cate, log_info );
+
+		connect_info->m_shard->m_heart_wheel->Schedule( connect_info->m_identity, Server_GetCheckTime( connect_info ) );
+
+		// ±ؼϢ
+		m_listen_info_lock.lock();
+		auto it_li = m_map_listen_info.find( connect_info->m_endpoint_l );
+		if( it_li != m_map_listen_info.end() ) {
+			it_li->second->m_connect_number++;
+		}
+		m_listen_info_lock.unlock();
+
+		if( nullptr != m_net_server_x ) {
+			NetServerInfo net_server_info( WM_MY_NEWCONNECT_LOCAL, connect_info->m_node_type, connect_info->m_identity, connect_info->m_endpoint_l, connect_info->m_endpoint_r ); // ͨģյµĴӿͻ
+			m_net_server_x->OnNetServerInfo( net_server_info );
+		}
+	}
+
+	bool NetServer_P::Server_RecvShm( ConnectInfo* connect_info ) {
+		ShmChannel* shm_channel = connect_info->m_shm_channel.get();
+		int32_t recv_number = 0;
+		try {
+			uint64_t record_size = 0;
+			const char* record = nullptr;
+			while( recv_number < SHM_RECV_BATCH && ( record = shm_channel->Peek( record_size ) ) != nullptr ) {
+				if( record_size < HEAD_BYTES || record_size > shm_channel->GetFrameSizeMax() ) {
+					std::string log_info;
+					Server_CloseOnError( connect_info );
+					FormatLibrary::StandardLibrary::FormatTo( log_info, " յ 쳣Ĺڴ¼С{0}", record_size );
+					LogPrint( syslog_level::c_error, m_log_cate, log_info );
+					break;
+				}
+
+				// Ƶջλռ䣬صԿ TCP һȡȨ
+				if( record_size > connect_info->m_recv_buf_data_size || connect_info->m_recv_buf_share.use_count() > 1 ) {
+					size_t recv_buf_size = record_size > connect_info->m_recv_buf_data_size ? (size_t)record_size : connect_info->m_recv_buf_data_size;
+					connect_info->m_recv_buf_share = MakeRecvBuf( recv_buf_size );
+					connect_info->m_recv_buf_data = connect_info->m_recv_buf_share.get();
+					connect_info->m_recv_buf_data_size = recv_buf_size;
+				}
+				memcpy( connect_info->m_recv_buf_data, record, (size_t)record_size );
+				shm_channel->Pop( record_size );
+				recv_number++;
+
+				size_t frame_size = 0;
+				if( false == Server_HandleRecvFrame( connect_info, connect_info->m_recv_buf_data, (size_t)record_size, frame_size ) || false == connect_info->m_available ) {
+					break; // ѹر
+				}
+				if( frame_size != record_size ) { // ͷ¼
+					std::string log_info;
+					Server_CloseOnError( connect_info );
+					FormatLibrary::StandardLibrary::FormatTo( log_info, " յ 쳣ĹڴݰС{0} != {1}", frame_size, record_size );
+					LogPrint( syslog_level::c_error, m_log_cate, log_info );
+					break;
+				}
+			}
+			if( recv_number > 0 ) {
+				connect_info->m_recv_time.store( GetSteadyTimeMs(), std::memory_order_relaxed );
 			}
 		}
+		catch( std::exception& ex ) {
+			std::string log_info;
+			Server_CloseOnError( connect_info );
+			if( 1 == m_log_test ) {
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "  ڴ  쳣{0}", ex.what() );
+			}
+			else {
+				log_info = "  ڴ  쳣";
+			}
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+		}
+		return recv_number > 0;
+	}
+
+	int32_t NetServer_P::Server_SendShm( ConnectInfo* connect_info, int32_t type, int32_t code, std::string& data ) {
+		int32_t result = -3;
+		if( data.length() <= m_max_data_length_s ) {
+			result = connect_info->m_shm_channel->Write( type, code, data );
+		}
+		if( 0 == result ) {
+			connect_info->m_send_time.store( GetSteadyTimeMs(), std::memory_order_relaxed );
+			connect_info->m_stat_send_bytes.fetch_add( HEAD_BYTES + data.length(), std::memory_order_relaxed );
+			connect_info->m_stat_send_msgs.fetch_add( 1, std::memory_order_relaxed );
+		}
+		else if( -1 == result ) { // ԶѸ
+			connect_info->m_stat_lost_msg++;
+			connect_info->m_stat_drop_msgs.fetch_add( 1, std::memory_order_relaxed );
+		}
+		else if( -3 == result ) {
+			std::string log_info;
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "  Data Ϣ {0} > {1}", data.length(), std::min( m_max_data_length_s, (size_t)( connect_info->m_shm_channel->GetFrameSizeMax() - HEAD_BYTES ) ) );
+			LogPrint( syslog_level::c_warn, m_log_cate, log_info );
+		}
+		return result;
+	}
+
+	void NetServer_P::Server_StartWheel( ServerShard* shard ) {
+		shard->m_wheel_timer->expires_from_now( std::chrono::milliseconds( shard->m_heart_wheel->GetTickMs() ) );
+		shard->m_wheel_timer->async_wait( boost::bind( &NetServer_P::Server_HandleWheel, this, boost::asio::placeholders::error, shard ) );
+	}
+
+	void NetServer_P::Server_HandleWheel( const boost::system::error_code& error, ServerShard* shard ) {
+		if( boost::asio::error::operation_aborted == error ) {
+			return;
+		}
+
+		try {
+			int64_t now_time = GetSteadyTimeMs();
+			std::vector<int32_t> vec_identity; // ֻеڵ
+			shard->m_heart_wheel->Advance( now_time, vec_identity );
+			for( size_t i = 0; i < vec_identity.size(); i++ ) {
+				Server_CheckConnect( shard, vec_identity[i], now_time );
+			}
+		}
+		catch( std::exception& ex ) {
+			std::string log_info;
+			if( 1 == m_log_test ) {
+				FormatLibrary::StandardLibrary::FormatTo( log_info, "  쳣{0}", ex.what() );
+			}
+			else {
+				log_info = "  쳣";
+			}
+			LogPrint( syslog_level::c_error, m_log_cate, log_info );
+		}
+
+		Server_StartWheel( shard );
+	}
+
+	void NetServer_P::Server_CheckConnect( ServerShard* shard, int32_t identity, int64_t now_time ) {
+		ConnectInfo* connect_info = shard->m_connect_table->Find( Server_GetHandle( identity ) );
+		if( nullptr == connect_info || false == connect_info->m_available ) { // ѹرգǹڣٵ
+			return;
+		}
+
+		std::string log_info;
+		if( connect_info->m_stat_lost_msg > 0 ) {
+			FormatLibrary::StandardLibrary::FormatTo( log_info, " {0} ʧ {1} Ϣ", connect_info->m_endpoint_r, connect_info->m_stat_lost_msg );
+			LogPrint( syslog_level::c_warn, m_log_cate, log_info );
+			connect_info->m_stat_lost_msg = 0;
+		}
+
+		if( m_idle_timeout_s > 0 && now_time - connect_info->m_recv_time >= m_idle_timeout_s ) {
+			FormatLibrary::StandardLibrary::FormatTo( log_info, "  гʱ[{0}]<-[{1}]{2}", connect_info->m_endpoint_l, connect_info->m_endpoint_r, connect_info->m_identity );
+			LogPrint( syslog_level::c_warn, m_log_cate, log_info );
+			Server_Close( connect_info );
+			return;
+		}
+
+		int64_t backlog_time = connect_info->m_send_backlog_time.load( std::memory_order_relaxed );
+		if( connect_info->m_send_backlog_timeout > 0 && backlog_time > 0 && now_time - backlog_time / 1000 >= connect_info->m_send_backlog_timeout ) { // ûϢʱɴ˷ֻѹ
+			Server_CloseBacklog( connect_info );
+			return;
+		}
+
+		if( m_heart_check_time > 0 && now_time - connect_info->m_send_time >= m_heart_check_time * 1000 ) { // m_heart_check_time û͹
+			Server_SendData( connect_info, NW_MSG_TYPE_HEART_CHECK, NW_MSG_CODE_NONE, std::string( "" ) );
+			connect_info->m_send_time = now_time; // ʱٸ£ⷢδǰظ
+		}
+
+		shard->m_heart_wheel->Schedule( identity, Server_GetCheckTime( connect_info ) );
+	}
+
+	int64_t NetServer_P::Server_GetCheckTime( ConnectInfo* connect_info ) { // ´ѹнһ
+		int64_t check_time = INT64_MAX;
+		if( m_heart_check_time > 0 ) {
+			check_time = connect_info->m_send_time + m_heart_check_time * 1000;
+		}
+		if( m_idle_timeout_s > 0 ) {
+			check_time = std::min( check_time, connect_info->m_recv_time + m_idle_timeout_s );
+		}
+		if( connect_info->m_send_backlog_timeout > 0 ) { // ѹʱܿʼʱڲ鿴
+			check_time = std::min( check_time, GetSteadyTimeMs() + connect_info->m_send_backlog_timeout );
+		}
+		if( INT64_MAX == check_time ) { // ʱԶڼ鶪ʧϢͳ
+			check_time = GetSteadyTimeMs() + 10000;
+		}
+		return check_time;
+	}
+
+	void NetServer_P::Server_SetShardNumber( int32_t shard_number, bool cpu_affinity ) {
+		m_shard_number = shard_number > 0 ? shard_number : 0;
+		m_shard_cpu_affinity = cpu_affinity;
+	}
+
+	void NetServer_P::Server_SetIdleTimeout( int32_t idle_timeout ) {
+		m_idle_timeout_s = idle_timeout > 0 ? idle_timeout : 0;
+	}
+
+	void NetServer_P::Server_SetBinaryHead( bool binary_head ) {
+		m_binary_head_s = binary_head;
+	}
+
+	void NetServer_P::Server_SetRecvBufSize( size_t recv_buf_size ) {
+		m_recv_buf_size_s = recv_buf_size > HEAD_BYTES ? recv_buf_size : HEAD_BYTES;
+	}
+
+	void NetServer_P::Server_SetSenderPolicy( int32_t sender_policy ) {
+		m_sender_policy = sender_policy;
+	}
+
+	void NetServer_P::Server_SetShmOption( uint32_t slot_number, uint64_t ring_size ) {
+		m_shm_slot_number = slot_number > 0 ? slot_number : 1;
+		m_shm_ring_size = 4096;
+		while( m_shm_ring_size < ring_size ) { // ȡСֵָ 2 
+			m_shm_ring_size <<= 1;
+		}
+	}
+
+	void NetServer_P::Server_SetCompression( std::string node_type_l, int32_t codec, size_t threshold, std::string dict ) {
+		std::string log_info;
+		if( codec != NW_COMPRESS_NONE && false == IsCodecSupported( codec ) ) {
+			FormatLibrary::StandardLibrary::FormatTo( log_info, " ѹʽ {0} δ֧֣ LZ ѹ{1}", codec, node_type_l );
+			LogPrint( syslog_level::c_warn, m_log_cate, log_info );
+			codec = NW_COMPRESS_LZ;
+		}
+		CompressConfig compress_config;
+		compress_config.m_codec = codec;
+		compress_config.m_threshold = threshold;
+		compress_config.m_dict = MakeCompressDict( dict );
+		m_compress_dict_table.Add( compress_config.m_dict ); // ѹʱҲǼֵ䣬ڽѹԶ
+		m_compress_lock.lock();
+		m_map_compress_config[node_type_l] = compress_config;
+		m_compress_lock.unlock();
+		FormatLibrary::StandardLibrary::FormatTo( log_info, "  ѹ{0} ʽ{1} ֵ{2} ֵ䣺{3}", node_type_l, codec, threshold, compress_config.m_dict != nullptr ? compress_config.m_dict->m_dict.length() : 0 );
+		LogPrint( syslog_level::c_info, m_log_cate, log_info );
+	}
+
+	void NetServer_P::Server_InitCompress( ConnectInfo* connect_info ) {
+		connect_info->m_compress_codec = NW_COMPRESS_NONE;
+		connect_info->m_compress_threshold = 0;
+		connect_info->m_unpack_buf_size = 0;
+		if( nullptr == connect_info->m_shm_channel ) {
+			std::lock_guard<std::mutex> lock( m_compress_lock );
+			auto it_cc = m_map_compress_config.find( connect_info->m_node_type );
+			if( it_cc != m_map_compress_config.end() ) {
+				connect_info->m_compress_codec = it_cc->second.m_codec;
+				connect_info->m_compress_threshold = it_cc->second.m_threshold;
+				connect_info->m_compress_dict = it_cc->second.m_dict;
+			}
+		}
+	}
+
+	void NetServer_P::Server_SetSendQueue( std::string node_type_l, size_t queue_limit, int32_t queue_policy, int32_t backlog_timeout ) {
+		SendQueueConfig send_queue_config;
+		send_queue_config.m_queue_limit = queue_limit;
+		send_queue_config.m_queue_policy = queue_policy;
+		send_queue_config.m_backlog_timeout = backlog_timeout > 0 ? backlog_timeout : 0;
+		m_send_queue_lock.lock();
+		m_map_send_queue_config[node_type_l] = send_queue_config;
+		m_send_queue_lock.unlock();
+		std::string log_info;
+		FormatLibrary::StandardLibrary::FormatTo( log_info, "  ͶУ{0} ޣ{1} ԣ{2} ѹʱ{3}", node_type_l, queue_limit, queue_policy, send_queue_config.m_backlog_timeout );
+		LogPrint( syslog_level::c_info, m_log_cate, log_info );
+	}
+
+	void NetServer_P::Server_InitSendQueue( ConnectInfo* connect_info ) { // ڴӲ̣߳ò
+		connect_info->m_send_queue_limit = 0;
+		connect_info->m_send_queue_policy = NW_QUEUE_DROP_NEWEST;
+		connect_info->m_send_backlog_timeout = 0;
+		std::lock_guard<std::mutex> lock( m_send_queue_lock );
+		auto it_sq = m_map_send_queue_config.find( connect_info->m_node_type );
+		if( it_sq != m_map_send_queue_config.end() ) {
+			connect_info->m_send_queue_limit = it_sq->second.m_queue_limit;
+			connect_info->m_send_queue_policy = it_sq->second.m_queue_policy;
+			connect_info->m_send_backlog_timeout = it_sq->second.m_backlog_timeout;
+		}
+	}
+
+	void NetServer_P::CollectMetrics( NetMetrics& net_metrics, bool with_connect ) {
+		net_metrics.m_source_id = m_source_id;
+		net_metrics.m_role = METRICS_ROLE_SERVER;
+		net_metrics.m_snapshot_time = 0;
+		net_metrics.m_connect_count = 0;
+		m_stat_closed.CopyTo( net_metrics );
+		net_metrics.m_reconnect_attempt = 0;
+		net_metrics.m_reconnect_success = 0;
+		net_metrics.m_reconnect_failure = 0;
+		m_stat_send_latency.CopyTo( net_metrics.m_latency_histogram );
+		net_metrics.m_vec_connect.clear();
+		std::vector<ConnectInfo*> vec_local_info;
+		Server_GetConnectList( vec_local_info );
+		for( size_t i = 0; i < vec_local_info.size(); i++ ) {
+			CollectConnectMetrics( vec_local_info[i], net_metrics, with_connect );
+		}
+	}
+
+	NetServerSenderStat NetServer_P::Server_GetSenderStat() {
+		NetServerSenderStat sender_stat;
+		sender_stat.m_policy = m_sender_policy;
+		sender_stat.m_capacity = m_sender_ring != nullptr ? m_sender_ring->GetCapacity() : 0;
+		sender_stat.m_send_count = m_stat_send_count;
+		sender_stat.m_write_count = m_stat_write_count;
+		sender_stat.m_drop_count = m_stat_drop_count;
+		sender_stat.m_block_count = m_stat_block_count;
+		sender_stat.m_grow_count = m_stat_grow_count;
+		return sender_stat;
 	}
 
 	size_t NetServer_P::Server_GetConnectCount() {
-		return m_list_local_info.size();
+		return m_total_local_connect;
 	}
 
 	ConnectInfo* NetServer_P::Server_GetConnect( int32_t identity ) {
-		ConnectInfo* connect_info = nullptr;
-
-		m_local_info_index_lock.lock();
-		auto it_ci = m_map_local_info_index.find( identity );
-		if( it_ci != m_map_local_info_index.end() ) {
-			connect_info = it_ci->second;
+		ServerShard* shard = Server_GetShard( identity );
+		if( nullptr == shard ) {
+			return nullptr;
 		}
-		m_local_info_index_lock.unlock();
+		return shard->m_connect_table->Find( Server_GetHandle( identity ) ); // ǹʱؿ
+	}
 
-		return connect_info;
+	bool NetServer_P::Server_IsConnectValid( int32_t identity ) {
+		ConnectInfo* connect_info = Server_GetConnect( identity );
+		return connect_info != nullptr && true == connect_info->m_available;
 	}
 
 	NetServer::NetServer()
@@ -1205,6 +2029,26 @@ namespace basicx {
 		return m_net_server_p->Server_SendData( connect_info, type, code, data );
 	}
 
+	int32_t NetServer::Server_SendData( int32_t identity, int32_t type, int32_t code, std::string& data ) {
+		return m_net_server_p->Server_SendData( identity, type, code, data );
+	}
+
+	int32_t NetServer::Server_SendConflateAll( int32_t type, int32_t code, const std::string& conflate_key, std::string& data ) {
+		return m_net_server_p->Server_SendConflateAll( type, code, conflate_key, data );
+	}
+
+	int32_t NetServer::Server_SendConflate( ConnectInfo* connect_info, int32_t type, int32_t code, const std::string& conflate_key, std::string& data ) {
+		return m_net_server_p->Server_SendConflate( connect_info, type, code, conflate_key, data );
+	}
+
+	int32_t NetServer::Server_SendConflate( int32_t identity, int32_t type, int32_t code, const std::string& conflate_key, std::string& data ) {
+		return m_net_server_p->Server_SendConflate( identity, type, code, conflate_key, data );
+	}
+
+	int32_t NetServer::Server_SendAnswer( int32_t identity, uint64_t request_id, int32_t code, std::string& data ) {
+		return m_net_server_p->Server_SendAnswer( identity, request_id, code, data );
+	}
+
 	void NetServer::Server_CloseAll() {
 		m_net_server_p->Server_CloseAll();
 	}
@@ -1217,6 +2061,49 @@ namespace basicx {
 		m_net_server_p->Server_Close( identity );
 	}
 
+	void NetServer::Server_SetShardNumber( int32_t shard_number, bool cpu_affinity/* = false*/ ) {
+		m_net_server_p->Server_SetShardNumber( shard_number, cpu_affinity );
+	}
+
+	void NetServer::Server_SetIdleTimeout( int32_t idle_timeout ) {
+		m_net_server_p->Server_SetIdleTimeout( idle_timeout );
+	}
+
+	void NetServer::Server_SetBinaryHead( bool binary_head ) {
+		m_net_server_p->Server_SetBinaryHead( binary_head );
+	}
+
+	void NetServer::Server_SetRecvBufSize( size_t recv_buf_size ) {
+		m_net_server_p->Server_SetRecvBufSize( recv_buf_size );
+	}
+
+	void NetServer::Server_SetSenderPolicy( int32_t sender_policy ) {
+		m_net_server_p->Server_SetSenderPolicy( sender_policy );
+	}
+
+	void NetServer::Server_SetShmOption( uint32_t slot_number, uint64_t ring_size ) {
+		m_net_server_p->Server_SetShmOption( slot_number, ring_size );
+	}
+
+	void NetServer::Server_SetCompression( std::string node_type_l, int32_t codec, size_t threshold, std::string dict ) {
+		m_net_server_p->Server_SetCompression( node_type_l, codec, threshold, dict );
+	}
+
+	void NetServer::Server_SetSendQueue( std::string node_type_l, size_t queue_limit, int32_t queue_policy, int32_t backlog_timeout ) {
+		m_net_server_p->Server_SetSendQueue( node_type_l, queue_limit, queue_policy, backlog_timeout );
+	}
+
+	NetMetrics NetServer::Server_GetMetrics( bool with_connect ) {
+		NetMetrics net_metrics;
+		m_net_server_p->CollectMetrics( net_metrics, with_connect );
+		net_metrics.m_snapshot_time = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::system_clock::now().time_since_epoch() ).count();
+		return net_metrics;
+	}
+
+	NetServerSenderStat NetServer::Server_GetSenderStat() {
+		return m_net_server_p->Server_GetSenderStat();
+	}
+
 	size_t NetServer::Server_GetConnectCount() {
 		return m_net_server_p->Server_GetConnectCount();
 	}
@@ -1225,4 +2112,8 @@ namespace basicx {
 		return m_net_server_p->Server_GetConnect( identity );
 	}
 
+	bool NetServer::Server_IsConnectValid( int32_t identity ) {
+		return m_net_server_p->Server_IsConnectValid( identity );
+	}
+
 } // namespace basicx
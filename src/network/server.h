@@ -23,12 +23,20 @@
 #define BASICX_NETWORK_SERVER_H
 
 #include <string>
+#include <memory>
 #include <stdint.h>
 
 #include <common/compile.h>
 
+#include "metrics.h"
+
 namespace basicx {
 
+	#define SENDER_POLICY_DROP 0 // ͶʱϢ
+	#define SENDER_POLICY_BLOCK 1 // Ͷʱȴλʱ
+	#define SENDER_POLICY_GROW 2 // Ͷʱ޽
+	#define SENDER_BLOCK_TIMEOUT 1000 // 룬BLOCK ȴ߳ڷʱ޷黹λ
+
 	#pragma pack( push )
 	#pragma pack( 1 )
 
@@ -61,10 +69,35 @@ namespace basicx {
 		int32_t m_identity;
 		int32_t m_code;
 		std::string m_data;
+		uint64_t m_request_id; //  0 ʱΪ Server_SendAnswer() Ӧ
 
 		NetServerData( std::string& node_type, int32_t identity, int32_t code, std::string& data );
 	};
 
+	struct BASICX_NETWORK_EXPIMP NetServerView // ͣݣm_data ڻصڼЧ
+	{
+		const std::string* m_node_type; // פͬͽڵַͬڳЧ
+		int32_t m_identity;
+		int32_t m_code;
+		const char* m_data; // ʱȥ
+		size_t m_size;
+		uint64_t m_request_id; //  0 ʱΪ Server_SendAnswer() Ӧ
+		std::shared_ptr<char>* m_data_owner; // ڲʹ
+
+		std::shared_ptr<const char> TakeData() const; // ȡȨƣָ m_data ͬصЧ
+	};
+
+	struct NetServerSenderStat // ڷͶͳ
+	{
+		int32_t m_policy;
+		size_t m_capacity;
+		uint64_t m_send_count; // ύ
+		uint64_t m_write_count; // ϲʵ async_write 
+		uint64_t m_drop_count; // BLOCK ʱҲ
+		uint64_t m_block_count; // BLOCK Եȴ
+		uint64_t m_grow_count; // GROW Ϣ
+	};
+
 	#pragma pack( pop )
 
 	class BASICX_NETWORK_EXPIMP NetServer_X
@@ -75,6 +108,7 @@ namespace basicx {
 
 		virtual void OnNetServerInfo( NetServerInfo& net_client_info ) = 0;
 		virtual void OnNetServerData( NetServerData& net_client_data ) = 0;
+		virtual void OnNetServerView( NetServerView& net_server_view ); // ĬתΪ NetServerData  OnNetServerData()ؼȥ
 	};
 
 	struct ConnectInfo;
@@ -98,17 +132,38 @@ namespace basicx {
 	public:
 		bool Server_CanAddConnect();
 		bool Server_CanAddListen( std::string address_l, int32_t port_l ); // 0.0.0.0
-		bool Server_AddListen( std::string address_l, int32_t port_l, std::string node_type_l ); // 0.0.0.0
+		bool Server_AddListen( std::string address_l, int32_t port_l, std::string node_type_l ); // 0.0.0.0address_l Ϊ "shm://name" ʱΪͬڴ port_l
 
 		int32_t Server_SendDataAll( int32_t type, int32_t code, std::string& data );
 		int32_t Server_SendData( ConnectInfo* connect_info, int32_t type, int32_t code, std::string& data );
+		int32_t Server_SendData( int32_t identity, int32_t type, int32_t code, std::string& data ); // ӱǷͣѹرʱǼڣ -4
+
+		// ϲͣʺֵֻ(簴Լ͵)дǰͬһ conflate_key ĴϢֻһҲռµĶλ
+		// ;ϢӰ죬ӻѹڼÿһ Server_SendData() 죻ڴӲͶУϲ
+		int32_t Server_SendConflateAll( int32_t type, int32_t code, const std::string& conflate_key, std::string& data );
+		int32_t Server_SendConflate( ConnectInfo* connect_info, int32_t type, int32_t code, const std::string& conflate_key, std::string& data );
+		int32_t Server_SendConflate( int32_t identity, int32_t type, int32_t code, const std::string& conflate_key, std::string& data ); // ֵͬ Server_SendData()
+
+		int32_t Server_SendAnswer( int32_t identity, uint64_t request_id, int32_t code, std::string& data ); // Ӧ NetClient::Client_SendRequest() 󣬿̡߳ʱ
 
 		void Server_CloseAll();
 		void Server_Close( ConnectInfo* connect_info );
 		void Server_Close( int32_t identity );
 
+		void Server_SetShardNumber( int32_t shard_number, bool cpu_affinity = false ); // ƬÿƬռһ io_service߳ӱ StartNetwork() ǰã0 ΪƬ
+		void Server_SetIdleTimeout( int32_t idle_timeout ); // 룬ʱδյ()رӣ0 Ϊ⣬Ĭϲ
+		void Server_SetBinaryHead( bool binary_head ); // Ƿܿͻ˸öưͷĬϽ
+		void Server_SetRecvBufSize( size_t recv_buf_size ); // ÿӵĽջʼС StartNetwork() ǰ
+		void Server_SetSenderPolicy( int32_t sender_policy ); //  StartNetwork() ǰãĬϲ޻ʱΪ GROWΪ DROP
+		void Server_SetShmOption( uint32_t slot_number, uint64_t ring_size ); // ֮ĹڴͬʱӵĿͻÿĻλֽĬ SHM_SLOT_NUMBER  SHM_RING_SIZE
+		void Server_SetCompression( std::string node_type_l, int32_t codec, size_t threshold, std::string dict = "" ); // ֮ĸýڵӣЭΪưͷ岻С threshold ֽڼ NW_COMPRESS_* ѹdict ΪԼԤֵ( Json )Զ˵Ǽͬһֵܽѹ
+		void Server_SetSendQueue( std::string node_type_l, size_t queue_limit, int32_t queue_policy, int32_t backlog_timeout = 0 ); // ֮ĸýڵӣϢﵽ queue_limit ʱ NW_QUEUE_* ĴϢ backlog_timeout δдϿ0 ΪޣĬ϶
+		NetServerSenderStat Server_GetSenderStat();
+		NetMetrics Server_GetMetrics( bool with_connect = true ); // ʵշͳƿգwith_connect Ϊ false ʱֻȡϼ
+
 		size_t Server_GetConnectCount();
-		ConnectInfo* Server_GetConnect( int32_t identity );
+		ConnectInfo* Server_GetConnect( int32_t identity ); // ңǹʱؿգӹرպԭָԿɷʵѲãڳĴӱ
+		bool Server_IsConnectValid( int32_t identity );
 
 	private:
 		NetServer_P* m_net_server_p;
@@ -29,7 +29,7 @@ namespace basicx {
 
 	class SysLog_S;
 
-	class NetServer_P
+	class NetServer_P : public NetMetricsSource
 	{
 	public:
 		NetServer_P();
@@ -41,27 +41,45 @@ namespace basicx {
 		void LogPrint( syslog_level log_level, std::string& log_cate, std::string& log_info, int32_t log_show = 0 );
 
 	public:
-		void Thread_ServerOnTime();
 		void Thread_NetServer();
+		void Thread_ServerShard( ServerShard* shard );
 		void StartNetwork( NetServerCfg& config );
 		bool IsNetworkStarted();
 		bool IsConnectAvailable( ConnectInfo* connect_info );
 
-		int32_t Server_GetIdentity();
+		int32_t Server_AddConnect( ConnectInfo* connect_info ); // Ƭӱӱǣʱ -1
+		ServerShard* Server_GetShard( int32_t identity );
+		int32_t Server_GetHandle( int32_t identity );
+		ServerShard* Server_NextShard();
+		void Server_GetConnectList( std::vector<ConnectInfo*>& vec_local_info );
+		bool Server_EraseConnect( ConnectInfo* connect_info );
 
 		bool Server_CanAddConnect();
 		bool Server_CanAddListen( std::string address_l, int32_t port_l ); // 0.0.0.0
 		bool Server_AddListen( std::string address_l, int32_t port_l, std::string node_type_l ); // 0.0.0.0
-		void Server_HandleAccept( const boost::system::error_code& error, ConnectInfo* connect_info, AcceptorPtr acceptor );
-		void Server_KeepOnAccept( std::string node_type_l, AcceptorPtr acceptor );
+		std::string Server_GetListenEndpoint( const std::string& address_l, int32_t port_l ); // ؼϢļ"tcp://0.0.0.0:465""shm://name"
+		void Server_HandleAccept( const boost::system::error_code& error, ConnectInfo* connect_info, AcceptorPtr acceptor, ServerShard* accept_shard );
+		void Server_KeepOnAccept( std::string node_type_l, AcceptorPtr acceptor, ServerShard* accept_shard ); // accept_shard Ϊʱ䵽Ƭ
 
-		void Server_HandleRecvHead( const boost::system::error_code& error, ConnectInfo* connect_info );
-		void Server_HandleRecvData( const boost::system::error_code& error, ConnectInfo* connect_info, int32_t type, int32_t code, int32_t size );
+		void Server_RecvData( ConnectInfo* connect_info );
+		void Server_HandleRecvData( const boost::system::error_code& error, size_t recv_size, ConnectInfo* connect_info );
+		bool Server_HandleRecvFrame( ConnectInfo* connect_info, const char* frame, size_t recv_size, size_t& frame_size );
+		void Server_HandleHeadBinary( ConnectInfo* connect_info );
 
 		int32_t Server_SendDataAll( int32_t type, int32_t code, std::string& data );
 		int32_t Server_SendData( ConnectInfo* connect_info, int32_t type, int32_t code, std::string& data );
+		int32_t Server_SendData( int32_t identity, int32_t type, int32_t code, std::string& data );
+		int32_t Server_SendConflateAll( int32_t type, int32_t code, const std::string& conflate_key, std::string& data );
+		int32_t Server_SendConflate( ConnectInfo* connect_info, int32_t type, int32_t code, const std::string& conflate_key, std::string& data );
+		int32_t Server_SendConflate( int32_t identity, int32_t type, int32_t code, const std::string& conflate_key, std::string& data );
+		int32_t Server_SendAnswer( int32_t identity, uint64_t request_id, int32_t code, std::string& data );
+		int32_t Server_SendData( ConnectInfo* connect_info, int32_t type, int32_t code, std::string& data, FramePtr* send_frames, const std::string* conflate_key ); // send_frames Ϊʱͷʽconflate_key Ϊʱϲ
 		void Server_HandleSendMsgs();
-		void Server_HandleSendData( const boost::system::error_code& error, SendBufInfo* send_buf_info );
+		void Server_HandleSendBuf( SendBufInfo* slot_buf_info );
+		void Server_WriteSendBufs( ConnectInfo* connect_info );
+		void Server_HandleSendData( const boost::system::error_code& error, ConnectInfo* connect_info );
+		void Server_ReleaseSendBuf( SendBufInfo* send_buf_info );
+		void Server_CloseBacklog( ConnectInfo* connect_info );
 
 		void Server_CloseOnError( ConnectInfo* connect_info );
 		void Server_PassiveClose( ConnectInfo* connect_info );
@@ -69,36 +87,64 @@ namespace basicx {
 		void Server_CloseAll();
 		void Server_Close( ConnectInfo* connect_info );
 		void Server_Close( int32_t identity );
-
-		void SendHeartCheck();
+		void Server_Shutdown( ConnectInfo* connect_info );
+
+		bool Server_AddListenShm( std::string address_l, std::string node_type_l );
+		void Thread_ServerShm();
+		bool Server_PollShm( ShmListenInfo* shm_listen_info, uint32_t slot_index, int64_t now_time ); //  false ʾòλֿ
+		void Server_AcceptShm( ShmListenInfo* shm_listen_info, uint32_t slot_index );
+		bool Server_RecvShm( ConnectInfo* connect_info );
+		int32_t Server_SendShm( ConnectInfo* connect_info, int32_t type, int32_t code, std::string& data );
+
+		void Server_StartWheel( ServerShard* shard );
+		void Server_HandleWheel( const boost::system::error_code& error, ServerShard* shard );
+		void Server_CheckConnect( ServerShard* shard, int32_t identity, int64_t now_time );
+		int64_t Server_GetCheckTime( ConnectInfo* connect_info );
+
+		void Server_SetShardNumber( int32_t shard_number, bool cpu_affinity ); //  StartNetwork() ǰã0 ΪƬ
+		void Server_SetIdleTimeout( int32_t idle_timeout ); // 룬ʱδյرӣ0 Ϊ
+		void Server_SetBinaryHead( bool binary_head ); // Ƿܿͻ˸öưͷĬϽ
+		void Server_SetRecvBufSize( size_t recv_buf_size ); // ÿӵĽջʼС StartNetwork() ǰ
+		void Server_SetSenderPolicy( int32_t sender_policy ); //  StartNetwork() ǰãĬϲ޻ʱΪ GROWΪ DROP
+		void Server_SetShmOption( uint32_t slot_number, uint64_t ring_size );
+		void Server_SetCompression( std::string node_type_l, int32_t codec, size_t threshold, std::string dict );
+		void Server_InitCompress( ConnectInfo* connect_info );
+		void Server_SetSendQueue( std::string node_type_l, size_t queue_limit, int32_t queue_policy, int32_t backlog_timeout );
+		void Server_InitSendQueue( ConnectInfo* connect_info );
+		NetServerSenderStat Server_GetSenderStat();
+		void CollectMetrics( NetMetrics& net_metrics, bool with_connect );
 
 		size_t Server_GetConnectCount();
 		ConnectInfo* Server_GetConnect( int32_t identity );
+		bool Server_IsConnectValid( int32_t identity );
 
 	public: // ²Ԫرʹָ룬ʹö push_back ʱ "CObject::CObject ޷ private Ա" Ĵ
-		ServicePtr m_service;
+		std::vector<ServerShard*> m_vec_shard; // 
 		std::vector<ThreadPtr> m_vec_thread;
 		bool m_network_running;
-		int32_t m_identity_count;
+		int32_t m_shard_number; // 0 ΪƬ io_service  m_io_work_thread_number ߳
+		bool m_shard_cpu_affinity;
+		std::atomic<uint32_t> m_shard_round; // ʱ
 
 		TCPSocketOption m_tcp_socket_option;
 
 		std::thread m_sender_thread;
 		std::atomic<bool> m_sender_running;
 		std::mutex m_sender_lock;
-		std::unique_lock<std::mutex> m_unique_lock;
 		std::condition_variable m_sender_condition;
-		SenderVector* m_sender_vector_1;
-		SenderVector* m_sender_vector_2;
-		SenderVector* m_sender_vector_read;
-		SenderVector* m_sender_vector_write;
-		std::mutex m_writing_vector_lock;
-		std::mutex m_changing_vector_lock;
-
-		std::mutex m_local_info_lock;
-		std::list<ConnectInfo*> m_list_local_info;
-		std::mutex m_local_info_index_lock;
-		std::unordered_map<int32_t, ConnectInfo*> m_map_local_info_index; // 
+		std::atomic<bool> m_sender_waiting; // ߳̿еȴУ߽ʱ軽
+		SenderRing* m_sender_ring;
+		int32_t m_sender_policy;
+		std::mutex m_sender_spill_lock;
+		std::list<SendBufInfo*> m_list_sender_spill; // GROW 
+		std::atomic<size_t> m_sender_spill_count; // ʱϢҲУ֤ͬһߵϢ˳
+		std::atomic<uint64_t> m_stat_send_count;
+		std::atomic<uint64_t> m_stat_write_count;
+		std::atomic<uint64_t> m_stat_drop_count;
+		std::atomic<uint64_t> m_stat_block_count;
+		std::atomic<uint64_t> m_stat_grow_count;
+		LatencyHistogram m_stat_send_latency; // ӵд
+		ConnectStatTotal m_stat_closed;
 
 		std::mutex m_disconnect_info_lock;
 		std::list<ConnectInfo*> m_list_disconnect_info;
@@ -106,6 +152,22 @@ namespace basicx {
 		std::mutex m_listen_info_lock;
 		std::map<std::string, ListenInfo*> m_map_listen_info;
 
+		std::thread m_shm_thread; // йڴһѯ߳
+		std::atomic<bool> m_shm_running;
+		std::mutex m_shm_listen_lock;
+		std::vector<ShmListenInfo*> m_vec_shm_listen;
+		uint32_t m_shm_slot_number;
+		uint64_t m_shm_ring_size;
+
+		std::mutex m_compress_lock;
+		std::map<std::string, CompressConfig> m_map_compress_config; // ڵ
+		CompressDictTable m_compress_dict_table; // ùֵ䣬еֵǲҺѹ
+
+		std::mutex m_send_queue_lock;
+		std::map<std::string, SendQueueConfig> m_map_send_queue_config; // ڵ
+		std::mutex m_send_pool_lock;
+		std::vector<SendBufInfo*> m_vec_send_pool; // ;ϢӲλĻ棬д黹ãλȡ黹
+
 		int32_t m_log_test;
 		int32_t m_heart_check_time;
 		size_t m_max_msg_cache_number;
@@ -114,10 +176,12 @@ namespace basicx {
 		// ˲
 		size_t m_max_connect_total_s;
 		size_t m_max_data_length_s;
+		int32_t m_idle_timeout_s; // 
+		std::atomic<bool> m_binary_head_s;
+		size_t m_recv_buf_size_s;
 
 		std::thread m_thread_net_server;
-		std::thread m_thread_server_on_time;
-		size_t m_total_local_connect; // ؿͻ
+		std::atomic<size_t> m_total_local_connect; // ؿͻƬϼ
 
 	private:
 		SysLog_S* m_syslog;
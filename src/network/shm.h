@@ -0,0 +1,338 @@
+/*
+* Copyright (c) 2017-2018 the BasicX authors
+* All rights reserved.
+*
+* The project sponsor and lead author is Xu Rendong.
+* E-mail: xrd@ustc.edu, QQ: 277195007, WeChat: ustc_xrd
+* See the contributors file for names of other contributors.
+*
+* Commercial use of this code in source and binary forms is
+* governed by a LGPL v3 license. You may get a copy from the
+* root directory. Or else you should get a specific written
+* permission from the project author.
+*
+* Individual and educational use of this code in source and
+* binary forms is governed by a 3-clause BSD license. You may
+* get a copy from the root directory. Certainly welcome you
+* to contribute code of all sorts.
+*
+* Be sure to retain the above copyright notice and conditions.
+*/
+
+
+#ifndef BASICX_NETWORK_SHM_H
+#define BASICX_NETWORK_SHM_H
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <string.h>
+#include <stdint.h>
+
+#include <common/sysdef.h>
+
+#ifdef __OS_WINDOWS__
+#include <boost/interprocess/windows_shared_memory.hpp>
+#else
+#include <boost/interprocess/shared_memory_object.hpp>
+#endif
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "frame.h"
+#include "wheel.h"
+
+namespace basicx {
+
+	// ̼ͬ乲ڴ洫䣬ַ "shm://name" TCP ӹ ConnectInfo ص
+	// ÿһڴΣɲλÿλӦһͻӣշߵ߻λ
+	// м¼Ϊ 4 ֽڳ + 4 ֽڱ + ưͷݰ 8 ֽڶ룬¼ԽββʱдƱ
+
+	#define SHM_PROTOCOL "shm://"
+	#define SHM_MAGIC 0x42585348 // "BXSH"
+	#define SHM_VERSION 1
+	#define SHM_SLOT_NUMBER 8 // ÿĬϲλͬʱӵĿͻ
+	#define SHM_RING_SIZE 1048576 // ÿĻλĬϴСΪ 2 ݣݰһ
+	#define SHM_ALIVE_TIMEOUT 3000 // 룬Զ˳ʱδ´ʱΪ˳
+	#define SHM_ALIVE_INTERVAL 100 // 룬±˴ʱļ
+	#define SHM_SPIN_NUMBER 1000 // ʱæѯĴ֮óʱƬ֮
+	#define SHM_RECV_BATCH 64 // ÿÿദݰⵥռѯ߳
+	#define SHM_RECORD_HEAD 8
+	#define SHM_RECORD_WRAP 0xFFFFFFFF
+
+	#define SHM_SLOT_FREE 0
+	#define SHM_SLOT_INIT 1 // ͻռãڳʼ
+	#define SHM_SLOT_CLAIMED 2 // ͻ˳ʼɣȴ˽
+	#define SHM_SLOT_CONNECTED 3
+	#define SHM_SLOT_CLIENT_CLOSED 4 // ͻѹرգ˹رպͷŲλ
+	#define SHM_SLOT_SERVER_CLOSED 5 // ѹرգͻ˹رպͷŲλ
+
+	inline bool IsShmAddress( const std::string& address ) {
+		return 0 == address.compare( 0, strlen( SHM_PROTOCOL ), SHM_PROTOCOL );
+	}
+
+	struct ShmRing // дλ÷ִͬУα
+	{
+		std::atomic<uint64_t> m_write_pos; // ۼдֻֽ߸
+		char m_pad_1[56];
+		std::atomic<uint64_t> m_read_pos; // ۼƶȡֻֽ߸
+		char m_pad_2[56];
+	};
+
+	struct ShmSlot
+	{
+		std::atomic<uint32_t> m_state;
+		uint32_t m_reserve;
+		std::atomic<int64_t> m_client_alive_time; // 룬steady_clock ̼ͬһ
+		char m_pad[48];
+		ShmRing m_ring_c2s; // ͻ -> 
+		ShmRing m_ring_s2c; //  -> ͻ
+	};
+
+	struct ShmSegmentHead
+	{
+		uint32_t m_magic;
+		uint32_t m_version;
+		uint32_t m_slot_number;
+		uint32_t m_reserve;
+		uint64_t m_ring_size;
+		std::atomic<int64_t> m_server_alive_time; // 
+		char m_pad[32];
+	};
+
+	// ڴΣ˴ͻ˴򿪣ӳڽڱֵһͨͷ
+	class ShmSegment
+	{
+	public:
+		ShmSegment()
+			: m_owner( false )
+			, m_head( nullptr ) {
+		}
+
+		~ShmSegment() {
+#ifndef __OS_WINDOWS__
+			if( true == m_owner ) { // POSIX ڴʽɾWindows һرʱԶͷ
+				boost::interprocess::shared_memory_object::remove( m_name.c_str() );
+			}
+#endif
+		}
+
+		static size_t GetSegmentSize( uint32_t slot_number, uint64_t ring_size ) {
+			return sizeof( ShmSegmentHead ) + slot_number * ( sizeof( ShmSlot ) + 2 * ring_size );
+		}
+
+		void Create( const std::string& name, uint32_t slot_number, uint64_t ring_size ) { // ʧʱ׳쳣
+			size_t segment_size = GetSegmentSize( slot_number, ring_size );
+#ifdef __OS_WINDOWS__
+			m_shm.reset( new boost::interprocess::windows_shared_memory( boost::interprocess::create_only, name.c_str(), boost::interprocess::read_write, segment_size ) );
+#else
+			boost::interprocess::shared_memory_object::remove( name.c_str() ); // ϴ쳣˳ͬ
+			m_shm.reset( new boost::interprocess::shared_memory_object( boost::interprocess::create_only, name.c_str(), boost::interprocess::read_write ) );
+			m_shm->truncate( segment_size );
+#endif
+			m_name = name;
+			m_owner = true;
+			m_region.reset( new boost::interprocess::mapped_region( *m_shm, boost::interprocess::read_write ) );
+			memset( m_region->get_address(), 0, segment_size );
+
+			m_head = (ShmSegmentHead*)m_region->get_address();
+			m_head->m_slot_number = slot_number;
+			m_head->m_ring_size = ring_size;
+			m_head->m_server_alive_time = GetSteadyTimeMs();
+			m_head->m_version = SHM_VERSION;
+			std::atomic_thread_fence( std::memory_order_release );
+			m_head->m_magic = SHM_MAGIC; // д룬ͻ˾ݴж϶ѳʼ
+		}
+
+		bool Open( const std::string& name ) { // βʱ׳쳣ʽʱ false
+#ifdef __OS_WINDOWS__
+			m_shm.reset( new boost::interprocess::windows_shared_memory( boost::interprocess::open_only, name.c_str(), boost::interprocess::read_write ) );
+#else
+			m_shm.reset( new boost::interprocess::shared_memory_object( boost::interprocess::open_only, name.c_str(), boost::interprocess::read_write ) );
+#endif
+			m_name = name;
+			m_region.reset( new boost::interprocess::mapped_region( *m_shm, boost::interprocess::read_write ) );
+			if( m_region->get_size() < sizeof( ShmSegmentHead ) ) {
+				return false;
+			}
+			m_head = (ShmSegmentHead*)m_region->get_address();
+			std::atomic_thread_fence( std::memory_order_acquire );
+			if( m_head->m_magic != SHM_MAGIC || m_head->m_version != SHM_VERSION ) {
+				return false;
+			}
+			return m_region->get_size() >= GetSegmentSize( m_head->m_slot_number, m_head->m_ring_size );
+		}
+
+		ShmSegmentHead* GetHead() {
+			return m_head;
+		}
+
+		ShmSlot* GetSlot( uint32_t index ) {
+			return (ShmSlot*)( (char*)m_head + sizeof( ShmSegmentHead ) ) + index;
+		}
+
+		char* GetRingData( uint32_t index, bool server_to_client ) {
+			char* ring_base = (char*)GetSlot( m_head->m_slot_number );
+			return ring_base + ( index * 2 + ( true == server_to_client ? 1 : 0 ) ) * m_head->m_ring_size;
+		}
+
+		bool IsServerAlive( int64_t now_time ) {
+			return now_time - m_head->m_server_alive_time.load( std::memory_order_relaxed ) < SHM_ALIVE_TIMEOUT;
+		}
+
+	private:
+		std::string m_name;
+		bool m_owner;
+#ifdef __OS_WINDOWS__
+		std::unique_ptr<boost::interprocess::windows_shared_memory> m_shm;
+#else
+		std::unique_ptr<boost::interprocess::shared_memory_object> m_shm;
+#endif
+		std::unique_ptr<boost::interprocess::mapped_region> m_region;
+		ShmSegmentHead* m_head;
+	};
+
+	typedef std::shared_ptr<ShmSegment> ShmSegmentPtr;
+
+	// һڱ˵շͨдɱ̵߳ã m_send_lock ֤ߣȡֻڱѯ߳н
+	class ShmChannel
+	{
+	public:
+		ShmChannel( ShmSegmentPtr segment, uint32_t slot_index, bool is_server )
+			: m_segment( segment )
+			, m_slot_index( slot_index )
+			, m_close_request( false )
+			, m_closed( false ) {
+			ShmSegmentHead* head = segment->GetHead();
+			m_slot = segment->GetSlot( slot_index );
+			m_ring_size = head->m_ring_size;
+			m_send_ring = true == is_server ? &m_slot->m_ring_s2c : &m_slot->m_ring_c2s;
+			m_send_data = segment->GetRingData( slot_index, is_server );
+			m_recv_ring = true == is_server ? &m_slot->m_ring_c2s : &m_slot->m_ring_s2c;
+			m_recv_data = segment->GetRingData( slot_index, !is_server );
+			m_recv_pos = m_recv_ring->m_read_pos.load( std::memory_order_relaxed );
+		}
+
+		static uint64_t GetRecordSize( uint64_t frame_size ) {
+			return ( SHM_RECORD_HEAD + frame_size + 7 ) & ~(uint64_t)7;
+		}
+
+		uint64_t GetFrameSizeMax() {
+			return m_ring_size / 2 - SHM_RECORD_HEAD;
+		}
+
+		//  0 ɹ-1 -3 ݰ-4 ͨѹر
+		int32_t Write( int32_t type, int32_t code, const std::string& data ) {
+			uint64_t frame_size = HEAD_BYTES + data.length();
+			if( frame_size > GetFrameSizeMax() ) {
+				return -3;
+			}
+			uint64_t record_size = GetRecordSize( frame_size );
+
+			std::lock_guard<std::mutex> lock( m_send_lock );
+			if( true == m_closed ) { // رպλѱͻ˸
+				return -4;
+			}
+			uint64_t write_pos = m_send_ring->m_write_pos.load( std::memory_order_relaxed );
+			uint64_t offset = write_pos & ( m_ring_size - 1 );
+			uint64_t tail_size = m_ring_size - offset; //  8 ֽڣ㹻дƱ
+			uint64_t need_size = tail_size < record_size ? tail_size + record_size : record_size;
+			if( write_pos + need_size - m_send_ring->m_read_pos.load( std::memory_order_acquire ) > m_ring_size ) {
+				return -1;
+			}
+			if( tail_size < record_size ) {
+				*(uint32_t*)( m_send_data + offset ) = SHM_RECORD_WRAP;
+				write_pos += tail_size;
+				offset = 0;
+			}
+			char* record = m_send_data + offset;
+			*(uint32_t*)record = (uint32_t)frame_size;
+			EncodeHeadBinary( record + SHM_RECORD_HEAD, type, code, 0, (uint32_t)data.length() );
+			memcpy( record + SHM_RECORD_HEAD + HEAD_BYTES, data.c_str(), data.length() );
+			m_send_ring->m_write_pos.store( write_pos + record_size, std::memory_order_release );
+			return 0;
+		}
+
+		// һݰʼַûʱؿգ Pop()
+		// frame_size  GetFrameSizeMax() ˵Զд쳣÷Ӧر
+		const char* Peek( uint64_t& frame_size ) {
+			uint64_t write_pos = m_recv_ring->m_write_pos.load( std::memory_order_acquire );
+			while( m_recv_pos != write_pos ) {
+				uint64_t offset = m_recv_pos & ( m_ring_size - 1 );
+				uint32_t record_flag = *(const uint32_t*)( m_recv_data + offset );
+				if( SHM_RECORD_WRAP == record_flag ) {
+					m_recv_pos += m_ring_size - offset;
+					continue;
+				}
+				frame_size = record_flag;
+				return m_recv_data + offset + SHM_RECORD_HEAD;
+			}
+			return nullptr;
+		}
+
+		void Pop( uint64_t frame_size ) {
+			m_recv_pos += GetRecordSize( frame_size );
+			m_recv_ring->m_read_pos.store( m_recv_pos, std::memory_order_release );
+		}
+
+		// ˹رգ֮дֱʧܣȻ󰴶Զ״̬ͷŲλ֪ͨԶ
+		void Close( bool is_server, bool peer_dead ) {
+			std::lock_guard<std::mutex> lock( m_send_lock );
+			m_closed = true;
+			uint32_t state = SHM_SLOT_CONNECTED;
+			uint32_t close_state = true == is_server ? SHM_SLOT_SERVER_CLOSED : SHM_SLOT_CLIENT_CLOSED;
+			if( true == peer_dead || false == m_slot->m_state.compare_exchange_strong( state, close_state ) ) { // Զȹرջ˳
+				m_slot->m_state.store( SHM_SLOT_FREE, std::memory_order_release );
+			}
+		}
+
+		ShmSegmentPtr m_segment;
+		ShmSlot* m_slot;
+		uint32_t m_slot_index;
+		std::atomic<bool> m_close_request; // رգѯִ߳
+
+	private:
+		uint64_t m_ring_size;
+		ShmRing* m_send_ring;
+		char* m_send_data;
+		ShmRing* m_recv_ring;
+		const char* m_recv_data;
+		uint64_t m_recv_pos;
+		std::mutex m_send_lock;
+		bool m_closed;
+	};
+
+	typedef std::shared_ptr<ShmChannel> ShmChannelPtr;
+
+	// ѯ߳̿˱ܣʱλ
+	class ShmIdleWait
+	{
+	public:
+		ShmIdleWait()
+			: m_idle_count( 0 ) {
+		}
+
+		void Reset() {
+			m_idle_count = 0;
+		}
+
+		void Wait() {
+			m_idle_count++;
+			if( m_idle_count < SHM_SPIN_NUMBER ) {
+				return;
+			}
+			if( m_idle_count < SHM_SPIN_NUMBER * 2 ) {
+				std::this_thread::yield();
+				return;
+			}
+			std::this_thread::sleep_for( std::chrono::microseconds( 50 ) );
+		}
+
+	private:
+		int32_t m_idle_count;
+	};
+
+} // namespace basicx
+
+#endif // BASICX_NETWORK_SHM_H
@@ -24,6 +24,7 @@
 
 #include <map>
 #include <list>
+#include <deque>
 #include <mutex>
 #include <time.h>
 #include <atomic>
@@ -32,22 +33,24 @@
 #include <thread>
 #include <stdint.h>
 #include <unordered_map>
+#include <unordered_set>
 
 #include <boost/asio.hpp> //  #include <windows.h> ǰȻᱨWinSock.h has already been included
 #include <boost/bind.hpp>
 #include <boost/asio/deadline_timer.hpp>
+#include <boost/asio/steady_timer.hpp>
 
 #include <common/define.h>
 #include <common/Format/Format.hpp>
 #include <syslog/syslog.h>
 
-namespace basicx {
+#include "shm.h"
+#include "codec.h"
+#include "frame.h"
+#include "wheel.h"
+#include "metrics.h"
 
-	#define TYPE_BYTES 1 // 0~F0~15
-	#define CODE_BYTES 1 // 0~F0~15
-	#define SIZE_BYTES 6 // 000000~FFFFFF0~1677721515MB
-    #define FLAG_BYTES 2 // TYPE_BYTES + CODE_BYTES
-    #define HEAD_BYTES 8 // TYPE_BYTES + CODE_BYTES + SIZE_BYTES
+namespace basicx {
 
 	//typedef boost::shared_ptr<boost::thread> ThreadPtr;
 	typedef std::shared_ptr<std::thread> ThreadPtr;
@@ -55,6 +58,25 @@ namespace basicx {
 	typedef std::shared_ptr<boost::asio::ip::tcp::socket> SocketPtr;
 	typedef std::shared_ptr<boost::asio::ip::tcp::acceptor> AcceptorPtr;
 	typedef std::shared_ptr<boost::asio::deadline_timer> TimerPtr;
+	typedef std::shared_ptr<boost::asio::steady_timer> SteadyTimerPtr;
+	typedef std::shared_ptr<boost::asio::ip::tcp::resolver> ResolverPtr;
+	typedef std::shared_ptr<boost::asio::io_service::strand> StrandPtr;
+	typedef std::shared_ptr<const std::string> FramePtr; // ѱݰֻɱӹ
+#ifdef SO_REUSEPORT
+	typedef boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT> ReusePortOption; // Ƭͬһ˿ڣں˷
+#endif
+
+	// ڵפͬ͹һַַڽڲ
+	inline const std::string* InternNodeType( const std::string& node_type ) {
+		static std::mutex intern_lock;
+		static std::unordered_set<std::string> intern_pool;
+		std::lock_guard<std::mutex> lock( intern_lock );
+		return &( *intern_pool.insert( node_type ).first );
+	}
+
+	inline std::shared_ptr<char> MakeRecvBuf( size_t size ) {
+		return std::shared_ptr<char>( new char[size], std::default_delete<char[]>() );
+	}
 
 	#pragma pack( push )
 	#pragma pack( 1 )
@@ -66,6 +88,8 @@ namespace basicx {
 		int32_t m_port;
 		std::string m_node_type;
 		int32_t m_reconnect_count;
+		int64_t m_disconnect_time; // 룬Ͽʱ䣬ͳʱ
+		SteadyTimerPtr m_reconnect_timer; // ߳е´
 	};
 
 	struct ListenInfo
@@ -75,6 +99,29 @@ namespace basicx {
 		std::string m_node_type;
 		int32_t m_connect_number;
 		AcceptorPtr m_acceptor;
+		std::vector<AcceptorPtr> m_vec_acceptor; // Ƭģʽ¸Ƭļm_acceptor Ϊеһ
+	};
+
+	struct ConnectInfo;
+
+	struct ShmListenInfo
+	{
+		std::string m_address; // "shm://name"
+		std::string m_node_type;
+		ShmSegmentPtr m_segment;
+		std::vector<ConnectInfo*> m_vec_connect_info; // λֻڹڴѯ߳з
+	};
+
+	struct ShmClaimInfo // ʱ߳Զʱȴ˽Ĺڴλ
+	{
+		ShmSegmentPtr m_segment;
+		int32_t m_slot_index;
+		int64_t m_timeout_time; // 룬򳷻زλ
+		std::string m_address;
+		int32_t m_port;
+		std::string m_node_type;
+		int32_t m_reconnect_identity;
+		SteadyTimerPtr m_claim_timer;
 	};
 
 	struct ServerInfo
@@ -85,14 +132,42 @@ namespace basicx {
 		int32_t m_connect_number;
 	};
 
+	struct SendBufInfo;
+	struct ServerShard;
+
+	struct SendQueueConfig // ڵãӽʱƵ ConnectInfo
+	{
+		size_t m_queue_limit; // Ϣޣ0 Ϊ
+		int32_t m_queue_policy; // NW_QUEUE_*
+		int32_t m_backlog_timeout; // 룬ĴϢʱδдϿ0 Ϊ
+	};
+
+	#pragma pack( pop )
+
+	// ӡλ뷢Ͷнṹԭӱ pack( 1 ) ԱȻ룬绺еԭӲд˺
+	struct ConnectRace // ַʱͬʱӣȳɹ߱ȫʧܲŰ´
+	{
+		std::atomic<int32_t> m_pending; // δĳʤ߲Ƽ
+		std::atomic<bool> m_finish; // гӳɹ
+	};
+
+	typedef std::shared_ptr<ConnectRace> ConnectRacePtr;
+
 	struct ConnectInfo
 	{
 		SocketPtr m_socket;
+		ShmChannelPtr m_shm_channel; // ڴʱЧʱ m_socket Ϊ
 		TimerPtr m_connect_timer;
+		StrandPtr m_strand; // ͬһӵĻصִУ IO ߳ʱԱ֤˳
+		ServerShard* m_shard; // Ƭʹ
+		int32_t m_reconnect_identity; // Ӧԭӱǣ0 Ϊͻʹ
+		ConnectRacePtr m_connect_race; // ʱľһַʱΪգͻʹ
 		int32_t m_identity; // Ψһ
 		std::atomic<bool> m_available; // Ƿɹ
 		time_t m_heart_check_time; // з()ʱŸ£ΪӲҿʱ
 		std::atomic<bool> m_active_close; // 򱻶ر
+		std::atomic<int64_t> m_send_time; // 룬һηʱ䣬ڼݷ
+		std::atomic<int64_t> m_recv_time; // 룬һյʱ䣬ڿм
 
 		std::string m_endpoint_r; // ӱ"tcp://192.16.1.23:333"
 		std::string m_protocol_r;
@@ -107,56 +182,313 @@ namespace basicx {
 		std::string m_str_port_l;
 
 		std::string m_node_type; // ؼԶӽڵ
+		const std::string* m_node_type_intern; // פĽڵͣ
+
+		std::atomic<int32_t> m_head_mode; // ͰͷʽЭ̳ɹΪ HEAD_MODE_BINARYʱÿͷԶʶ
 
 		char* m_recv_buf_head;
 		char* m_recv_buf_data;
+		std::shared_ptr<char> m_recv_buf_share; //  m_recv_buf_dataʱɱȡȨʱ軻»
 		size_t m_recv_buf_data_size;
+		size_t m_recv_buf_begin; // ʽʱδ
+		size_t m_recv_buf_end; // ʽʱѽյ
+
+		int32_t m_compress_codec; // NW_COMPRESS_*ӽʱڵ
+		size_t m_compress_threshold;
+		CompressDictPtr m_compress_dict;
+		std::shared_ptr<char> m_unpack_buf_share; // ѹ棬 m_recv_buf_share ͬʱɱȡȨ
+		size_t m_unpack_buf_size;
+
+		int32_t m_stat_lost_msg; // ʱӡ
+		std::atomic<uint64_t> m_stat_recv_bytes; // Ϊۼֵշ·ֻ relaxed ۼӣͳƿնȡ
+		std::atomic<uint64_t> m_stat_recv_msgs;
+		std::atomic<uint64_t> m_stat_send_bytes;
+		std::atomic<uint64_t> m_stat_send_msgs;
+		std::atomic<int64_t> m_stat_send_queue; // ʱһдһڲ̣ͬ߳ܶΪ
+		std::atomic<uint64_t> m_stat_drop_msgs;
+		std::atomic<uint64_t> m_stat_conflate_msgs;
 
-		int32_t m_stat_lost_msg;
+		std::mutex m_send_buf_lock;
+		bool m_send_writing; // Ƿз;ÿͬһʱֻһ async_write
+		std::deque<SendBufInfo*> m_vec_send_pending; // ȴϲͣϢʱͷƳ
+		std::deque<SendBufInfo*> m_vec_send_writing; // ڷͣɺͳһ黹 m_vec_send_pending 
+		std::unordered_map<std::string, size_t> m_map_send_conflate; // ϲţȥ m_send_pending_base  m_vec_send_pending еλãͬʱ
+		size_t m_send_pending_base; // m_vec_send_pending ͷϢţͷƳʱһ
+		std::vector<boost::asio::const_buffer> m_vec_send_buffers;
+		size_t m_send_queue_limit; // ӽʱڵã SendQueueConfig
+		int32_t m_send_queue_policy;
+		int32_t m_send_backlog_timeout;
+		std::atomic<int64_t> m_send_backlog_time; // ΢룬;Ϣʱ䣬;ʱΪ 0
+
+		void ResetStat() {
+			m_stat_lost_msg = 0;
+			m_stat_recv_bytes = 0;
+			m_stat_recv_msgs = 0;
+			m_stat_send_bytes = 0;
+			m_stat_send_msgs = 0;
+			m_stat_send_queue = 0;
+			m_stat_drop_msgs = 0;
+			m_stat_conflate_msgs = 0;
+		}
 
 		void clear() {
 			if( m_recv_buf_head != nullptr ) {
 				delete[] m_recv_buf_head;
 				m_recv_buf_head = nullptr;
 			}
-			if( m_recv_buf_data != nullptr ) {
+			if( m_recv_buf_share != nullptr ) {
+				m_recv_buf_share.reset(); // Աⲿ
+				m_recv_buf_data = nullptr;
+			}
+			else if( m_recv_buf_data != nullptr ) {
 				delete[] m_recv_buf_data;
 				m_recv_buf_data = nullptr;
 			}
+			m_unpack_buf_share.reset();
+		}
+	};
+
+	struct ConnectSlot
+	{
+		std::atomic<uint32_t> m_generation; // ÿͷźһɾ漴ʧЧ
+		std::atomic<ConnectInfo*> m_connect_info;
+	};
+
+	// λӱΪ  *  + λɾʱ
+	// ͷŵĲλŵжĩβٸãͬһλĴҪƻһȦɾſЧ
+	class ConnectTable
+	{
+	public:
+		ConnectTable( size_t capacity, uint32_t handle_max ) // ȡСֵָ 2 ݣȡֵ [0, handle_max)
+			: m_capacity( 1 )
+			, m_count( 0 ) {
+			while( m_capacity < capacity ) {
+				m_capacity <<= 1;
+			}
+			m_generation_max = (uint32_t)( handle_max / m_capacity );
+			if( 0 == m_generation_max ) {
+				m_generation_max = 1;
+			}
+			m_slots = new ConnectSlot[m_capacity];
+			for( size_t i = 0; i < m_capacity; i++ ) {
+				m_slots[i].m_generation = 0;
+				m_slots[i].m_connect_info = nullptr;
+				m_deque_free.push_back( i );
+			}
+		}
+
+		~ConnectTable() {
+			delete[] m_slots;
+		}
+
+		int32_t Insert( ConnectInfo* connect_info ) { // ؾʱ -1
+			std::lock_guard<std::mutex> lock( m_free_lock );
+			if( m_deque_free.empty() ) {
+				return -1;
+			}
+			size_t index = m_deque_free.front();
+			m_deque_free.pop_front();
+			ConnectSlot& slot = m_slots[index];
+			slot.m_connect_info.store( connect_info, std::memory_order_release );
+			m_count++;
+			return (int32_t)( slot.m_generation.load( std::memory_order_relaxed ) * m_capacity + index );
 		}
+
+		bool Erase( int32_t handle ) { // ѹʱ false
+			if( handle < 0 ) {
+				return false;
+			}
+			size_t index = handle & ( m_capacity - 1 );
+			uint32_t generation = (uint32_t)( handle / m_capacity );
+			std::lock_guard<std::mutex> lock( m_free_lock );
+			ConnectSlot& slot = m_slots[index];
+			if( slot.m_generation.load( std::memory_order_relaxed ) != generation ) {
+				return false;
+			}
+			slot.m_generation.store( ( generation + 1 ) % m_generation_max, std::memory_order_release ); // ʹʧЧ
+			slot.m_connect_info.store( nullptr, std::memory_order_release );
+			m_deque_free.push_back( index );
+			m_count--;
+			return true;
+		}
+
+		ConnectInfo* Find( int32_t handle ) { // ѹʱؿ
+			if( handle < 0 ) {
+				return nullptr;
+			}
+			size_t index = handle & ( m_capacity - 1 );
+			uint32_t generation = (uint32_t)( handle / m_capacity );
+			ConnectSlot& slot = m_slots[index];
+			if( slot.m_generation.load( std::memory_order_acquire ) != generation ) {
+				return nullptr;
+			}
+			ConnectInfo* connect_info = slot.m_connect_info.load( std::memory_order_acquire );
+			if( slot.m_generation.load( std::memory_order_acquire ) != generation ) { // ȡڼ䱻ͷţλѻ
+				return nullptr;
+			}
+			return connect_info;
+		}
+
+		void Collect( std::vector<ConnectInfo*>& vec_connect_info ) { // ʱɾӰ죬Ϊƿ
+			for( size_t i = 0; i < m_capacity; i++ ) {
+				ConnectInfo* connect_info = m_slots[i].m_connect_info.load( std::memory_order_acquire );
+				if( connect_info != nullptr ) {
+					vec_connect_info.push_back( connect_info );
+				}
+			}
+		}
+
+		size_t GetCount() {
+			return m_count;
+		}
+
+		size_t GetCapacity() {
+			return m_capacity;
+		}
+
+	private:
+		ConnectSlot* m_slots;
+		size_t m_capacity;
+		uint32_t m_generation_max;
+		std::mutex m_free_lock;
+		std::deque<size_t> m_deque_free;
+		std::atomic<size_t> m_count;
 	};
 
+	struct ServerShard // ˷Ƭռ io_service߳ӱƬ֮以
+	{
+		int32_t m_shard_index;
+		int32_t m_cpu_core; // ̰߳󶨵 CPU ģ-1 Ϊ
+		ServicePtr m_service;
+		ConnectTable* m_connect_table;
+		TimerWheel<int32_t>* m_heart_wheel; // ӱǵм
+		SteadyTimerPtr m_wheel_timer;
+	};
+
+	struct SenderSlot;
+
+	inline FramePtr MakeSendFrame( int32_t head_mode, int32_t type, int32_t code, std::string& data ) {
+		std::shared_ptr<std::string> send_frame = std::make_shared<std::string>();
+		send_frame->reserve( HEAD_BYTES + data.length() );
+		send_frame->resize( HEAD_BYTES );
+		EncodeHead( &(*send_frame)[0], head_mode, type, code, 0, (uint32_t)data.length() );
+		send_frame->append( data );
+		return send_frame;
+	}
+
 	struct SendBufInfo
 	{
 		size_t m_send_size;
+		int64_t m_enqueue_time; // ΢룬ͳӵдʱ
 		std::string m_send_buf;
+		FramePtr m_send_frame; // 㲥ʱݰΪʱ m_send_buf 
+		std::string m_conflate_key; // ΪʱͬһӴͬϢֻһ
 		ConnectInfo* m_connect_info;
+		SenderSlot* m_sender_slot; //  SenderRing λΪ nullptr ʱΪɺɾ
+		size_t m_slot_position;
 
 		SendBufInfo()
 			: m_connect_info( nullptr )
-			, m_send_size( 0 ) {
+			, m_send_size( 0 )
+			, m_enqueue_time( 0 )
+			, m_sender_slot( nullptr )
+			, m_slot_position( 0 ) {
 		}
 
-		SendBufInfo( ConnectInfo* connect_info, size_t send_size, std::ostringstream& type, std::ostringstream& code, std::ostringstream& size, std::string& data )
+		SendBufInfo( ConnectInfo* connect_info, int32_t head_mode, int32_t type, int32_t code, std::string& data, int32_t flag = 0 )
 			: m_connect_info( connect_info )
-			, m_send_size( send_size ) {
-			m_send_buf.append( type.str() );
-			m_send_buf.append( code.str() );
-			m_send_buf.append( size.str() );
+			, m_send_size( data.length() )
+			, m_enqueue_time( GetSteadyTimeUs() )
+			, m_sender_slot( nullptr )
+			, m_slot_position( 0 ) {
+			m_send_buf.resize( HEAD_BYTES );
+			EncodeHead( &m_send_buf[0], head_mode, type, code, flag, (uint32_t)m_send_size );
 			m_send_buf.append( data );
 		}
 
-		void Update( ConnectInfo* connect_info, size_t send_size, std::ostringstream& type, std::ostringstream& code, std::ostringstream& size, std::string& data ) {
+		void Update( ConnectInfo* connect_info, int32_t head_mode, int32_t type, int32_t code, std::string& data, int32_t flag = 0 ) {
 			m_connect_info = connect_info;
-			m_send_size = send_size;
-			m_send_buf.clear(); //
-			m_send_buf.append( type.str() );
-			m_send_buf.append( code.str() );
-			m_send_buf.append( size.str() );
+			m_send_frame.reset();
+			m_send_size = data.length();
+			m_enqueue_time = GetSteadyTimeUs();
+			m_conflate_key.clear();
+			m_send_buf.resize( HEAD_BYTES ); // 
+			EncodeHead( &m_send_buf[0], head_mode, type, code, flag, (uint32_t)m_send_size );
 			m_send_buf.append( data );
 		}
+
+		void Update( ConnectInfo* connect_info, const FramePtr& send_frame ) { // ֻü
+			m_connect_info = connect_info;
+			m_send_size = send_frame->length() - HEAD_BYTES;
+			m_enqueue_time = GetSteadyTimeUs();
+			m_conflate_key.clear();
+			m_send_frame = send_frame;
+		}
+
+		const std::string& GetSendBuf() const {
+			return m_send_frame != nullptr ? *m_send_frame : m_send_buf;
+		}
+
+		void SwapData( SendBufInfo& other ) { // ֻݣλϢ
+			std::swap( m_connect_info, other.m_connect_info );
+			std::swap( m_send_size, other.m_send_size );
+			std::swap( m_enqueue_time, other.m_enqueue_time );
+			m_send_buf.swap( other.m_send_buf );
+			m_send_frame.swap( other.m_send_frame );
+			m_conflate_key.swap( other.m_conflate_key );
+		}
 	};
 
+	//  m_send_buf_lock ڵãӵĶ޺ͲԷУ黹Ļ drop_buf_info 
+	//  0 ѷ룬1 ѷ벢Ϣ2 滻ͬĴϢ-1 Ϣ-2 ѹʱϿ(Ϣͬ)
+	inline int32_t PushSendPending( ConnectInfo* connect_info, SendBufInfo* send_buf_info, SendBufInfo*& drop_buf_info ) {
+		std::deque<SendBufInfo*>& vec_send_pending = connect_info->m_vec_send_pending;
+		drop_buf_info = nullptr;
+		if( connect_info->m_send_backlog_timeout > 0 ) { // ϢʱΪǰʱ
+			int64_t backlog_time = connect_info->m_send_backlog_time.load( std::memory_order_relaxed );
+			if( backlog_time > 0 && send_buf_info->m_enqueue_time - backlog_time >= (int64_t)connect_info->m_send_backlog_timeout * 1000 ) {
+				drop_buf_info = send_buf_info;
+				return -2;
+			}
+		}
+		if( !send_buf_info->m_conflate_key.empty() ) { // ͬĴϢֻһþϢλã;ĲӰ
+			auto it_sc = connect_info->m_map_send_conflate.find( send_buf_info->m_conflate_key );
+			if( it_sc != connect_info->m_map_send_conflate.end() ) {
+				size_t position = it_sc->second - connect_info->m_send_pending_base;
+				drop_buf_info = vec_send_pending[position];
+				vec_send_pending[position] = send_buf_info;
+				return 2;
+			}
+		}
+		if( connect_info->m_send_queue_limit > 0 && vec_send_pending.size() >= connect_info->m_send_queue_limit ) {
+			switch( connect_info->m_send_queue_policy ) {
+			case NW_QUEUE_DROP_OLDEST:
+				drop_buf_info = vec_send_pending.front();
+				if( !drop_buf_info->m_conflate_key.empty() ) { // ֻͬһָͷŲ
+					connect_info->m_map_send_conflate.erase( drop_buf_info->m_conflate_key );
+				}
+				vec_send_pending.pop_front();
+				connect_info->m_send_pending_base++;
+				if( !send_buf_info->m_conflate_key.empty() ) {
+					connect_info->m_map_send_conflate[send_buf_info->m_conflate_key] = connect_info->m_send_pending_base + vec_send_pending.size();
+				}
+				vec_send_pending.push_back( send_buf_info );
+				return 1;
+			case NW_QUEUE_DISCONNECT:
+				drop_buf_info = send_buf_info;
+				return -2;
+			default:
+				drop_buf_info = send_buf_info;
+				return -1;
+			}
+		}
+		if( !send_buf_info->m_conflate_key.empty() ) {
+			connect_info->m_map_send_conflate[send_buf_info->m_conflate_key] = connect_info->m_send_pending_base + vec_send_pending.size();
+		}
+		vec_send_pending.push_back( send_buf_info );
+		return 0;
+	}
+
 	class SenderVector
 	{
 	private:
@@ -193,6 +525,105 @@ namespace basicx {
 		std::vector<SendBufInfo*> m_vec_send_buf_info;
 	};
 
+	struct SenderSlot
+	{
+		std::atomic<size_t> m_sequence;
+		SendBufInfo m_send_buf_info;
+	};
+
+	// ߵнУλ䷢ͻԤȷ䲢ѭʹ
+	// ߳ȡݻӵĴ漴 Release() 黹λ
+	class SenderRing
+	{
+	private:
+		SenderRing() {};
+
+	public:
+		SenderRing( size_t capacity )
+			: m_enqueue_position( 0 )
+			, m_dequeue_position( 0 ) {
+			if( 0 == capacity ) { // ޻Ĭϳʼ 8192 
+				capacity = 8192;
+			}
+			m_capacity = 2;
+			while( m_capacity < capacity ) { // ȡ 2 ݣλȡģ
+				m_capacity <<= 1;
+			}
+			m_mask = m_capacity - 1;
+			m_slots = new SenderSlot[m_capacity];
+			for( size_t i = 0; i < m_capacity; i++ ) {
+				m_slots[i].m_sequence.store( i, std::memory_order_relaxed );
+				m_slots[i].m_send_buf_info.m_sender_slot = &m_slots[i];
+			}
+		}
+
+		~SenderRing() {
+			delete[] m_slots;
+		}
+
+	public:
+		SendBufInfo* Claim() { // ռòλʱ nullptr
+			size_t position = m_enqueue_position.load( std::memory_order_relaxed );
+			while( true ) {
+				SenderSlot* slot = &m_slots[position & m_mask];
+				size_t sequence = slot->m_sequence.load( std::memory_order_acquire );
+				intptr_t diff = (intptr_t)sequence - (intptr_t)position;
+				if( 0 == diff ) {
+					if( m_enqueue_position.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) ) {
+						slot->m_send_buf_info.m_slot_position = position;
+						return &slot->m_send_buf_info;
+					}
+				}
+				else if( diff < 0 ) {
+					return nullptr;
+				}
+				else {
+					position = m_enqueue_position.load( std::memory_order_relaxed );
+				}
+			}
+		}
+
+		void Publish( SendBufInfo* send_buf_info ) { // Ϻ󷢲
+			send_buf_info->m_sender_slot->m_sequence.store( send_buf_info->m_slot_position + 1, std::memory_order_release );
+		}
+
+		SendBufInfo* Consume() { // ̵߳ãռ˳ȡδĲλ nullptr
+			SenderSlot* slot = &m_slots[m_dequeue_position & m_mask];
+			if( slot->m_sequence.load( std::memory_order_acquire ) != m_dequeue_position + 1 ) {
+				return nullptr;
+			}
+			m_dequeue_position++;
+			return &slot->m_send_buf_info;
+		}
+
+		void Release( SendBufInfo* send_buf_info ) { // ݻ黹λ̵߳
+			send_buf_info->m_connect_info = nullptr;
+			send_buf_info->m_send_frame.reset(); // ͷŹݰ
+			send_buf_info->m_sender_slot->m_sequence.store( send_buf_info->m_slot_position + m_capacity, std::memory_order_release );
+		}
+
+		bool IsEmpty() { // ̵߳ãռõδĲλҲΪǿ
+			return m_enqueue_position.load( std::memory_order_acquire ) == m_dequeue_position;
+		}
+
+		size_t GetCapacity() {
+			return m_capacity;
+		}
+
+	private:
+		size_t m_capacity;
+		size_t m_mask;
+		SenderSlot* m_slots;
+		char m_pad_1[64]; // ߵλüα
+		std::atomic<size_t> m_enqueue_position;
+		char m_pad_2[64];
+		size_t m_dequeue_position;
+		char m_pad_3[64];
+	};
+
+	#pragma pack( push )
+	#pragma pack( 1 )
+
 	struct TCPSocketOption
 	{
 		bool m_debug;
@@ -216,6 +647,99 @@ namespace basicx {
 
 	#pragma pack( pop )
 
+	// ͳƽṹԭӼ pack( 1 ) ԱȻ
+	struct LatencyHistogram //  2 ΢ֵ
+	{
+		std::atomic<uint64_t> m_bucket[METRICS_LATENCY_BUCKET];
+
+		LatencyHistogram() {
+			for( int32_t i = 0; i < METRICS_LATENCY_BUCKET; i++ ) {
+				m_bucket[i] = 0;
+			}
+		}
+
+		void Record( int64_t latency_us ) {
+			int32_t index = 0;
+			while( latency_us > 0 && index < METRICS_LATENCY_BUCKET - 1 ) {
+				latency_us >>= 1;
+				index++;
+			}
+			m_bucket[index].fetch_add( 1, std::memory_order_relaxed );
+		}
+
+		void CopyTo( uint64_t* bucket ) const {
+			for( int32_t i = 0; i < METRICS_LATENCY_BUCKET; i++ ) {
+				bucket[i] = m_bucket[i].load( std::memory_order_relaxed );
+			}
+		}
+	};
+
+	struct ConnectStatTotal // ѹرӵۼƣӹرʱ룬ʱ
+	{
+		std::atomic<uint64_t> m_recv_bytes;
+		std::atomic<uint64_t> m_recv_msgs;
+		std::atomic<uint64_t> m_send_bytes;
+		std::atomic<uint64_t> m_send_msgs;
+		std::atomic<uint64_t> m_drop_msgs;
+		std::atomic<uint64_t> m_conflate_msgs;
+
+		ConnectStatTotal()
+			: m_recv_bytes( 0 )
+			, m_recv_msgs( 0 )
+			, m_send_bytes( 0 )
+			, m_send_msgs( 0 )
+			, m_drop_msgs( 0 )
+			, m_conflate_msgs( 0 ) {
+		}
+
+		void Merge( const ConnectInfo* connect_info ) {
+			m_recv_bytes += connect_info->m_stat_recv_bytes.load( std::memory_order_relaxed );
+			m_recv_msgs += connect_info->m_stat_recv_msgs.load( std::memory_order_relaxed );
+			m_send_bytes += connect_info->m_stat_send_bytes.load( std::memory_order_relaxed );
+			m_send_msgs += connect_info->m_stat_send_msgs.load( std::memory_order_relaxed );
+			m_drop_msgs += connect_info->m_stat_drop_msgs.load( std::memory_order_relaxed );
+			m_conflate_msgs += connect_info->m_stat_conflate_msgs.load( std::memory_order_relaxed );
+		}
+
+		void CopyTo( NetMetrics& net_metrics ) const {
+			net_metrics.m_recv_bytes = m_recv_bytes;
+			net_metrics.m_recv_msgs = m_recv_msgs;
+			net_metrics.m_send_bytes = m_send_bytes;
+			net_metrics.m_send_msgs = m_send_msgs;
+			net_metrics.m_send_queue = 0;
+			net_metrics.m_drop_msgs = m_drop_msgs;
+			net_metrics.m_conflate_msgs = m_conflate_msgs;
+		}
+	};
+
+	// ȡӵļۼӵϼ
+	inline void CollectConnectMetrics( const ConnectInfo* connect_info, NetMetrics& net_metrics, bool with_connect ) {
+		NetConnectMetrics connect_metrics;
+		connect_metrics.m_recv_bytes = connect_info->m_stat_recv_bytes.load( std::memory_order_relaxed );
+		connect_metrics.m_recv_msgs = connect_info->m_stat_recv_msgs.load( std::memory_order_relaxed );
+		connect_metrics.m_send_bytes = connect_info->m_stat_send_bytes.load( std::memory_order_relaxed );
+		connect_metrics.m_send_msgs = connect_info->m_stat_send_msgs.load( std::memory_order_relaxed );
+		int64_t send_queue = connect_info->m_stat_send_queue.load( std::memory_order_relaxed );
+		connect_metrics.m_send_queue = send_queue > 0 ? (uint64_t)send_queue : 0;
+		connect_metrics.m_drop_msgs = connect_info->m_stat_drop_msgs.load( std::memory_order_relaxed );
+		connect_metrics.m_conflate_msgs = connect_info->m_stat_conflate_msgs.load( std::memory_order_relaxed );
+		net_metrics.m_recv_bytes += connect_metrics.m_recv_bytes;
+		net_metrics.m_recv_msgs += connect_metrics.m_recv_msgs;
+		net_metrics.m_send_bytes += connect_metrics.m_send_bytes;
+		net_metrics.m_send_msgs += connect_metrics.m_send_msgs;
+		net_metrics.m_send_queue += connect_metrics.m_send_queue;
+		net_metrics.m_drop_msgs += connect_metrics.m_drop_msgs;
+		net_metrics.m_conflate_msgs += connect_metrics.m_conflate_msgs;
+		net_metrics.m_connect_count++;
+		if( true == with_connect ) {
+			connect_metrics.m_identity = connect_info->m_identity;
+			connect_metrics.m_node_type = connect_info->m_node_type;
+			connect_metrics.m_endpoint_l = connect_info->m_endpoint_l;
+			connect_metrics.m_endpoint_r = connect_info->m_endpoint_r;
+			net_metrics.m_vec_connect.push_back( connect_metrics );
+		}
+	}
+
 } // namespace basicx
 
 #endif // BASICX_NETWORK_STRUCT_H
@@ -32,6 +32,7 @@
 
 #include "client.h"
 #include "server.h"
+#include "multicast.h"
 
 namespace basicx {
 
@@ -263,6 +264,92 @@ namespace basicx {
 		}
 	}
 
+	// 同一进程内组播环回测试，发送端需打开 m_loopback，按序号统计丢失
+	class MulticastTester : public NetClient_X
+	{
+	public:
+		MulticastTester()
+			: m_log_cate( "<MULTICAST_TEST>" )
+			, m_test_text( "我爱我家，啦啦啦！ABCDEFGabcdefg1234567890!@#$%^&*()" )
+			, m_recv_count( 0 ) {
+			m_syslog = SysLog_S::GetInstance();
+
+			m_net_multicast_cfg.m_log_test = 0;
+			m_net_multicast_cfg.m_group_address = "239.255.0.1";
+			m_net_multicast_cfg.m_group_port = 2019;
+			m_net_multicast_cfg.m_interface_address = "0.0.0.0";
+			m_net_multicast_cfg.m_ttl = 1;
+			m_net_multicast_cfg.m_loopback = true;
+			m_net_multicast_cfg.m_max_datagram_size = MULTICAST_DATAGRAM_MAX;
+			m_net_multicast_cfg.m_recv_batch_number = MULTICAST_RECV_BATCH;
+			m_net_multicast_cfg.m_recv_buffer_size = 8 * 1024 * 1024;
+			m_net_multicast_cfg.m_sender_expire = MULTICAST_SENDER_EXPIRE;
+
+			m_receiver.ComponentInstance( this );
+		};
+
+		~MulticastTester() {};
+
+	public:
+		void OnNetClientInfo( NetClientInfo& net_client_info ) {
+			if( WM_MY_MULTICAST_GAP == net_client_info.m_info_type ) {
+				std::string log_info = "组播 接收 序号跳跃！" + net_client_info.m_endpoint_r;
+				m_syslog->LogPrint( syslog_level::c_warn, m_log_cate, log_info );
+			}
+		};
+
+		void OnNetClientData( NetClientData& net_client_data ) {
+		};
+
+		void OnNetClientView( NetClientView& net_client_view ) {
+			if( NW_MSG_CODE_STRING == net_client_view.m_code ) {
+				m_recv_count++;
+			}
+		};
+
+	public:
+		bool StartNetwork() {
+			return m_receiver.StartNetwork( m_net_multicast_cfg, "test" ) && m_sender.StartNetwork( m_net_multicast_cfg );
+		}
+
+		void SendData() {
+			std::vector<std::string> vec_data( 100, m_test_text );
+			m_sender.Sender_SendDataBatch( NW_MSG_TYPE_USER_DATA, NW_MSG_CODE_STRING, vec_data );
+		}
+
+		void PrintCount() {
+			NetMulticastStat sender_stat = m_sender.Sender_GetStat();
+			NetMulticastStat receiver_stat = m_receiver.Receiver_GetStat();
+			std::cout << "发送：" << sender_stat.m_message_count << "/" << sender_stat.m_datagram_count;
+			std::cout << " 接收：" << receiver_stat.m_message_count << "/" << receiver_stat.m_datagram_count;
+			std::cout << " 丢失：" << receiver_stat.m_lost_count << " 跳跃：" << receiver_stat.m_gap_count << " 计数：" << m_recv_count << "\n";
+			m_recv_count = 0;
+		}
+
+	public:
+		SysLog_S* m_syslog;
+		MulticastSender m_sender;
+		MulticastReceiver m_receiver;
+		std::string m_log_cate;
+		std::string m_test_text;
+		NetMulticastCfg m_net_multicast_cfg;
+		std::atomic<int64_t> m_recv_count;
+	};
+
+	void Test_Multicast() {
+		MulticastTester multicast_tester;
+		if( false == multicast_tester.StartNetwork() ) {
+			return;
+		}
+		while( true ) {
+			for( int32_t i = 0; i < 1000; i++ ) {
+				multicast_tester.SendData();
+				std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+			}
+			multicast_tester.PrintCount();
+		}
+	}
+
 } // namespace basicx
 
 #endif // NETWORK_TESTER_H
@@ -0,0 +1,119 @@
+/*
+* Copyright (c) 2017-2018 the BasicX authors
+* All rights reserved.
+*
+* The project sponsor and lead author is Xu Rendong.
+* E-mail: xrd@ustc.edu, QQ: 277195007, WeChat: ustc_xrd
+* See the contributors file for names of other contributors.
+*
+* Commercial use of this code in source and binary forms is
+* governed by a LGPL v3 license. You may get a copy from the
+* root directory. Or else you should get a specific written
+* permission from the project author.
+*
+* Individual and educational use of this code in source and
+* binary forms is governed by a 3-clause BSD license. You may
+* get a copy from the root directory. Certainly welcome you
+* to contribute code of all sorts.
+*
+* Be sure to retain the above copyright notice and conditions.
+*/
+
+#ifndef BASICX_NETWORK_WHEEL_H
+#define BASICX_NETWORK_WHEEL_H
+
+#include <mutex>
+#include <chrono>
+#include <vector>
+#include <stdint.h>
+
+namespace basicx {
+
+	#define WHEEL_TICK_MS 100 // ʱÿмľ
+	#define WHEEL_SLOT_NUMBER 512 // ʱָΪ 2 ݣһȦԼ 51 룬ԶĵڸеȴһȦ
+
+	inline int64_t GetSteadyTimeMs() {
+		return std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+	}
+
+	inline int64_t GetSteadyTimeUs() {
+		return std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+	}
+
+	// ϣʱ֣ ڿ̶ %  ӣƽֻڵĸӣ
+	// ֧ȡʱɵ÷УǷȻЧôӱ²
+	template<typename T>
+	class TimerWheel
+	{
+	public:
+		TimerWheel( size_t slot_number, int64_t tick_ms, int64_t now_ms )
+			: m_vec_slot( slot_number )
+			, m_slot_mask( slot_number - 1 )
+			, m_tick_ms( tick_ms )
+			, m_current_tick( now_ms / tick_ms )
+			, m_count( 0 ) {
+		}
+
+		void Schedule( const T& item, int64_t deadline_ms ) {
+			int64_t deadline_tick = ( deadline_ms + m_tick_ms - 1 ) / m_tick_ms; // ȡǰ
+			std::lock_guard<std::mutex> lock( m_wheel_lock );
+			if( deadline_tick < m_current_tick ) {
+				deadline_tick = m_current_tick; // ѹڵ´ƽʱ
+			}
+			WheelItem wheel_item = { item, deadline_tick };
+			m_vec_slot[deadline_tick & m_slot_mask].push_back( wheel_item );
+			m_count++;
+		}
+
+		void Advance( int64_t now_ms, std::vector<T>& vec_expired ) { // ƽǰʱ䣬ռе
+			int64_t now_tick = now_ms / m_tick_ms;
+			std::lock_guard<std::mutex> lock( m_wheel_lock );
+			int64_t last_tick = now_tick;
+			if( last_tick - m_current_tick >= (int64_t)m_vec_slot.size() ) { // ͣٳһȦÿֻһ
+				last_tick = m_current_tick + m_vec_slot.size() - 1;
+			}
+			for( int64_t tick = m_current_tick; tick <= last_tick; tick++ ) {
+				std::vector<WheelItem>& vec_item = m_vec_slot[tick & m_slot_mask];
+				for( size_t i = 0; i < vec_item.size(); ) {
+					if( vec_item[i].m_deadline_tick <= now_tick ) {
+						vec_expired.push_back( vec_item[i].m_item );
+						vec_item[i] = vec_item.back();
+						vec_item.pop_back();
+						m_count--;
+					}
+					else { // ҪȦ
+						i++;
+					}
+				}
+			}
+			if( now_tick >= m_current_tick ) {
+				m_current_tick = now_tick + 1;
+			}
+		}
+
+		int64_t GetTickMs() {
+			return m_tick_ms;
+		}
+
+		size_t GetCount() {
+			return m_count;
+		}
+
+	private:
+		struct WheelItem
+		{
+			T m_item;
+			int64_t m_deadline_tick;
+		};
+
+		std::mutex m_wheel_lock; // ȿ̣߳ƽֻ io_service н
+		std::vector<std::vector<WheelItem>> m_vec_slot;
+		size_t m_slot_mask;
+		int64_t m_tick_ms;
+		int64_t m_current_tick; // һƽĿ̶
+		size_t m_count;
+	};
+
+} // namespace basicx
+
+#endif // BASICX_NETWORK_WHEEL_H
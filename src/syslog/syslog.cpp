@@ -30,22 +30,59 @@
 #include <common/Format/Format.hpp>
 
 #ifdef __OS_WINDOWS__
+#include <io.h> // _get_osfhandle
 #include <windows.h>
+#else
+#include <fcntl.h> // open
+#include <unistd.h> // fdatasync, ftruncate
+#include <sys/mman.h> // mmap
 #endif
 
 #include "syslog_.h"
 
 #define DEF_SYSLOG_LOGCACHER_PRINT 1
 #define DEF_SYSLOG_LOGCACHER_WRITE 2
+#define DEF_SYSLOG_LOGCACHER_STAGE 3
+
+#define DEF_SYSLOG_BATCH_WRITE_SIZE 1048576 // дʱд
+#define DEF_SYSLOG_MAPPED_CHUNK 67108864 // ӳļĬÿչ
 
 namespace basicx {
 
-	LogItem::LogItem( uint64_t log_id, syslog_level log_level, std::string& log_cate, std::string& log_info, bool log_move )
+	//  width λ㲹
+	static inline void AppendDigits( std::string& log_text, uint64_t value, int32_t width ) {
+		char digit_buf[24];
+		int32_t index = 24;
+		do {
+			digit_buf[--index] = (char)( '0' + value % 10 );
+			value /= 10;
+		} while( value > 0 );
+		while( 24 - index < width ) {
+			digit_buf[--index] = '0';
+		}
+		log_text.append( digit_buf + index, 24 - index );
+	}
+
+	// Ƚȡ벿֣Ϊ 0 ʱС
+	static inline void AppendSubSecond( std::string& log_text, int64_t nanos, int32_t time_precision ) {
+		static const int64_t divisor[10] = { 1000000000, 100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10, 1 };
+		if( time_precision > 0 ) {
+			log_text.append( "." );
+			AppendDigits( log_text, (uint64_t)( nanos / divisor[time_precision] ), time_precision );
+		}
+	}
+
+	LogItem::LogItem( uint64_t log_id, syslog_level log_level, std::string& log_cate, std::string& log_info, bool log_move, LogFormatter log_formatter/* = nullptr*/, const char* log_format/* = nullptr*/, std::string* log_args/* = nullptr*/ )
 	: m_log_time( std::chrono::system_clock::now() )
 	, m_log_id( log_id )
 	, m_log_level( log_level )
-	, m_log_cate( log_cate ) {
-		if( true == log_move ) {
+	, m_log_cate( log_cate )
+	, m_log_formatter( log_formatter )
+	, m_log_format( log_format ) {
+		if( log_formatter != nullptr ) {
+			m_log_args = *log_args;
+		}
+		else if( true == log_move ) {
 			m_log_info = std::move( log_info );
 		}
 		else {
@@ -56,12 +93,17 @@ namespace basicx {
 	LogItem::~LogItem() {
 	}
 
-	void LogItem::Update( uint64_t log_id, syslog_level log_level, std::string& log_cate, std::string& log_info, bool log_move ) {
+	void LogItem::Update( uint64_t log_id, syslog_level log_level, std::string& log_cate, std::string& log_info, bool log_move, LogFormatter log_formatter/* = nullptr*/, const char* log_format/* = nullptr*/, std::string* log_args/* = nullptr*/ ) {
 		m_log_time = std::chrono::system_clock::now();
 		m_log_id = log_id;
 		m_log_level = log_level;
 		m_log_cate = log_cate;
-		if( true == log_move ) {
+		m_log_formatter = log_formatter;
+		m_log_format = log_format;
+		if( log_formatter != nullptr ) {
+			m_log_args.assign( *log_args ); // 
+		}
+		else if( true == log_move ) {
 			m_log_info = std::move( log_info );
 		}
 		else {
@@ -84,7 +126,58 @@ namespace basicx {
 		m_vec_log_items.clear();
 	}
 
-	LogCacher::LogCacher( uint32_t cacher_id, uint32_t cacher_type, bool thread_safe, bool active_flush, bool active_sync, uint32_t capacity )
+	LogStaging::LogStaging( uint32_t capacity )
+		: m_mask( 1 )
+		, m_next( nullptr )
+		, m_head( 0 )
+		, m_tail( 0 ) {
+		uint64_t size = 2;
+		while( size < capacity ) {
+			size <<= 1;
+		}
+		m_mask = size - 1;
+		m_vec_log_items.resize( size, nullptr ); // Ԫ߳״ʹʱ
+	}
+
+	LogStaging::~LogStaging() {
+		for( size_t i = 0; i < m_vec_log_items.size(); i++ ) {
+			if( m_vec_log_items[i] != nullptr ) {
+				delete m_vec_log_items[i];
+			}
+		}
+		m_vec_log_items.clear();
+	}
+
+	void LogStaging::Push( uint64_t log_id, syslog_level log_level, std::string& log_cate, std::string& log_info, bool log_move, LogFormatter log_formatter/* = nullptr*/, const char* log_format/* = nullptr*/, std::string* log_args/* = nullptr*/ ) {
+		uint64_t tail = m_tail.load( std::memory_order_relaxed );
+		while( tail - m_head.load( std::memory_order_acquire ) > m_mask ) { // ܶд̻߳һֱȴñ
+			std::this_thread::yield();
+		}
+		LogItem*& log_item = m_vec_log_items[tail & m_mask];
+		if( log_item != nullptr ) { // ʹþԪ
+			log_item->Update( log_id, log_level, log_cate, log_info, log_move, log_formatter, log_format, log_args );
+		}
+		else { // ʹ½Ԫ
+			log_item = new LogItem( log_id, log_level, log_cate, log_info, log_move, log_formatter, log_format, log_args );
+		}
+		m_tail.store( tail + 1, std::memory_order_release );
+	}
+
+	LogItem* LogStaging::Front() {
+		uint64_t head = m_head.load( std::memory_order_relaxed );
+		if( head == m_tail.load( std::memory_order_acquire ) ) {
+			return nullptr;
+		}
+		return m_vec_log_items[head & m_mask];
+	}
+
+	void LogStaging::Pop() {
+		m_head.store( m_head.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+	}
+
+	std::atomic<uint32_t> LogCacher::m_staging_serial_count( 0 );
+
+	LogCacher::LogCacher( uint32_t cacher_id, uint32_t cacher_type, bool thread_safe, bool active_flush, bool active_sync, uint32_t capacity, uint32_t staging_step/* = 1*/ )
 		: m_cacher_id( cacher_id )
 		, m_cacher_type( cacher_type )
 		, m_thread_safe( thread_safe )
@@ -103,11 +196,31 @@ namespace basicx {
 		, m_log_path( "" )
 		, m_log_folder( "" )
 		, m_log_file( nullptr )
-		, m_unique_lock( m_worker_lock ) {
+		, m_time_precision( DEF_SYSLOG_TIME_PRECISION_NANO )
+		, m_time_cache_sec( 0 )
+		, m_batch_write( false )
+		, m_sync_interval( 0 )
+		, m_sync_pending( false )
+		, m_sync_time( std::chrono::steady_clock::now() )
+		, m_mapped_file( false )
+		, m_mapped_chunk( DEF_SYSLOG_MAPPED_CHUNK )
+		, m_mapped_data( nullptr )
+		, m_mapped_size( 0 )
+		, m_mapped_used( 0 )
+		, m_mapped_flushed( 0 )
+		, m_mapped_handle( nullptr )
+		, m_mapped_mapping( nullptr )
+		, m_mapped_fd( -1 )
+		, m_unique_lock( m_worker_lock )
+		, m_staging_serial( m_staging_serial_count++ )
+		, m_staging_step( staging_step )
+		, m_staging_next_id( cacher_id - 1 ) //  m_log_item_id % work_threads 䣬Ϊ cacher_id - 1
+		, m_staging_list( nullptr ) {
 		m_log_vector_1 = new LogVector( capacity );
 		m_log_vector_2 = new LogVector( capacity );
 		m_log_vector_read = m_log_vector_1;
 		m_log_vector_write = m_log_vector_1;
+		memset( m_time_cache_buf, 0, sizeof( m_time_cache_buf ) );
 		m_running = true;
 		if( DEF_SYSLOG_LOGCACHER_PRINT == m_cacher_type ) {
 			m_worker = std::thread( &LogCacher::HandleLogItemsPrint, this );
@@ -115,23 +228,31 @@ namespace basicx {
 		if( DEF_SYSLOG_LOGCACHER_WRITE == m_cacher_type ) {
 			m_worker = std::thread( &LogCacher::HandleLogItemsWrite, this );
 		}
+		if( DEF_SYSLOG_LOGCACHER_STAGE == m_cacher_type ) {
+			m_worker = std::thread( &LogCacher::HandleLogItemsStaging, this );
+		}
 	}
 
 	LogCacher::~LogCacher() {
 		m_running = false;
 		m_worker_cond.notify_all();
 		m_worker.join();
-		if( m_log_file != nullptr ) {
-			fflush( m_log_file );
-			fclose( m_log_file );
-			m_log_file = nullptr;
+		if( true == m_batch_write ) {
+			LogCommit( true );
 		}
+		CloseLogFile();
 		if( m_log_vector_1 != nullptr ) {
 			delete m_log_vector_1;
 		}
 		if( m_log_vector_2 != nullptr ) {
 			delete m_log_vector_2;
 		}
+		LogStaging* staging = m_staging_list.load();
+		while( staging != nullptr ) { // ߳˳ݴԱ
+			LogStaging* staging_next = staging->m_next;
+			delete staging;
+			staging = staging_next;
+		}
 	}
 
 	void LogCacher::HandleLogItemsPrint() {
@@ -164,7 +285,12 @@ namespace basicx {
 
 	void LogCacher::HandleLogItemsWrite() {
 		while( true == m_running ) {
-			m_worker_cond.wait( m_unique_lock );
+			if( true == m_sync_pending && m_sync_interval > 0 ) { // ־δͬʱ
+				m_worker_cond.wait_for( m_unique_lock, std::chrono::milliseconds( m_sync_interval ) );
+			}
+			else {
+				m_worker_cond.wait( m_unique_lock );
+			}
 			for( ; m_log_vector_read->m_handled < m_log_vector_read->m_count; ) {
 				m_log_vector_read->m_handled++;
 				LogWrite( m_log_vector_read->m_vec_log_items[m_log_vector_read->m_handled - 1] );
@@ -187,7 +313,77 @@ namespace basicx {
 				}
 				// ڴ־Удְ߳̿ѶдˣԲǷл
 			}
+			if( true == m_batch_write ) { // ȡ־д
+				LogCommit( false );
+			}
+		}
+	}
+
+	// ߳ݴڱŵ m_staging_step Ϊдȫ˳
+	void LogCacher::HandleLogItemsStaging() {
+		uint32_t idle_count = 0;
+		while( true == m_running ) {
+			if( HandleStagingItems( false ) > 0 ) {
+				idle_count = 0;
+			}
+			else if( idle_count < 64 ) { // ó־ߣд־߳軽
+				idle_count++;
+				std::this_thread::yield();
+			}
+			else {
+				std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+			}
 		}
+		HandleStagingItems( true ); // ˳ǰдʣ־
+	}
+
+	size_t LogCacher::HandleStagingItems( bool finish ) {
+		size_t handled = 0;
+		LogStaging* current = nullptr; // ͬһ߳д־ʱŶڣȲϴеĶ
+		while( true ) {
+			LogItem* log_item = nullptr;
+			if( current != nullptr ) {
+				log_item = current->Front();
+				if( nullptr == log_item || log_item->m_log_id != m_staging_next_id ) {
+					current = nullptr;
+				}
+			}
+			if( nullptr == current ) {
+				uint64_t min_log_id = 0;
+				LogStaging* min_staging = nullptr;
+				for( LogStaging* staging = m_staging_list.load( std::memory_order_acquire ); staging != nullptr; staging = staging->m_next ) {
+					LogItem* front = staging->Front();
+					if( front != nullptr ) {
+						if( front->m_log_id == m_staging_next_id ) {
+							current = staging;
+							break;
+						}
+						if( nullptr == min_staging || front->m_log_id < min_log_id ) {
+							min_log_id = front->m_log_id;
+							min_staging = staging;
+						}
+					}
+				}
+				if( nullptr == current ) {
+					if( true == finish && min_staging != nullptr ) { // ˳ʱٵȴȡñŵδд־
+						current = min_staging;
+						m_staging_next_id = min_log_id;
+					}
+					else { // һδдݴ
+						break;
+					}
+				}
+				log_item = current->Front();
+			}
+			LogWrite( log_item );
+			current->Pop();
+			m_staging_next_id += m_staging_step;
+			handled++;
+		}
+		if( true == m_batch_write ) { // ȡ־дʱҲ˲ʱͬ
+			LogCommit( finish );
+		}
+		return handled;
 	}
 
 	void LogCacher::LogPrint( LogItem* log_item ) {
@@ -212,54 +408,220 @@ namespace basicx {
 	}
 
 	void LogCacher::LogWrite( LogItem* log_item ) {
+		if( log_item->m_log_formatter != nullptr ) { // LogWriteF() ӳٸʽ
+			log_item->m_log_formatter( log_item->m_log_info, log_item->m_log_format, log_item->m_log_args );
+			log_item->m_log_formatter = nullptr;
+		}
 		time_t now_time_t = std::chrono::system_clock::to_time_t( std::chrono::floor<std::chrono::seconds>( log_item->m_log_time ) ); // ȡ
-		int64_t now_days = std::chrono::floor<std::chrono::duration<int64_t, std::ratio<86400>>>( log_item->m_log_time ).time_since_epoch().count(); // 
-		if( now_days != m_log_days ) {
-			// д־ǵ̵߳ģΪļ
-			m_log_days = now_days; //
-			tm now_file_tm = { 0 };
-			char now_file_buf[20] = { 0 };
-			localtime_s( &now_file_tm, &now_time_t );
-			strftime( now_file_buf, 20, "%Y-%m-%d_%H-%M-%S", &now_file_tm );
-			FormatLibrary::StandardLibrary::FormatTo( m_log_path, "{0}\\{1}_{2}_{3}.log", m_log_folder, m_log_name, m_cacher_id, now_file_buf ); // cacher_id
-			if( m_log_file != nullptr ) {
-				fflush( m_log_file );
-				fclose( m_log_file );
-				m_log_file = nullptr;
-			}
-			//fopen_s( &m_log_file, m_log_path.c_str(), "wb" );
-			m_log_file = _fsopen( m_log_path.c_str(), "wb", _SH_DENYNO );
-			if( true == m_fs_buffer_user ) {
-				setvbuf( m_log_file, nullptr, m_fs_buffer_mode, m_fs_buffer_size );
+		if( now_time_t != m_time_cache_sec ) { // 仯ʱ䣬Ҳֻڴʱ
+			m_time_cache_sec = now_time_t;
+			int64_t now_days = std::chrono::floor<std::chrono::duration<int64_t, std::ratio<86400>>>( log_item->m_log_time ).time_since_epoch().count(); // 
+			if( now_days != m_log_days ) {
+				// д־ǵ̵߳ģΪļ
+				m_log_days = now_days; //
+				tm now_file_tm = { 0 };
+				char now_file_buf[20] = { 0 };
+				localtime_s( &now_file_tm, &now_time_t );
+				strftime( now_file_buf, 20, "%Y-%m-%d_%H-%M-%S", &now_file_tm );
+				FormatLibrary::StandardLibrary::FormatTo( m_log_path, "{0}\\{1}_{2}_{3}.log", m_log_folder, m_log_name, m_cacher_id, now_file_buf ); // cacher_id
+				if( true == m_batch_write ) { // Ȱܵǰһ־дļ
+					LogCommit( true );
+				}
+				CloseLogFile();
+				OpenLogFile();
 			}
+			tm now_time_tm = { 0 };
+			localtime_s( &now_time_tm, &now_time_t );
+			strftime( m_time_cache_buf, 20, "%Y-%m-%d %H:%M:%S", &now_time_tm );
 		}
-		tm now_time_tm = { 0 };
-		char log_numb_buf[10] = { 0 };
-		char now_time_buf[20] = { 0 };
-		char the_nano_buf[10] = { 0 };
-		localtime_s( &now_time_tm, &now_time_t );
-		snprintf( log_numb_buf, 10, "%09lld", log_item->m_log_id + 1 );
-		strftime( now_time_buf, 20, "%Y-%m-%d %H:%M:%S", &now_time_tm );
-		snprintf( the_nano_buf, 10, "%09lld", std::chrono::duration_cast<std::chrono::nanoseconds>( log_item->m_log_time - std::chrono::system_clock::from_time_t( now_time_t ) ).count() );
-		std::string log_text;
-		log_text.append( log_numb_buf );
+		std::string& log_text = m_log_text; // дʱۻ
+		if( false == m_batch_write ) {
+			log_text.clear();
+		}
+		AppendDigits( log_text, log_item->m_log_id + 1, 9 );
+		log_text.append( " " );
+		log_text.append( m_time_cache_buf, 19 );
+		AppendSubSecond( log_text, std::chrono::duration_cast<std::chrono::nanoseconds>( log_item->m_log_time - std::chrono::system_clock::from_time_t( now_time_t ) ).count(), m_time_precision );
 		log_text.append( " " );
-		log_text.append( now_time_buf );
-		log_text.append( "." );
-		log_text.append( the_nano_buf );
+		log_text.push_back( (char)log_item->m_log_level );
 		log_text.append( " " );
-		log_text.append( (const char*)&log_item->m_log_level );
-		log_text.append( " " + log_item->m_log_cate + " - " + log_item->m_log_info + "\r\n" );
+		log_text.append( log_item->m_log_cate );
+		log_text.append( " - " );
+		log_text.append( log_item->m_log_info );
+		log_text.append( "\r\n" );
+		if( true == m_batch_write ) {
+			if( log_text.length() >= DEF_SYSLOG_BATCH_WRITE_SIZE ) {
+				LogCommit( false );
+			}
+			return;
+		}
 		// д־ǵ̵߳ģΪд־
-		fwrite( log_text.c_str(), log_text.length(), 1, m_log_file );
+		WriteLogFile( log_text.c_str(), log_text.length() );
 		if( true == m_active_flush ) {
+			FlushLogFile( m_active_sync );
+		}
+	}
+
+	// ־һд active_flush ʱÿÿ sync_interval ˢͬһ(ύ)
+	void LogCacher::LogCommit( bool force ) {
+		if( m_log_text.length() > 0 ) {
+			WriteLogFile( m_log_text.c_str(), m_log_text.length() );
+			m_log_text.clear();
+			if( true == m_active_flush ) {
+				m_sync_pending = true;
+			}
+		}
+		if( true == m_sync_pending ) {
+			std::chrono::steady_clock::time_point now_time = std::chrono::steady_clock::now();
+			if( true == force || m_sync_interval <= 0 || now_time - m_sync_time >= std::chrono::milliseconds( m_sync_interval ) ) {
+				FlushLogFile( m_active_sync );
+				m_sync_time = now_time;
+				m_sync_pending = false;
+			}
+		}
+	}
+
+	void LogCacher::FlushLogFile( bool sync ) {
+		if( true == m_mapped_file ) { // ӳϵͳҳ棬ֻ̱Ϊ
+			if( m_mapped_data != nullptr && m_mapped_used > m_mapped_flushed ) { // ֻˢϴ֮дĲ
+#ifdef __OS_WINDOWS__
+				FlushViewOfFile( m_mapped_data + m_mapped_flushed, m_mapped_used - m_mapped_flushed ); // ʼַԶҳȡ
+				if( true == sync ) {
+					FlushFileBuffers( (HANDLE)m_mapped_handle );
+				}
+#else
+				size_t flush_from = m_mapped_flushed - m_mapped_flushed % (size_t)sysconf( _SC_PAGESIZE ); // msync ʼַ밴ҳ
+				msync( m_mapped_data + flush_from, m_mapped_used - flush_from, true == sync ? MS_SYNC : MS_ASYNC );
+#endif
+				m_mapped_flushed = m_mapped_used;
+			}
+			return;
+		}
+		if( m_log_file != nullptr ) {
 			fflush( m_log_file );
-			if( true == m_active_sync ) {
+			if( true == sync ) {
+#ifdef __OS_WINDOWS__
+				FlushFileBuffers( (HANDLE)_get_osfhandle( _fileno( m_log_file ) ) );
+#else
+				fdatasync( fileno( m_log_file ) ); // ֻͬݣٴ̲
+#endif
+			}
+		}
+	}
+
+	void LogCacher::OpenLogFile() {
+		if( true == m_mapped_file ) { // ½ԤһγȲӳ
+			m_mapped_used = 0;
+			m_mapped_flushed = 0;
+#ifdef __OS_WINDOWS__
+			HANDLE file_handle = CreateFileA( m_log_path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL );
+			m_mapped_handle = INVALID_HANDLE_VALUE == file_handle ? nullptr : file_handle;
+#else
+			m_mapped_fd = open( m_log_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644 );
+#endif
+			MapLogFile( m_mapped_chunk );
+			return;
+		}
+		//fopen_s( &m_log_file, m_log_path.c_str(), "wb" );
+		m_log_file = _fsopen( m_log_path.c_str(), "wb", _SH_DENYNO );
+		if( m_log_file != nullptr && true == m_fs_buffer_user ) {
+			setvbuf( m_log_file, nullptr, m_fs_buffer_mode, m_fs_buffer_size );
+		}
+	}
+
+	void LogCacher::CloseLogFile() {
+		if( true == m_mapped_file ) { // ӳȥԤδò
+			UnmapLogFile();
+#ifdef __OS_WINDOWS__
+			if( m_mapped_handle != nullptr ) {
+				LARGE_INTEGER file_size;
+				file_size.QuadPart = (LONGLONG)m_mapped_used;
+				SetFilePointerEx( (HANDLE)m_mapped_handle, file_size, NULL, FILE_BEGIN );
+				SetEndOfFile( (HANDLE)m_mapped_handle );
+				CloseHandle( (HANDLE)m_mapped_handle );
+				m_mapped_handle = nullptr;
+			}
+#else
+			if( m_mapped_fd >= 0 ) {
+				ftruncate( m_mapped_fd, (off_t)m_mapped_used );
+				close( m_mapped_fd );
+				m_mapped_fd = -1;
+			}
+#endif
+			m_mapped_size = 0;
+			m_mapped_used = 0;
+			m_mapped_flushed = 0;
+			return;
+		}
+		if( m_log_file != nullptr ) {
+			fflush( m_log_file );
+			fclose( m_log_file );
+			m_log_file = nullptr;
+		}
+	}
+
+	// չļ mapped_size ӳ䣬ʧʱӳ
+	bool LogCacher::MapLogFile( size_t mapped_size ) {
+		UnmapLogFile();
 #ifdef __OS_WINDOWS__
-				FlushFileBuffers( m_log_file );
+		if( nullptr == m_mapped_handle ) {
+			return false;
+		}
+		// ӳ䳤ȴļʱԶչļ
+		m_mapped_mapping = CreateFileMappingA( (HANDLE)m_mapped_handle, NULL, PAGE_READWRITE, (DWORD)( (uint64_t)mapped_size >> 32 ), (DWORD)( (uint64_t)mapped_size & 0xFFFFFFFF ), NULL );
+		if( nullptr == m_mapped_mapping ) {
+			return false;
+		}
+		m_mapped_data = (char*)MapViewOfFile( (HANDLE)m_mapped_mapping, FILE_MAP_WRITE, 0, 0, mapped_size );
+		if( nullptr == m_mapped_data ) {
+			CloseHandle( (HANDLE)m_mapped_mapping );
+			m_mapped_mapping = nullptr;
+			return false;
+		}
+#else
+		if( m_mapped_fd < 0 || ftruncate( m_mapped_fd, (off_t)mapped_size ) != 0 ) {
+			return false;
+		}
+		void* mapped_data = mmap( nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_mapped_fd, 0 );
+		if( MAP_FAILED == mapped_data ) {
+			return false;
+		}
+		m_mapped_data = (char*)mapped_data;
 #endif
-				// Linux ʹ fsync ҿ fdatasync ٴ̲Ľ
+		m_mapped_size = mapped_size;
+		return true;
+	}
+
+	void LogCacher::UnmapLogFile() {
+		if( m_mapped_data != nullptr ) {
+#ifdef __OS_WINDOWS__
+			UnmapViewOfFile( m_mapped_data );
+			CloseHandle( (HANDLE)m_mapped_mapping );
+			m_mapped_mapping = nullptr;
+#else
+			munmap( m_mapped_data, m_mapped_size );
+#endif
+			m_mapped_data = nullptr;
+		}
+	}
+
+	void LogCacher::WriteLogFile( const char* data, size_t size ) {
+		if( true == m_mapped_file ) {
+			if( m_mapped_used + size > m_mapped_size || nullptr == m_mapped_data ) { // չͬʱɱд
+				size_t mapped_size = m_mapped_size + m_mapped_chunk;
+				while( mapped_size < m_mapped_used + size ) {
+					mapped_size += m_mapped_chunk;
+				}
+				if( false == MapLogFile( mapped_size ) ) {
+					return; // չʧܣд
+				}
 			}
+			memcpy( m_mapped_data + m_mapped_used, data, size );
+			m_mapped_used += size;
+			return;
+		}
+		if( m_log_file != nullptr ) {
+			fwrite( data, size, 1, m_log_file );
 		}
 	}
 
@@ -271,7 +633,7 @@ namespace basicx {
 #endif
 	}
 
-	void LogCacher::AddLogItem( uint64_t log_id, syslog_level log_level, std::string& log_cate, std::string& log_info, bool log_move ) {
+	void LogCacher::AddLogItem( uint64_t log_id, syslog_level log_level, std::string& log_cate, std::string& log_info, bool log_move, LogFormatter log_formatter/* = nullptr*/, const char* log_format/* = nullptr*/, std::string* log_args/* = nullptr*/ ) {
 		if( true == m_thread_safe ) {
 			m_writing_vector_lock.lock();
 		}
@@ -287,11 +649,11 @@ namespace basicx {
 			m_changing_vector_lock.unlock();
 		}
 		if( m_log_vector_write->m_count < m_log_vector_write->m_vec_log_items.size() ) { // ʹþԪ
-			m_log_vector_write->m_vec_log_items[m_log_vector_write->m_count]->Update( log_id, log_level, log_cate, log_info, log_move );
+			m_log_vector_write->m_vec_log_items[m_log_vector_write->m_count]->Update( log_id, log_level, log_cate, log_info, log_move, log_formatter, log_format, log_args );
 			m_log_vector_write->m_count++; // Ժ
 		}
 		else { // ʹ½Ԫ
-			m_log_vector_write->m_vec_log_items.push_back( new LogItem( log_id, log_level, log_cate, log_info, log_move ) );
+			m_log_vector_write->m_vec_log_items.push_back( new LogItem( log_id, log_level, log_cate, log_info, log_move, log_formatter, log_format, log_args ) );
 			m_log_vector_write->m_count++; // Ժ
 		}
 		m_worker_cond.notify_all(); //
@@ -300,6 +662,22 @@ namespace basicx {
 		}
 	}
 
+	void LogCacher::AddStagingItem( uint64_t log_id, syslog_level log_level, std::string& log_cate, std::string& log_info, bool log_move, LogFormatter log_formatter/* = nullptr*/, const char* log_format/* = nullptr*/, std::string* log_args/* = nullptr*/ ) {
+		static thread_local std::vector<LogStaging*> tls_vec_staging; //  m_staging_serial ߳ڸϵݴ
+		if( m_staging_serial >= tls_vec_staging.size() ) {
+			tls_vec_staging.resize( m_staging_serial + 1, nullptr );
+		}
+		LogStaging*& staging = tls_vec_staging[m_staging_serial];
+		if( nullptr == staging ) { // ߳״д룬ǼǺд̼߳ɼ
+			staging = new LogStaging( m_capacity );
+			m_staging_lock.lock();
+			staging->m_next = m_staging_list.load( std::memory_order_relaxed );
+			m_staging_list.store( staging, std::memory_order_release );
+			m_staging_lock.unlock();
+		}
+		staging->Push( log_id, log_level, log_cate, log_info, log_move, log_formatter, log_format, log_args );
+	}
+
 	SysLog_P::SysLog_P( std::string log_name )
 		: m_log_days( 0 )
 		, m_log_name( log_name )
@@ -309,6 +687,12 @@ namespace basicx {
 		, m_active_sync( false )
 		, m_work_threads( 1 )
 		, m_init_capacity( 8192 )
+		, m_thread_staging( false )
+		, m_time_precision( DEF_SYSLOG_TIME_PRECISION_NANO )
+		, m_batch_write( false )
+		, m_sync_interval( 0 )
+		, m_mapped_file( false )
+		, m_mapped_chunk( 0 )
 		, m_fs_buffer_user( false )
 		, m_fs_buffer_mode( _IONBF )
 		, m_fs_buffer_size( 4096 )
@@ -365,6 +749,30 @@ namespace basicx {
 		m_init_capacity = init_capacity;
 	}
 
+	void SysLog_P::SetThreadStaging( bool thread_staging ) {
+		m_thread_staging = thread_staging;
+	}
+
+	void SysLog_P::SetTimePrecision( int32_t time_precision ) {
+		if( time_precision < 0 ) {
+			time_precision = 0;
+		}
+		if( time_precision > DEF_SYSLOG_TIME_PRECISION_NANO ) {
+			time_precision = DEF_SYSLOG_TIME_PRECISION_NANO;
+		}
+		m_time_precision = time_precision;
+	}
+
+	void SysLog_P::SetBatchWrite( bool batch_write, int32_t sync_interval/* = 0*/ ) {
+		m_batch_write = batch_write;
+		m_sync_interval = sync_interval;
+	}
+
+	void SysLog_P::SetMappedFile( bool mapped_file, size_t mapped_chunk/* = 0*/ ) {
+		m_mapped_file = mapped_file;
+		m_mapped_chunk = mapped_chunk;
+	}
+
 	void SysLog_P::SetFileStreamBuffer( int32_t mode, size_t size/* = 0*/ ) {
 		m_fs_buffer_user = true; // ֻҪ˾Ϊ true
 		m_fs_buffer_mode = mode;
@@ -431,19 +839,28 @@ namespace basicx {
 
 		if( true == m_local_cache ) {
 			for( size_t i = 0; i < m_work_threads; i++ ) {
-				LogCacher* cacher = new LogCacher( i + 1, DEF_SYSLOG_LOGCACHER_WRITE, m_thread_safe, m_active_flush, m_active_sync, m_init_capacity );
+				LogCacher* cacher = nullptr;
+				if( true == m_thread_staging ) {
+					cacher = new LogCacher( i + 1, DEF_SYSLOG_LOGCACHER_STAGE, m_thread_safe, m_active_flush, m_active_sync, m_init_capacity, m_work_threads );
+				}
+				else {
+					cacher = new LogCacher( i + 1, DEF_SYSLOG_LOGCACHER_WRITE, m_thread_safe, m_active_flush, m_active_sync, m_init_capacity );
+				}
 				cacher->m_fs_buffer_user = m_fs_buffer_user;
 				cacher->m_fs_buffer_mode = m_fs_buffer_mode;
 				cacher->m_fs_buffer_size = m_fs_buffer_size;
+				cacher->m_time_precision = m_time_precision;
+				cacher->m_batch_write = m_batch_write;
+				cacher->m_sync_interval = m_sync_interval;
 				cacher->m_log_days = m_log_days;
 				cacher->m_log_name = m_log_name;
 				FormatLibrary::StandardLibrary::FormatTo( cacher->m_log_path, "{0}\\{1}_{2}_{3}.log", m_log_folder, m_log_name, i + 1, now_file_buf ); // cacher_id
 				cacher->m_log_folder = m_log_folder;
-				//fopen_s( &cacher->m_log_file, cacher->m_log_path.c_str(), "wb" );
-				cacher->m_log_file = _fsopen( cacher->m_log_path.c_str(), "wb", _SH_DENYNO );
-				if( true == m_fs_buffer_user ) {
-					setvbuf( cacher->m_log_file, nullptr, m_fs_buffer_mode, m_fs_buffer_size );
+				cacher->m_mapped_file = m_mapped_file;
+				if( m_mapped_chunk > 0 ) {
+					cacher->m_mapped_chunk = m_mapped_chunk;
 				}
+				cacher->OpenLogFile();
 				m_vec_log_cachers.push_back( cacher );
 			}
 			m_log_cacher_print = new LogCacher( 0, DEF_SYSLOG_LOGCACHER_PRINT, m_thread_safe, m_active_flush, m_active_sync, m_init_capacity ); //
@@ -574,8 +991,14 @@ namespace basicx {
 	// ͬһڣͬһ FILE* Ĳ fwritḛ߳ȫģȻֻ POSIX ݵϵͳϳWindows ϵ FILE* Ĳ̰߳ȫ
 	void SysLog_P::LogWrite( syslog_level log_level, std::string& log_cate, std::string& log_info, bool log_move/* = false*/ ) {
 		if( true == m_local_cache ) {
-			m_vec_log_cachers[m_log_item_id % m_work_threads]->AddLogItem( m_log_item_id, log_level, log_cate, log_info, log_move );
-			m_log_item_id++;
+			if( true == m_thread_staging ) { // ԭӵд뱾߳ݴУ
+				uint64_t log_item_id = m_log_item_id++;
+				m_vec_log_cachers[log_item_id % m_work_threads]->AddStagingItem( log_item_id, log_level, log_cate, log_info, log_move );
+			}
+			else {
+				m_vec_log_cachers[m_log_item_id % m_work_threads]->AddLogItem( m_log_item_id, log_level, log_cate, log_info, log_move );
+				m_log_item_id++;
+			}
 		}
 		else {
 			std::chrono::system_clock::time_point now_time = std::chrono::system_clock::now();
@@ -605,14 +1028,11 @@ namespace basicx {
 			}
 			tm now_time_tm = { 0 };
 			char now_time_buf[20] = { 0 };
-			char the_nano_buf[10] = { 0 };
 			localtime_s( &now_time_tm, &now_time_t );
 			strftime( now_time_buf, 20, "%Y-%m-%d %H:%M:%S", &now_time_tm );
-			snprintf( the_nano_buf, 10, "%09lld", std::chrono::duration_cast<std::chrono::nanoseconds>( now_time - std::chrono::system_clock::from_time_t( now_time_t ) ).count() );
 			std::string log_text;
 			log_text.append( now_time_buf );
-			log_text.append( "." );
-			log_text.append( the_nano_buf );
+			AppendSubSecond( log_text, std::chrono::duration_cast<std::chrono::nanoseconds>( now_time - std::chrono::system_clock::from_time_t( now_time_t ) ).count(), m_time_precision );
 			log_text.append( " " );
 			log_text.append( (const char*)&log_level );
 			log_text.append( " " + log_cate + " - " + log_info + "\r\n" );
@@ -639,6 +1059,24 @@ namespace basicx {
 		}
 	}
 
+	void SysLog_P::LogWriteB( syslog_level log_level, std::string& log_cate, LogFormatter log_formatter, const char* log_format, std::string& log_args ) {
+		std::string log_info = ""; // д߳
+		if( true == m_local_cache ) {
+			if( true == m_thread_staging ) {
+				uint64_t log_item_id = m_log_item_id++;
+				m_vec_log_cachers[log_item_id % m_work_threads]->AddStagingItem( log_item_id, log_level, log_cate, log_info, false, log_formatter, log_format, &log_args );
+			}
+			else {
+				m_vec_log_cachers[m_log_item_id % m_work_threads]->AddLogItem( m_log_item_id, log_level, log_cate, log_info, false, log_formatter, log_format, &log_args );
+				m_log_item_id++;
+			}
+		}
+		else { // д̣߳͵ظʽ
+			log_formatter( log_info, log_format, log_args );
+			LogWrite( log_level, log_cate, log_info, true );
+		}
+	}
+
 	SysLog_K::SysLog_K( std::string log_name )
 		: m_syslog_p( nullptr ) {
 		try {
@@ -693,6 +1131,22 @@ namespace basicx {
 		m_syslog_p->SetInitCapacity( init_capacity );
 	}
 
+	void SysLog_D::SetThreadStaging( bool thread_staging ) {
+		m_syslog_p->SetThreadStaging( thread_staging );
+	}
+
+	void SysLog_D::SetTimePrecision( int32_t time_precision ) {
+		m_syslog_p->SetTimePrecision( time_precision );
+	}
+
+	void SysLog_D::SetBatchWrite( bool batch_write, int32_t sync_interval/* = 0*/ ) {
+		m_syslog_p->SetBatchWrite( batch_write, sync_interval );
+	}
+
+	void SysLog_D::SetMappedFile( bool mapped_file, size_t mapped_chunk/* = 0*/ ) {
+		m_syslog_p->SetMappedFile( mapped_file, mapped_chunk );
+	}
+
 	void SysLog_D::SetFileStreamBuffer( int32_t mode, size_t size/* = 0*/ ) {
 		m_syslog_p->SetFileStreamBuffer( mode, size );
 	}
@@ -721,6 +1175,10 @@ namespace basicx {
 		m_syslog_p->LogWrite( log_level, log_cate, log_info, log_move );
 	}
 
+	void SysLog_D::LogWriteB( syslog_level log_level, std::string& log_cate, LogFormatter log_formatter, const char* log_format, std::string& log_args ) {
+		m_syslog_p->LogWriteB( log_level, log_cate, log_formatter, log_format, log_args );
+	}
+
 	basicx::SysLog_S* basicx::SysLog_S::m_instance = nullptr;
 
 	SysLog_S::SysLog_S( std::string log_name )
@@ -767,6 +1225,22 @@ namespace basicx {
 		m_syslog_p->SetInitCapacity( init_capacity );
 	}
 
+	void SysLog_S::SetThreadStaging( bool thread_staging ) {
+		m_syslog_p->SetThreadStaging( thread_staging );
+	}
+
+	void SysLog_S::SetTimePrecision( int32_t time_precision ) {
+		m_syslog_p->SetTimePrecision( time_precision );
+	}
+
+	void SysLog_S::SetBatchWrite( bool batch_write, int32_t sync_interval/* = 0*/ ) {
+		m_syslog_p->SetBatchWrite( batch_write, sync_interval );
+	}
+
+	void SysLog_S::SetMappedFile( bool mapped_file, size_t mapped_chunk/* = 0*/ ) {
+		m_syslog_p->SetMappedFile( mapped_file, mapped_chunk );
+	}
+
 	void SysLog_S::SetFileStreamBuffer( int32_t mode, size_t size/* = 0*/ ) {
 		m_syslog_p->SetFileStreamBuffer( mode, size );
 	}
@@ -795,4 +1269,8 @@ namespace basicx {
 		m_syslog_p->LogWrite( log_level, log_cate, log_info, log_move );
 	}
 
+	void SysLog_S::LogWriteB( syslog_level log_level, std::string& log_cate, LogFormatter log_formatter, const char* log_format, std::string& log_args ) {
+		m_syslog_p->LogWriteB( log_level, log_cate, log_formatter, log_format, log_args );
+	}
+
 } // namespace basicx
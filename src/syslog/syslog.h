@@ -22,14 +22,25 @@
 #ifndef BASICX_SYSLOG_SYSLOG_H
 #define BASICX_SYSLOG_SYSLOG_H
 
+#include <tuple>
+#include <string>
+#include <cstring>
+#include <utility>
+#include <type_traits>
 #include <stdint.h> // int32_t, int64_t
 
 #include <common/compile.h>
+#include <common/Format/Format.hpp>
 
 #define DEF_SYSLOG_FSBM_FULL _IOFBF
 #define DEF_SYSLOG_FSBM_LINE _IOLBF
 #define DEF_SYSLOG_FSBM_NONE _IONBF
 
+#define DEF_SYSLOG_TIME_PRECISION_SECOND 0
+#define DEF_SYSLOG_TIME_PRECISION_MILLI 3
+#define DEF_SYSLOG_TIME_PRECISION_MICRO 6
+#define DEF_SYSLOG_TIME_PRECISION_NANO 9
+
 namespace basicx {
 
 	class SysLog_P;
@@ -39,6 +50,128 @@ namespace basicx {
 		c_debug = 'D', c_info = 'I', c_hint = 'H', c_warn = 'W', c_error = 'E', c_fatal = 'F',
 	};
 
+	// д̰߳ʽƲ־ݣ LogWriteF() ʵ
+	typedef void ( *LogFormatter )( std::string& log_info, const char* log_format, const std::string& log_args );
+
+	namespace syslog_f { // LogWriteF() 룬ַΪ  + ݣఴֵֽڣͷļֻ C++11
+
+		template<typename T> struct ArgStore { typedef T Type; };
+		template<> struct ArgStore<char*> { typedef std::string Type; };
+		template<> struct ArgStore<const char*> { typedef std::string Type; };
+
+		template<typename T> using ArgStoreT = typename ArgStore<typename std::decay<T>::type>::Type;
+
+		template<size_t... I> struct ArgIndex {};
+		template<size_t N, size_t... I> struct MakeArgIndex : MakeArgIndex<N - 1, N - 1, I...> {};
+		template<size_t... I> struct MakeArgIndex<0, I...> { typedef ArgIndex<I...> Type; };
+
+		inline void EncodeText( std::string& log_args, const char* data, size_t size ) {
+			uint32_t text_size = (uint32_t)size;
+			log_args.append( (const char*)&text_size, sizeof( text_size ) );
+			log_args.append( data, size );
+		}
+
+		inline void EncodeString( std::string& log_args, const std::string& arg ) {
+			EncodeText( log_args, arg.data(), arg.size() );
+		}
+
+		inline void EncodeString( std::string& log_args, const char* arg ) {
+			if( arg != nullptr ) {
+				EncodeText( log_args, arg, strlen( arg ) );
+			}
+			else {
+				EncodeText( log_args, "", 0 );
+			}
+		}
+
+		template<typename T>
+		inline void EncodeArg( std::string& log_args, const T& arg, std::true_type ) { // ַ
+			EncodeString( log_args, arg );
+		}
+
+		template<typename T>
+		inline void EncodeArg( std::string& log_args, const T& arg, std::false_type ) {
+			static_assert( std::is_trivially_copyable<ArgStoreT<T>>::value, "LogWriteF() argument must be string or trivially copyable" );
+			log_args.append( (const char*)&arg, sizeof( ArgStoreT<T> ) );
+		}
+
+		template<typename T>
+		inline void EncodeArg( std::string& log_args, const T& arg ) {
+			EncodeArg( log_args, arg, typename std::is_same<ArgStoreT<T>, std::string>::type() );
+		}
+
+		inline void DecodeArg( const char*& cursor, std::string& arg ) {
+			uint32_t size = 0;
+			memcpy( &size, cursor, sizeof( size ) );
+			cursor += sizeof( size );
+			arg.assign( cursor, size );
+			cursor += size;
+		}
+
+		template<typename S>
+		inline void DecodeArg( const char*& cursor, S& arg ) {
+			memcpy( &arg, cursor, sizeof( S ) );
+			cursor += sizeof( S );
+		}
+
+		template<size_t K, typename Tuple>
+		inline typename std::enable_if<( K == std::tuple_size<Tuple>::value )>::type DecodeArgs( const char*& cursor, Tuple& values ) {
+		}
+
+		template<size_t K, typename Tuple>
+		inline typename std::enable_if<( K < std::tuple_size<Tuple>::value )>::type DecodeArgs( const char*& cursor, Tuple& values ) { // ˳
+			DecodeArg( cursor, std::get<K>( values ) );
+			DecodeArgs<K + 1>( cursor, values );
+		}
+
+		template<typename... S>
+		struct LogRecord
+		{
+			template<size_t... I>
+			static void FormatArgs( std::string& log_info, const char* log_format, const std::string& log_args, ArgIndex<I...> ) {
+				std::tuple<S...> values;
+				const char* cursor = log_args.data();
+				DecodeArgs<0>( cursor, values );
+				FormatLibrary::StandardLibrary::FormatTo( log_info, log_format, std::get<I>( values )... );
+			}
+
+			static void Formatter( std::string& log_info, const char* log_format, const std::string& log_args ) {
+				FormatArgs( log_info, log_format, log_args, typename MakeArgIndex<sizeof...( S )>::Type() );
+			}
+		};
+
+		template<>
+		struct LogRecord<>
+		{
+			static void Formatter( std::string& log_info, const char* log_format, const std::string& log_args ) {
+				log_info = log_format;
+			}
+		};
+
+		inline std::string& ArgsBuffer() { // ÿ̸߳ãʱ
+			thread_local std::string log_args;
+			return log_args;
+		}
+
+		inline void EncodeArgsTo( std::string& log_args ) {
+		}
+
+		template<typename T, typename... Args>
+		inline void EncodeArgsTo( std::string& log_args, const T& arg, const Args&... args ) {
+			EncodeArg( log_args, arg );
+			EncodeArgsTo( log_args, args... );
+		}
+
+		template<typename... Args>
+		inline std::string& EncodeArgs( const Args&... args ) {
+			std::string& log_args = ArgsBuffer();
+			log_args.clear();
+			EncodeArgsTo( log_args, args... );
+			return log_args;
+		}
+
+	} // namespace syslog_f
+
 	class BASICX_SYSLOG_EXPIMP SysLog_K // kernel
 	{
 	private:
@@ -68,6 +201,10 @@ namespace basicx {
 		void SetActiveSync( bool active_sync ); // Ĭ false // 迪 active_flush Ч
 		void SetWorkThreads( size_t work_threads ); // Ĭ 1
 		void SetInitCapacity( uint32_t init_capacity ); // Ĭ 8192
+		void SetThreadStaging( bool thread_staging ); // Ĭ false // 迪 local_cache Чÿд־̶߳ռݴ
+		void SetTimePrecision( int32_t time_precision ); // Ĭ DEF_SYSLOG_TIME_PRECISION_NANO // ־ʱСλ 0 ~ 9
+		void SetBatchWrite( bool batch_write, int32_t sync_interval = 0 ); // Ĭ false // 迪 local_cache Чÿ־һд active_flush ʱÿÿ sync_interval ˢͬһ
+		void SetMappedFile( bool mapped_file, size_t mapped_chunk = 0 ); // Ĭ false // 迪 local_cache Ч־ļԤ mapped_chunk ֽ(Ĭ 64MB)ӳ䵽ڴд룬дչļ˳ʱȥδò֣̱ļβֽܲ
 		void SetFileStreamBuffer( int32_t mode, size_t size = 0 ); // ̬ MySQLMariaDB ʱҪΪ ޻ Ȼдļ־ᱻ
 		void InitSysLog( std::string app_name, std::string app_version, std::string app_company, std::string app_copyright ); // úòٵ
 		void PrintSysInfo();
@@ -76,6 +213,12 @@ namespace basicx {
 		// 0(debug)1Ϣ(info)2ʾ(hint)3(warn)4(error)5(fatal)
 		void LogPrint( syslog_level log_level, std::string& log_cate, std::string& log_info, bool log_move = false );
 		void LogWrite( syslog_level log_level, std::string& log_cate, std::string& log_info, bool log_move = false );
+		// ӳٸʽֻ߳Ʋд̰߳ FormatTo ʽ־ݣʽΪģ־дǰж
+		template<size_t N, typename... Args>
+		void LogWriteF( syslog_level log_level, std::string& log_cate, const char( &log_format )[N], const Args&... args ) {
+			LogWriteB( log_level, log_cate, &syslog_f::LogRecord<syslog_f::ArgStoreT<Args>...>::Formatter, log_format, syslog_f::EncodeArgs( args... ) );
+		}
+		void LogWriteB( syslog_level log_level, std::string& log_cate, LogFormatter log_formatter, const char* log_format, std::string& log_args );
 
 	private:
 		SysLog_P * m_syslog_p;
@@ -100,6 +243,10 @@ namespace basicx {
 		void SetActiveSync( bool active_sync ); // Ĭ false // 迪 active_flush Ч
 		void SetWorkThreads( size_t work_threads ); // Ĭ 1
 		void SetInitCapacity( uint32_t init_capacity ); // Ĭ 8192
+		void SetThreadStaging( bool thread_staging ); // Ĭ false // 迪 local_cache Чÿд־̶߳ռݴ
+		void SetTimePrecision( int32_t time_precision ); // Ĭ DEF_SYSLOG_TIME_PRECISION_NANO // ־ʱСλ 0 ~ 9
+		void SetBatchWrite( bool batch_write, int32_t sync_interval = 0 ); // Ĭ false // 迪 local_cache Чÿ־һд active_flush ʱÿÿ sync_interval ˢͬһ
+		void SetMappedFile( bool mapped_file, size_t mapped_chunk = 0 ); // Ĭ false // 迪 local_cache Ч־ļԤ mapped_chunk ֽ(Ĭ 64MB)ӳ䵽ڴд룬дչļ˳ʱȥδò֣̱ļβֽܲ
 		void SetFileStreamBuffer( int32_t mode, size_t size = 0 ); // ̬ MySQLMariaDB ʱҪΪ ޻ Ȼдļ־ᱻ
 		void InitSysLog( std::string app_name, std::string app_version, std::string app_company, std::string app_copyright ); // úòٵ
 		void PrintSysInfo();
@@ -108,6 +255,12 @@ namespace basicx {
 		// 0(debug)1Ϣ(info)2ʾ(hint)3(warn)4(error)5(fatal)
 		void LogPrint( syslog_level log_level, std::string& log_cate, std::string& log_info, bool log_move = false );
 		void LogWrite( syslog_level log_level, std::string& log_cate, std::string& log_info, bool log_move = false );
+		// ӳٸʽֻ߳Ʋд̰߳ FormatTo ʽ־ݣʽΪģ־дǰж
+		template<size_t N, typename... Args>
+		void LogWriteF( syslog_level log_level, std::string& log_cate, const char( &log_format )[N], const Args&... args ) {
+			LogWriteB( log_level, log_cate, &syslog_f::LogRecord<syslog_f::ArgStoreT<Args>...>::Formatter, log_format, syslog_f::EncodeArgs( args... ) );
+		}
+		void LogWriteB( syslog_level log_level, std::string& log_cate, LogFormatter log_formatter, const char* log_format, std::string& log_args );
 
 	private:
 		SysLog_P* m_syslog_p;
@@ -22,6 +22,7 @@
 #ifndef BASICX_SYSLOG_SYSLOG_P_H
 #define BASICX_SYSLOG_SYSLOG_P_H
 
+#include <ctime>
 #include <mutex>
 #include <atomic>
 #include <vector>
@@ -41,11 +42,11 @@ namespace basicx {
 		LogItem() {};
 
 	public:
-		LogItem( uint64_t log_id, syslog_level log_level, std::string& log_cate, std::string& log_info, bool log_move );
+		LogItem( uint64_t log_id, syslog_level log_level, std::string& log_cate, std::string& log_info, bool log_move, LogFormatter log_formatter = nullptr, const char* log_format = nullptr, std::string* log_args = nullptr );
 		~LogItem();
 
 	public:
-		void Update( uint64_t log_id, syslog_level log_level, std::string& log_cate, std::string& log_info, bool log_move );
+		void Update( uint64_t log_id, syslog_level log_level, std::string& log_cate, std::string& log_info, bool log_move, LogFormatter log_formatter = nullptr, const char* log_format = nullptr, std::string* log_args = nullptr );
 
 	public:
 		uint64_t m_log_id;
@@ -53,6 +54,9 @@ namespace basicx {
 		syslog_level m_log_level;
 		std::string m_log_cate;
 		std::string m_log_info;
+		LogFormatter m_log_formatter; // ǿʱ m_log_info д߳
+		const char* m_log_format;
+		std::string m_log_args; // Ʋ
 	};
 
 	class LogVector
@@ -71,22 +75,58 @@ namespace basicx {
 		std::vector<LogItem*> m_vec_log_items;
 	};
 
+	// ߵ߻ݴУÿд־߳ÿ LogCacher ϶ռһдʱ
+	class LogStaging
+	{
+	private:
+		LogStaging() {};
+
+	public:
+		LogStaging( uint32_t capacity ); // ȡС capacity  2 
+		~LogStaging();
+
+	public:
+		void Push( uint64_t log_id, syslog_level log_level, std::string& log_cate, std::string& log_info, bool log_move, LogFormatter log_formatter = nullptr, const char* log_format = nullptr, std::string* log_args = nullptr ); // ̵߳ãʱóȴ
+		LogItem* Front(); // ̵߳ãпʱ nullptr
+		void Pop(); // ̵߳
+
+	public:
+		uint64_t m_mask;
+		std::vector<LogItem*> m_vec_log_items;
+		LogStaging* m_next; // Ǽ޸
+		char m_pad_1[64]; // λãα
+		std::atomic<uint64_t> m_head; // λ
+		char m_pad_2[64];
+		std::atomic<uint64_t> m_tail; // λ
+		char m_pad_3[64];
+	};
+
 	class LogCacher
 	{
 	private:
 		LogCacher() {};
 
 	public:
-		LogCacher( uint32_t cacher_id, uint32_t cacher_type, bool thread_safe, bool active_flush, bool active_sync, uint32_t capacity );
+		LogCacher( uint32_t cacher_id, uint32_t cacher_type, bool thread_safe, bool active_flush, bool active_sync, uint32_t capacity, uint32_t staging_step = 1 );
 		~LogCacher();
 
 	public:
 		void HandleLogItemsPrint();
 		void HandleLogItemsWrite();
+		void HandleLogItemsStaging();
+		size_t HandleStagingItems( bool finish );
 		void LogPrint( LogItem* log_item );
 		void LogWrite( LogItem* log_item );
+		void LogCommit( bool force );
+		void FlushLogFile( bool sync );
+		void OpenLogFile();
+		void CloseLogFile();
+		bool MapLogFile( size_t mapped_size );
+		void UnmapLogFile();
+		void WriteLogFile( const char* data, size_t size );
 		void SetTextColor( unsigned short color );
-		void AddLogItem( uint64_t log_id, syslog_level log_level, std::string& log_cate, std::string& log_info, bool log_move );
+		void AddLogItem( uint64_t log_id, syslog_level log_level, std::string& log_cate, std::string& log_info, bool log_move, LogFormatter log_formatter = nullptr, const char* log_format = nullptr, std::string* log_args = nullptr );
+		void AddStagingItem( uint64_t log_id, syslog_level log_level, std::string& log_cate, std::string& log_info, bool log_move, LogFormatter log_formatter = nullptr, const char* log_format = nullptr, std::string* log_args = nullptr );
 
 	public:
 		uint32_t m_cacher_id;
@@ -104,6 +144,23 @@ namespace basicx {
 		std::string m_log_folder; // ⲿֵ
 
 		FILE* m_log_file; // ⲿֵ
+		int32_t m_time_precision; // ⲿֵ
+		time_t m_time_cache_sec; // ʱд̷߳
+		char m_time_cache_buf[20]; // "%Y-%m-%d %H:%M:%S"
+		std::string m_log_text; // 
+		bool m_batch_write; // ⲿֵ
+		int32_t m_sync_interval; // ⲿֵ
+		bool m_sync_pending; // дδˢͬ
+		std::chrono::steady_clock::time_point m_sync_time;
+		bool m_mapped_file; // ⲿֵ
+		size_t m_mapped_chunk; // ⲿֵ
+		char* m_mapped_data;
+		size_t m_mapped_size; // ļӳ䳤
+		size_t m_mapped_used; // д볤
+		size_t m_mapped_flushed; // ˢ³ȣ֮ǰĲֲظˢ
+		void* m_mapped_handle; // Windows ļ
+		void* m_mapped_mapping; // Windows ӳ
+		int32_t m_mapped_fd; // Linux ļ
 		std::thread m_worker;
 		std::atomic<bool> m_running;
 		std::mutex m_worker_lock;
@@ -116,6 +173,13 @@ namespace basicx {
 		LogVector* m_log_vector_write;
 		std::mutex m_writing_vector_lock;
 		std::mutex m_changing_vector_lock;
+
+		uint32_t m_staging_serial; // ̱߳ݴΨһ
+		uint64_t m_staging_step; // ־ż work_threads
+		uint64_t m_staging_next_id; // һӦд־ţд̷߳
+		std::mutex m_staging_lock; // ߳״д־Ǽݴʱʹ
+		std::atomic<LogStaging*> m_staging_list;
+		static std::atomic<uint32_t> m_staging_serial_count;
 	};
 
 	class SysLog_P
@@ -134,6 +198,10 @@ namespace basicx {
 		void SetActiveSync( bool active_sync ); // Ĭ false
 		void SetWorkThreads( size_t work_threads ); // Ĭ 1
 		void SetInitCapacity( uint32_t init_capacity ); // Ĭ 8192
+		void SetThreadStaging( bool thread_staging ); // Ĭ false
+		void SetTimePrecision( int32_t time_precision ); // Ĭ DEF_SYSLOG_TIME_PRECISION_NANO
+		void SetBatchWrite( bool batch_write, int32_t sync_interval = 0 ); // Ĭ false
+		void SetMappedFile( bool mapped_file, size_t mapped_chunk = 0 ); // Ĭ false
 		void SetFileStreamBuffer( int32_t mode, size_t size = 0 ); // ̬ MySQLMariaDB ʱҪΪ ޻ Ȼдļ־ᱻ
 		void InitSysLog( std::string app_name, std::string app_version, std::string app_company, std::string app_copyright ); // úòٵ
 		void PrintSysInfo();
@@ -143,6 +211,7 @@ namespace basicx {
 		// 0(debug)1Ϣ(info)2ʾ(hint)3(warn)4(error)5(fatal)
 		void LogPrint( syslog_level log_level, std::string& log_cate, std::string& log_info, bool log_move = false );
 		void LogWrite( syslog_level log_level, std::string& log_cate, std::string& log_info, bool log_move = false );
+		void LogWriteB( syslog_level log_level, std::string& log_cate, LogFormatter log_formatter, const char* log_format, std::string& log_args );
 
 	private:
 		bool m_thread_safe;
@@ -151,6 +220,12 @@ namespace basicx {
 		bool m_active_sync;
 		size_t m_work_threads;
 		uint32_t m_init_capacity;
+		bool m_thread_staging;
+		int32_t m_time_precision;
+		bool m_batch_write;
+		int32_t m_sync_interval;
+		bool m_mapped_file;
+		size_t m_mapped_chunk;
 		bool m_fs_buffer_user;
 		int32_t m_fs_buffer_mode;
 		size_t m_fs_buffer_size;
@@ -19,6 +19,8 @@
 * Be sure to retain the above copyright notice and conditions.
 */
 
+#include <chrono>
+
 #include <common/define.h>
 #include <common/JsonCpp/json.h>
 
@@ -26,12 +28,19 @@
 
 namespace basicx {
 
-	SysRtm_P::SysRtm_P() : NetServer_X() {
+	SysRtm_P::SysRtm_P()
+		: NetServer_X()
+		, m_metrics_interval( RTM_METRICS_INTERVAL )
+		, m_metrics_running( false ) {
 		m_syscfg = SysCfg_S::GetInstance();
 		m_syslog = SysLog_S::GetInstance();
 	}
 
 	SysRtm_P::~SysRtm_P() {
+		if( true == m_metrics_running ) {
+			m_metrics_running = false;
+			m_metrics_thread.join();
+		}
 	}
 
 	void SysRtm_P::OnNetServerInfo( NetServerInfo& net_server_info ) {
@@ -60,6 +69,93 @@ namespace basicx {
 				m_net_server_broad->Server_AddListen( "0.0.0.0", cfg_basic->m_vec_server_server[i].m_port, cfg_basic->m_vec_server_server[i].m_type ); // 0.0.0.0
 			}
 		}
+
+		if( m_metrics_interval > 0 && false == m_metrics_running ) {
+			m_metrics_running = true;
+			m_metrics_thread = std::thread( &SysRtm_P::Thread_Metrics, this );
+		}
+	}
+
+	void SysRtm_P::SetMetricsInterval( int32_t metrics_interval ) {
+		m_metrics_interval = metrics_interval > 0 ? metrics_interval : 0;
+	}
+
+	void SysRtm_P::Thread_Metrics() {
+		std::chrono::steady_clock::time_point next_time = std::chrono::steady_clock::now() + std::chrono::milliseconds( m_metrics_interval );
+		while( true == m_metrics_running ) {
+			std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) ); // 分段等待，退出时不必等满一个间隔
+			if( std::chrono::steady_clock::now() >= next_time ) {
+				next_time += std::chrono::milliseconds( m_metrics_interval );
+				try {
+					BroadcastMetrics();
+				}
+				catch( ... ) {
+					std::string log_cate = "<SYSRTM>";
+					std::string log_info = "广播 网络统计 发生未知错误！";
+					m_syslog->LogWrite( syslog_level::c_error, log_cate, log_info );
+				}
+			}
+		}
+	}
+
+	void SysRtm_P::BroadcastMetrics() {
+		if( m_net_server_broad->Server_GetConnectCount() > 0 ) {
+			time_t now_time_t;
+			time( &now_time_t );
+			tm now_time_tm = { 0 };
+			localtime_s( &now_time_tm, &now_time_t );
+			int32_t now_time = now_time_tm.tm_hour * 10000 + now_time_tm.tm_min * 100 + now_time_tm.tm_sec;
+
+			std::vector<NetMetrics> vec_net_metrics;
+			NetMetricsRegistry::GetSnapshot( vec_net_metrics );
+
+			Json::Value json_metrics_data;
+			json_metrics_data["rtm_func"] = 900002;
+			json_metrics_data["metrics_time"] = now_time;
+			json_metrics_data["net_metrics"] = Json::Value( Json::arrayValue );
+			for( size_t i = 0; i < vec_net_metrics.size(); i++ ) {
+				NetMetrics& net_metrics = vec_net_metrics[i];
+				Json::Value json_net_metrics;
+				json_net_metrics["source_id"] = net_metrics.m_source_id;
+				json_net_metrics["role"] = METRICS_ROLE_SERVER == net_metrics.m_role ? "server" : "client";
+				json_net_metrics["connect_count"] = (Json::UInt64)net_metrics.m_connect_count;
+				json_net_metrics["recv_bytes"] = (Json::UInt64)net_metrics.m_recv_bytes;
+				json_net_metrics["recv_msgs"] = (Json::UInt64)net_metrics.m_recv_msgs;
+				json_net_metrics["send_bytes"] = (Json::UInt64)net_metrics.m_send_bytes;
+				json_net_metrics["send_msgs"] = (Json::UInt64)net_metrics.m_send_msgs;
+				json_net_metrics["send_queue"] = (Json::UInt64)net_metrics.m_send_queue;
+				json_net_metrics["drop_msgs"] = (Json::UInt64)net_metrics.m_drop_msgs;
+				json_net_metrics["conflate_msgs"] = (Json::UInt64)net_metrics.m_conflate_msgs;
+				json_net_metrics["reconnect_attempt"] = (Json::UInt64)net_metrics.m_reconnect_attempt;
+				json_net_metrics["reconnect_success"] = (Json::UInt64)net_metrics.m_reconnect_success;
+				json_net_metrics["reconnect_failure"] = (Json::UInt64)net_metrics.m_reconnect_failure;
+				json_net_metrics["latency_p50"] = (Json::Int64)NetMetricsRegistry::GetLatencyQuantile( net_metrics.m_latency_histogram, 0.5 ); // 微秒
+				json_net_metrics["latency_p99"] = (Json::Int64)NetMetricsRegistry::GetLatencyQuantile( net_metrics.m_latency_histogram, 0.99 );
+				json_net_metrics["latency_p999"] = (Json::Int64)NetMetricsRegistry::GetLatencyQuantile( net_metrics.m_latency_histogram, 0.999 );
+				json_net_metrics["connects"] = Json::Value( Json::arrayValue );
+				for( size_t j = 0; j < net_metrics.m_vec_connect.size(); j++ ) {
+					NetConnectMetrics& connect_metrics = net_metrics.m_vec_connect[j];
+					Json::Value json_connect_metrics;
+					json_connect_metrics["identity"] = connect_metrics.m_identity;
+					json_connect_metrics["node_type"] = connect_metrics.m_node_type;
+					json_connect_metrics["endpoint_l"] = connect_metrics.m_endpoint_l;
+					json_connect_metrics["endpoint_r"] = connect_metrics.m_endpoint_r;
+					json_connect_metrics["recv_bytes"] = (Json::UInt64)connect_metrics.m_recv_bytes;
+					json_connect_metrics["recv_msgs"] = (Json::UInt64)connect_metrics.m_recv_msgs;
+					json_connect_metrics["send_bytes"] = (Json::UInt64)connect_metrics.m_send_bytes;
+					json_connect_metrics["send_msgs"] = (Json::UInt64)connect_metrics.m_send_msgs;
+					json_connect_metrics["send_queue"] = (Json::UInt64)connect_metrics.m_send_queue;
+					json_connect_metrics["drop_msgs"] = (Json::UInt64)connect_metrics.m_drop_msgs;
+					json_connect_metrics["conflate_msgs"] = (Json::UInt64)connect_metrics.m_conflate_msgs;
+					json_net_metrics["connects"].append( json_connect_metrics );
+				}
+				json_metrics_data["net_metrics"].append( json_net_metrics );
+			}
+			Json::StreamWriterBuilder json_writer;
+			std::string metrics_data = Json::writeString( json_writer, json_metrics_data );
+
+			m_net_server_broad->Server_SendDataAll( NW_MSG_TYPE_USER_DATA, NW_MSG_CODE_JSON, metrics_data );
+		}
 	}
 
 	void SysRtm_P::LogTrans( syslog_level log_level, std::string& log_cate, std::string& log_info ) {
@@ -109,6 +205,10 @@ namespace basicx {
 		m_sysrtm_p->StartNetServer();
 	}
 
+	void SysRtm_S::SetMetricsInterval( int32_t metrics_interval ) {
+		m_sysrtm_p->SetMetricsInterval( metrics_interval );
+	}
+
 	void SysRtm_S::LogTrans( syslog_level log_level, std::string& log_cate, std::string& log_info ) {
 		m_sysrtm_p->LogTrans( log_level, log_cate, log_info );
 	}
@@ -28,6 +28,8 @@
 
 namespace basicx {
 
+	#define RTM_METRICS_INTERVAL 5000 // 룬ͳƿչ㲥
+
 	class SysRtm_P;
 
 	class BASICX_SYSRTM_EXPIMP SysRtm_S
@@ -41,6 +43,7 @@ namespace basicx {
 
 	public:
 		void StartNetServer();
+		void SetMetricsInterval( int32_t metrics_interval ); // 룬0 Ϊ㲥ͳƣ StartNetServer() ǰ
 		// 0(debug)1Ϣ(info)2ʾ(hint)3(warn)4(error)5(fatal)
 		void LogTrans( syslog_level log_level, std::string& log_cate, std::string& log_info );
 
@@ -22,6 +22,7 @@
 #ifndef BASICX_SYSRTM_SYSRTM_P_H
 #define BASICX_SYSRTM_SYSRTM_P_H
 
+#include <atomic>
 #include <thread>
 
 #include <network/server.h>
@@ -43,6 +44,9 @@ namespace basicx {
 		void OnNetServerData( NetServerData& net_server_data );
 
 		void StartNetServer();
+		void SetMetricsInterval( int32_t metrics_interval );
+		void Thread_Metrics();
+		void BroadcastMetrics();
 		// 0(debug)1Ϣ(info)2ʾ(hint)3(warn)4(error)5(fatal)
 		void LogTrans( syslog_level log_level, std::string& log_cate, std::string& log_info );
 
@@ -50,6 +54,10 @@ namespace basicx {
 		NetServerPtr m_net_server_broad;
 
 	private:
+		int32_t m_metrics_interval;
+		std::thread m_metrics_thread;
+		std::atomic<bool> m_metrics_running;
+
 		SysCfg_S* m_syscfg;
 		SysLog_S* m_syslog;
 	};